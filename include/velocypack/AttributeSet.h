@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "velocypack/velocypack-common.h"
+
+namespace arangodb::velocypack {
+class Slice;
+
+class AttributeSet {
+  // A list of attribute names to look up in Objects via Slice::getMany().
+  // The names are copied, sorted and hashed once, so an AttributeSet
+  // should be built up front and then be used for many Objects.
+
+  friend class Slice;
+
+  // attribute names in sorted order, without duplicates
+  std::vector<std::string> _keys;
+  // hash of each name in _keys, for Objects with a hash table
+  std::vector<uint64_t> _hashes;
+  // position of each name in _keys in the original list
+  std::vector<std::size_t> _targets;
+  // position of each duplicate name in the original list, and the
+  // position of its first occurrence
+  std::vector<std::pair<std::size_t, std::size_t>> _duplicates;
+
+ public:
+  AttributeSet(std::string_view const* keys, std::size_t count);
+
+  AttributeSet(std::initializer_list<std::string_view> keys)
+      : AttributeSet(keys.begin(), keys.size()) {}
+
+  explicit AttributeSet(std::vector<std::string_view> const& keys)
+      : AttributeSet(keys.data(), keys.size()) {}
+
+  template<typename T>
+  explicit AttributeSet(std::vector<T> const& keys)
+      : AttributeSet(std::vector<std::string_view>(keys.begin(), keys.end())) {}
+
+  // number of attribute names, including duplicates. Slice::getMany()
+  // returns one value for each of them
+  std::size_t size() const noexcept {
+    return _keys.size() + _duplicates.size();
+  }
+
+  bool empty() const noexcept { return _keys.empty(); }
+};
+
+}  // namespace arangodb::velocypack
+
+using VPackAttributeSet = arangodb::velocypack::AttributeSet;
@@ -26,6 +26,7 @@
 
 #include <cstring>
 #include <cstdlib>
+#include <memory_resource>
 #include <new>
 #include <string>
 #include <string_view>
@@ -41,21 +42,30 @@ class Buffer {
   static_assert(sizeof(T) == 1, "expecting sizeof(T) to be 1");
 
  public:
-  Buffer() noexcept : _buffer(_local), _capacity(sizeof(_local)), _size(0) {
+  Buffer() noexcept
+      : _buffer(_local), _capacity(sizeof(_local)), _size(0), _resource(nullptr) {
     poison(_buffer, _capacity);
     initWithNone();
   }
 
+  // create a Buffer that gets its memory from the given memory resource
+  // instead of velocypack_malloc. a nullptr resource means
+  // velocypack_malloc. the resource must outlive the Buffer
+  explicit Buffer(std::pmr::memory_resource* resource) noexcept : Buffer() {
+    _resource = resource;
+  }
+
   explicit Buffer(ValueLength expectedLength) : Buffer() {
     reserve(expectedLength);
     initWithNone();
   }
 
+  // copies always use velocypack_malloc, so that they do not depend on
+  // the lifetime of the original's memory resource
   Buffer(Buffer const& that) : Buffer() {
     if (that._size > 0) {
       if (that._size > sizeof(that._local)) {
-        _buffer = static_cast<T*>(velocypack_malloc(checkOverflow(that._size)));
-        ensureValidPointer(_buffer);
+        _buffer = allocate(that._size);
         _capacity = that._size;
       } else {
         VELOCYPACK_ASSERT(_buffer == &_local[0]);
@@ -74,13 +84,12 @@ class Buffer {
         memcpy(_buffer, that._buffer, checkOverflow(that._size));
       } else {
         // our own buffer is not big enough to hold the data
-        T* buffer = static_cast<T*>(velocypack_malloc(checkOverflow(that._size)));
-        ensureValidPointer(buffer);
+        T* buffer = allocate(that._size);
         buffer[0] = '\x00';
         memcpy(buffer, that._buffer, checkOverflow(that._size));
 
         if (_buffer != _local) {
-          velocypack_free(_buffer);
+          deallocate(_buffer, _capacity);
         }
         _buffer = buffer;
         _capacity = that._size;
@@ -91,7 +100,8 @@ class Buffer {
     return *this;
   }
 
-  Buffer(Buffer&& that) noexcept : _buffer(_local), _capacity(sizeof(_local)) {
+  Buffer(Buffer&& that) noexcept
+      : _buffer(_local), _capacity(sizeof(_local)), _resource(that._resource) {
     poison(_buffer, _capacity);
     initWithNone();
     if (that._buffer == that._local) {
@@ -111,8 +121,9 @@ class Buffer {
   Buffer& operator=(Buffer&& that) noexcept {
     if (this != &that) {
       if (_buffer != _local) {
-        velocypack_free(_buffer);
+        deallocate(_buffer, _capacity);
       }
+      _resource = that._resource;
       if (that._buffer == that._local) {
         _buffer = _local;
         _capacity = sizeof(_local);
@@ -133,7 +144,7 @@ class Buffer {
 
   ~Buffer() { 
     if (_buffer != _local) {
-      velocypack_free(_buffer);
+      deallocate(_buffer, _capacity);
     }
   }
 
@@ -147,6 +158,12 @@ class Buffer {
   
   inline ValueLength capacity() const noexcept { return _capacity; }
 
+  // the memory resource the Buffer allocates from, nullptr if it uses
+  // velocypack_malloc
+  inline std::pmr::memory_resource* memoryResource() const noexcept {
+    return _resource;
+  }
+
   std::string toString() const {
     return std::string(reinterpret_cast<char const*>(_buffer), _size);
   }
@@ -185,7 +202,7 @@ class Buffer {
   void clear() noexcept {
     _size = 0;
     if (_buffer != _local) {
-      velocypack_free(_buffer);
+      deallocate(_buffer, _capacity);
       _buffer = _local;
       _capacity = sizeof(_local);
       poison(_buffer, _capacity);
@@ -194,9 +211,11 @@ class Buffer {
   }
 
   // Steal external memory; only allowed when the buffer is not local,
-  // i.e. !usesLocalMemory()
+  // i.e. !usesLocalMemory(), and does not use a memory resource. The
+  // caller must free the memory with velocypack_free
    T* steal() noexcept {
     VELOCYPACK_ASSERT(!usesLocalMemory());
+    VELOCYPACK_ASSERT(_resource == nullptr);
 
     auto buffer = _buffer;
     _buffer = _local;
@@ -277,6 +296,25 @@ class Buffer {
     }
   }
   
+  T* allocate(ValueLength len) {
+    T* p;
+    if (_resource == nullptr) {
+      p = static_cast<T*>(velocypack_malloc(checkOverflow(len)));
+      ensureValidPointer(p);
+    } else {
+      p = static_cast<T*>(_resource->allocate(checkOverflow(len), 1));
+    }
+    return p;
+  }
+
+  void deallocate(T* p, ValueLength len) noexcept {
+    if (_resource == nullptr) {
+      velocypack_free(p);
+    } else {
+      _resource->deallocate(p, static_cast<std::size_t>(len), 1);
+    }
+  }
+
   // poison buffer memory, used only for debugging
 #ifdef VELOCYPACK_DEBUG
   inline void poison(T* p, ValueLength length) noexcept {
@@ -303,15 +341,17 @@ class Buffer {
     // expect T to be 1-byte-aignable
     VELOCYPACK_ASSERT(newLen > 0);
     T* p;
-    if (_buffer != _local) {
+    if (_buffer != _local && _resource == nullptr) {
       p = static_cast<T*>(velocypack_realloc(_buffer, checkOverflow(newLen)));
       ensureValidPointer(p);
       // realloc will have copied the old data
     } else {
-      p = static_cast<T*>(velocypack_malloc(checkOverflow(newLen)));
-      ensureValidPointer(p);
+      p = allocate(newLen);
       // copy existing data into buffer
       memcpy(p, _buffer, checkOverflow(_size));
+      if (_buffer != _local) {
+        deallocate(_buffer, _capacity);
+      }
     }
     poison(p + _capacity, newLen - _capacity);
 
@@ -324,6 +364,8 @@ class Buffer {
   T* _buffer;
   ValueLength _capacity;
   ValueLength _size;
+  // memory resource to allocate from, velocypack_malloc if nullptr
+  std::pmr::memory_resource* _resource;
 
   // an already allocated space for small values
   T _local[192];
@@ -28,9 +28,11 @@
 #include <cstring>
 #include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "velocypack/velocypack-common.h"
@@ -49,9 +51,11 @@
 namespace arangodb::velocypack {
 class ArrayIterator;
 class ObjectIterator;
+class ObjectShape;
 
 class Builder {
   friend class Parser;  // The parser needs access to internals.
+  friend class StreamParser;  // The stream parser as well.
 
   // Here are the mechanics of how this building process works:
   // The whole VPack being built starts at where _start points to.
@@ -73,7 +77,10 @@ class Builder {
   // allows to build a sequence of unrelated VPack objects in the
   // buffer. Whenever the stack is empty, one can use the start,
   // size and slice methods to get out the ready built VPack
-  // object(s).
+  // object(s). An Object opened with an ObjectShape is built like an
+  // Array of its values: its keys are written from the shape by
+  // reportAdd, and close uses the shape's key order instead of
+  // sorting the index table.
 
  private:
   // Here we collect the result
@@ -88,6 +95,8 @@ class Builder {
   struct CompoundInfo {
     ValueLength startPos;
     ValueLength indexStartPos;
+    // only set for Objects opened with an ObjectShape
+    ObjectShape const* shape;
   };
 
   static constexpr std::size_t arenaSize = 64;
@@ -99,7 +108,10 @@ class Builder {
   SmallVector<CompoundInfo, arenaSize> _stack;
 
   // Indices for starts of subindex
-  std::vector<ValueLength> _indexes;
+  std::pmr::vector<ValueLength> _indexes;
+  // offsets and normalized hashes of sealed Arrays and Objects, sorted by
+  // offset. only filled if options->normalizedHashCacheThreshold is set
+  std::pmr::vector<std::pair<ValueLength, uint64_t>> _normalizedHashes;
   // indicates that in the current object the key has been written but the value not yet
   bool _keyWritten;
 
@@ -131,12 +143,21 @@ class Builder {
   // populate a Builder from a Slice
   explicit Builder(Slice slice, Options const* options = &Options::Defaults);
 
+  // create an empty Builder that allocates its Buffer and its internal
+  // index tables from the given memory resource, e.g. a
+  // std::pmr::monotonic_buffer_resource that is released in one go. the
+  // resource must outlive the Builder and its Buffer. copies of the
+  // Builder allocate from the heap again
+  Builder(std::pmr::memory_resource* resource, Options const* options);
+
   ~Builder() = default;
 
   Builder(Builder const& that);
   Builder& operator=(Builder const& that);
   Builder(Builder&& that) noexcept;
-  Builder& operator=(Builder&& that) noexcept;
+  // not noexcept: the internal index tables keep their memory resource,
+  // so moving from a Builder with another resource copies them
+  Builder& operator=(Builder&& that);
 
   // get a reference to the Builder's Buffer object
   // note: this object may be a nullptr if the buffer was already stolen
@@ -209,6 +230,7 @@ class Builder {
     _pos = 0;
     _stack.clear();
     _indexes.clear();
+    _normalizedHashes.clear();
     if (_bufferPtr != nullptr) {
       _bufferPtr->reset();
       _start = _bufferPtr->data();
@@ -283,7 +305,8 @@ class Builder {
       return false;
     }
     ValueLength const pos = _stack.back().startPos;
-    return _start[pos] == 0x06 || _start[pos] == 0x13;
+    return (_start[pos] == 0x06 || _start[pos] == 0x13) &&
+           _stack.back().shape == nullptr;
   }
 
   bool isOpenObject() const noexcept {
@@ -291,7 +314,8 @@ class Builder {
       return false;
     }
     ValueLength const pos = _stack.back().startPos;
-    return _start[pos] == 0x0b || _start[pos] == 0x14;
+    return _start[pos] == 0x0b || _start[pos] == 0x14 ||
+           _stack.back().shape != nullptr;
   }
 
   inline void openArray(bool unindexed = false) {
@@ -301,7 +325,18 @@ class Builder {
   inline void openObject(bool unindexed = false) {
     openCompoundValue(unindexed ? 0x14 : 0x0b);
   }
-  
+
+  // open an Object with the attributes of shape. exactly one value per
+  // attribute must then be added in the order of the shape's attribute
+  // names, using the methods for Array members, before calling close().
+  // the keys are written by the Builder. the shape must stay alive until
+  // the Object is closed
+  void openObject(ObjectShape const& shape);
+
+  // the Builder keeps a pointer to the shape, so a temporary one would
+  // be destroyed while the Object is still open
+  void openObject(ObjectShape&&) = delete;
+
   template <typename T>
   uint8_t* addUnchecked(std::string_view attrName, T const& sub) {
     bool needCleanup = !_stack.empty();
@@ -505,6 +540,12 @@ class Builder {
   // Seal the innermost array or object:
   Builder& close();
 
+  // return the normalized hash of a value inside this Builder's buffer.
+  // this is the same as slice.normalizedHash(), but is an O(log n)
+  // lookup for Arrays and Objects cached at close() because of
+  // options->normalizedHashCacheThreshold
+  uint64_t normalizedHash(Slice slice) const;
+
   // whether or not a specific key is present in an Object value
   bool hasKey(std::string_view key) const;
 
@@ -557,16 +598,16 @@ class Builder {
   void closeLevel() noexcept;
 
   void sortObjectIndexShort(uint8_t* objBase,
-                            std::vector<ValueLength>::iterator indexStart,
-                            std::vector<ValueLength>::iterator indexEnd) const;
+                            std::pmr::vector<ValueLength>::iterator indexStart,
+                            std::pmr::vector<ValueLength>::iterator indexEnd) const;
 
   void sortObjectIndexLong(uint8_t* objBase,
-                           std::vector<ValueLength>::iterator indexStart,
-                           std::vector<ValueLength>::iterator indexEnd) const;
+                           std::pmr::vector<ValueLength>::iterator indexStart,
+                           std::pmr::vector<ValueLength>::iterator indexEnd) const;
 
   void sortObjectIndex(uint8_t* objBase,
-                       std::vector<ValueLength>::iterator indexStart,
-                       std::vector<ValueLength>::iterator indexEnd) {
+                       std::pmr::vector<ValueLength>::iterator indexStart,
+                       std::pmr::vector<ValueLength>::iterator indexEnd) {
     std::size_t const n = std::distance(indexStart, indexEnd);
 
     if (n > 32) {
@@ -581,13 +622,18 @@ class Builder {
 
   // close for the compact case:
   bool closeCompactArrayOrObject(ValueLength pos, bool isArray,
-                                 std::vector<ValueLength>::iterator indexStart,
-                                 std::vector<ValueLength>::iterator indexEnd);
+                                 std::pmr::vector<ValueLength>::iterator indexStart,
+                                 std::pmr::vector<ValueLength>::iterator indexEnd);
+
+  // close for the hash-indexed Object case:
+  bool closeHashIndexedObject(ValueLength pos,
+                              std::pmr::vector<ValueLength>::iterator indexStart,
+                              std::pmr::vector<ValueLength>::iterator indexEnd);
 
   // close for the array case:
   Builder& closeArray(ValueLength pos,
-                      std::vector<ValueLength>::iterator indexStart,
-                      std::vector<ValueLength>::iterator indexEnd);
+                      std::pmr::vector<ValueLength>::iterator indexStart,
+                      std::pmr::vector<ValueLength>::iterator indexEnd);
 
   void addNull() {
     appendByte(0x18);
@@ -864,7 +910,7 @@ class Builder {
   void addCompoundValue(uint8_t type) {
     reserve(9);
     // an Array or Object is started:
-    _stack.push_back(CompoundInfo{_pos, _indexes.size()});
+    _stack.push_back(CompoundInfo{_pos, _indexes.size(), nullptr});
     appendByteUnchecked(type);
     std::memset(_start + _pos, 0, 8);
     advance(8);  // Will be filled later with bytelength and nr subs
@@ -908,6 +954,8 @@ class Builder {
 
   void reportAdd();
 
+  void reportAddShaped();
+
   template <uint64_t n>
   void appendLengthUnchecked(ValueLength v) {
     for (uint64_t i = 0; i < n; ++i) {
@@ -976,6 +1024,7 @@ class Builder {
 
   inline void resetTo(std::size_t value) {
     _pos = value;
+    trimNormalizedHashes();
     VELOCYPACK_ASSERT(_bufferPtr != nullptr);
     _bufferPtr->resetTo(value);
   }
@@ -990,10 +1039,22 @@ class Builder {
   // move byte position x bytes back
   inline void rollback(std::size_t value) noexcept {
     _pos -= value;
+    trimNormalizedHashes();
     VELOCYPACK_ASSERT(_bufferPtr != nullptr);
     _bufferPtr->rollback(value);
   }
 
+  // drop cached hashes of values that are not in the buffer anymore
+  inline void trimNormalizedHashes() noexcept {
+    while (VELOCYPACK_UNLIKELY(!_normalizedHashes.empty()) &&
+           _normalizedHashes.back().first >= _pos) {
+      _normalizedHashes.pop_back();
+    }
+  }
+
+  Builder& closeCompound();
+  void cacheNormalizedHashes(Slice slice);
+
   bool checkAttributeUniqueness(Slice obj) const;
   bool checkAttributeUniquenessSorted(Slice obj) const;
   bool checkAttributeUniquenessUnsorted(Slice obj) const;
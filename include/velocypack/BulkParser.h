@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/Buffer.h"
+#include "velocypack/Builder.h"
+#include "velocypack/Exception.h"
+#include "velocypack/Options.h"
+#include "velocypack/Slice.h"
+
+namespace arangodb::velocypack {
+
+class BulkParser {
+  // This class parses newline-delimited JSON (JSON Lines) on multiple
+  // threads. The input is split into shards at line breaks, and every
+  // shard is parsed by its own thread into its own Builder. Every line
+  // is parsed on its own, with the same semantics as
+  // Parser::parse(..., multi = true), so a line may contain several
+  // documents, but a document must not span multiple lines: a document
+  // with a raw line break in it, e.g. pretty-printed JSON, is rejected
+  // with a parse error, independent of the number of threads. Empty
+  // lines are allowed. The documents are available in input order
+  // afterwards.
+
+  struct Shard {
+    std::size_t begin;
+    std::size_t end;
+    std::shared_ptr<Builder> builder;
+    std::vector<uint8_t const*> documents;
+    std::exception_ptr error;
+    std::size_t errorPos;
+  };
+
+  std::vector<Shard> _shards;
+  // start of every document, in input order
+  std::vector<uint8_t const*> _documents;
+  std::size_t _concurrency;
+  std::size_t _errorPos;
+
+ public:
+  // minimum size of a shard in bytes. smaller inputs are parsed by
+  // fewer threads
+  static constexpr std::size_t minShardSize = 256 * 1024;
+
+  Options const* options;
+
+  BulkParser(BulkParser const&) = delete;
+  BulkParser& operator=(BulkParser const&) = delete;
+  ~BulkParser() = default;
+
+  // concurrency is the maximum number of threads used for parsing, 0
+  // means the number of hardware threads
+  explicit BulkParser(Options const* options = &Options::Defaults,
+                      std::size_t concurrency = 0);
+
+  // parses the input and returns the number of documents. if any of the
+  // documents is invalid, the error of the first invalid document in the
+  // input is thrown
+  ValueLength parse(uint8_t const* start, std::size_t size);
+
+  ValueLength parse(char const* start, std::size_t size) {
+    return parse(reinterpret_cast<uint8_t const*>(start), size);
+  }
+
+  ValueLength parse(std::string_view json) {
+    return parse(reinterpret_cast<uint8_t const*>(json.data()), json.size());
+  }
+
+  // number of documents parsed
+  ValueLength size() const noexcept { return _documents.size(); }
+
+  // returns the document with the given index. the Slice is valid until
+  // the next call to parse() or clear()
+  Slice at(ValueLength index) const {
+    if (index >= _documents.size()) {
+      throw Exception(Exception::IndexOutOfBounds);
+    }
+    return Slice(_documents[index]);
+  }
+
+  Slice operator[](ValueLength index) const { return at(index); }
+
+  // returns the start of all documents in input order
+  std::vector<uint8_t const*> const& documents() const noexcept {
+    return _documents;
+  }
+
+  // copies all documents into one buffer, back to back in input order,
+  // and stores the offset of every document in this buffer in offsets.
+  // returns the total size of the documents
+  ValueLength concatenate(Buffer<uint8_t>& buffer,
+                          std::vector<ValueLength>& offsets) const;
+
+  // number of shards the last input was split into
+  std::size_t shards() const noexcept { return _shards.size(); }
+
+  // Returns the position at the time when the just reported error
+  // occurred, only use when handling an exception.
+  std::size_t errorPos() const noexcept { return _errorPos; }
+
+  void clear();
+
+ private:
+  void split(uint8_t const* start, std::size_t size);
+
+  void parseShard(uint8_t const* start, Shard& shard);
+};
+
+}  // namespace arangodb::velocypack
+
+using VPackBulkParser = arangodb::velocypack::BulkParser;
@@ -41,6 +41,17 @@ class Collection {
  public:
   enum VisitationOrder { PreOrder = 1, PostOrder = 2 };
 
+  // how unique(), intersect(), unionOf() and difference() find equal values
+  enum SetMode {
+    // hash table, values are equal if Slice::binaryEquals() says so
+    BinaryHashing = 1,
+    // hash table, values are equal if NormalizedCompare::equals() says so
+    NormalizedHashing = 2,
+    // merge of Arrays that are sorted in NormalizedCompare::compare() order,
+    // e.g. by Collection::sort(). values are equal if compare() returns 0
+    SortedMerge = 3
+  };
+
   // indicator for "element not found" in indexOf() method
   static ValueLength const NotFound;
 
@@ -214,9 +225,37 @@ class Collection {
     visitRecursive(*slice, order, func);
   }
 
+  // sorts the members of an Array with the comparator. with a concurrency
+  // other than 1, large Arrays are sorted on multiple threads, so the
+  // comparator must be safe to call concurrently. 0 means one thread per
+  // CPU core
   static Builder sort(
       Slice const& array,
-      std::function<bool (Slice const&, Slice const&)> lessthan);
+      std::function<bool (Slice const&, Slice const&)> lessthan,
+      std::size_t concurrency = 1);
+
+  // sorts the members of an Array in NormalizedCompare::compare() order.
+  // Arrays of only integers, only doubles or only strings are radix sorted
+  static Builder sort(Slice const& array, std::size_t concurrency = 1);
+
+  // set operations on Arrays. each returns an Array without duplicates.
+  // with hashing, values keep the order of their first occurrence in
+  // left, then in right. with SortedMerge, the result is sorted as well
+
+  // returns the distinct members of an Array
+  static Builder unique(Slice const& array, SetMode mode = NormalizedHashing);
+
+  // returns the members of left that are also in right
+  static Builder intersect(Slice const& left, Slice const& right,
+                           SetMode mode = NormalizedHashing);
+
+  // returns the members of left and the members of right
+  static Builder unionOf(Slice const& left, Slice const& right,
+                         SetMode mode = NormalizedHashing);
+
+  // returns the members of left that are not in right
+  static Builder difference(Slice const& left, Slice const& right,
+                            SetMode mode = NormalizedHashing);
 };
 
 struct IsEqualPredicate {
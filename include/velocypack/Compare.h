@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "velocypack/velocypack-common.h"
 
 namespace arangodb::velocypack {
@@ -60,9 +62,30 @@ struct NormalizedCompare {
   // function to compare two string values
   static bool equalsStrings(Slice lhs, Slice rhs);
 
+  // function to compare two Object values
+  static bool equalsObjects(Slice lhs, Slice rhs);
+
   // function to compare two arbitrary Slices
   static bool equals(Slice lhs, Slice rhs);
 
+  // three-way comparison of two arbitrary Slices. returns a negative
+  // value if lhs sorts before rhs, 0 if both are equal and a positive
+  // value if lhs sorts after rhs. values of different types are ordered
+  // MinKey < None < Illegal < Null < Bool < number < UTCDate < String <
+  // Binary < Array < Object < MaxKey. numbers of all types are ordered by
+  // their exact values, with NaN first. Strings and Binary values are
+  // compared bytewise, Arrays element by element, and Objects member by
+  // member in attribute name order, comparing the names first and then
+  // the values. tags are ignored
+  static int compare(Slice lhs, Slice rhs);
+
+  // appends a byte string to out that sorts the same way with memcmp()
+  // as the Slice does with compare(). the encoding is stable, so the
+  // byte strings can be persisted
+  static void appendSortKey(Slice slice, std::string& out);
+
+  static std::string sortKey(Slice slice);
+
   struct Hash {
     size_t operator()(arangodb::velocypack::Slice const&) const;
   };
@@ -78,6 +101,12 @@ struct NormalizedCompare {
                     arangodb::velocypack::Slice const&) const;
   };
 
+  // less-than comparator using compare(), e.g. for Collection::sort
+  struct Less {
+    bool operator()(arangodb::velocypack::Slice const&,
+                    arangodb::velocypack::Slice const&) const;
+  };
+
 };
   
 } // namespace arangodb::velocypack
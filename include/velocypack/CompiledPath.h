@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/Slice.h"
+
+namespace arangodb::velocypack {
+
+class CompiledPath {
+  // An attribute path like a.b.c that is prepared once and then looked up
+  // in many Objects. Each attribute name is hashed and translated with
+  // the AttributeTranslator up front. In addition, each step remembers
+  // the position in the index table at which it found its attribute the
+  // last time, and checks this position first in the next Object, so that
+  // Objects of the same shape need a single key comparison per step.
+  // Looking up a CompiledPath from multiple threads at the same time is
+  // safe.
+
+  struct Step {
+    explicit Step(std::string_view name);
+    Step(Step const& other);
+
+    std::string name;
+    // head byte of the name as a VelocyPack String: 0x40 + length for
+    // short names, 0xbf for long ones
+    uint8_t head;
+    // hash for Objects with hash table
+    uint64_t hash;
+    // translated attribute name, if the AttributeTranslator knows the name
+    uint64_t id;
+    bool translated;
+    // index table position of the last match
+    mutable std::atomic<ValueLength> guess;
+  };
+
+  std::vector<Step> _steps;
+
+ public:
+  explicit CompiledPath(std::vector<std::string_view> const& path);
+
+  explicit CompiledPath(std::initializer_list<std::string_view> path)
+      : CompiledPath(std::vector<std::string_view>(path)) {}
+
+  template<typename T>
+  explicit CompiledPath(std::vector<T> const& path)
+      : CompiledPath(std::vector<std::string_view>(path.begin(), path.end())) {}
+
+  // number of attributes in the path
+  std::size_t size() const noexcept { return _steps.size(); }
+
+  // the attribute name at the given position in the path
+  std::string_view operator[](std::size_t index) const {
+    return _steps.at(index).name;
+  }
+
+  // look for the path inside an Object
+  // returns a Slice(ValueType::None) if not found
+  Slice get(Slice slice, bool resolveExternals = false) const;
+
+ private:
+  Slice lookup(Slice slice, Step const& step) const;
+};
+
+}  // namespace arangodb::velocypack
+
+using VPackCompiledPath = arangodb::velocypack::CompiledPath;
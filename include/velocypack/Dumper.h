@@ -25,44 +25,54 @@
 #pragma once
 
 #include <string>
+#include <type_traits>
 
 #include "velocypack/velocypack-common.h"
+#include "velocypack/FileDescriptorSink.h"
 #include "velocypack/Options.h"
+#include "velocypack/Sink.h"
 #include "velocypack/Slice.h"
 
 namespace arangodb::velocypack {
-struct Sink;
 
-// Dumps VPack into a JSON output string
-class Dumper {
+// Dumps VPack into a JSON output sink of type SinkType. Output to the
+// polymorphic Sink costs a virtual call for every piece of output, while
+// with a concrete sink type all sink calls are resolved at compile time
+// and inlined. The implementation is instantiated for Sink, StringSink,
+// CharBufferSink, StringLengthSink, BufferedSink and FileDescriptorSink
+// only. Dumping into a StringLengthSink computes the exact length of the
+// JSON without producing it
+template <typename SinkType>
+class BasicDumper {
+  static_assert(std::is_base_of<Sink, SinkType>::value,
+                "SinkType must be derived from Sink");
+
+  template <typename>
+  friend class BasicDumper;
+
  public:
   Options const* options;
 
-  Dumper(Dumper const&) = delete;
-  Dumper& operator=(Dumper const&) = delete;
+  BasicDumper(BasicDumper const&) = delete;
+  BasicDumper& operator=(BasicDumper const&) = delete;
 
-  explicit Dumper(Sink* sink, Options const* options = &Options::Defaults);
+  explicit BasicDumper(SinkType* sink,
+                       Options const* options = &Options::Defaults);
 
-  ~Dumper() = default;
+  ~BasicDumper() = default;
 
-  Sink* sink() const { return _sink; }
+  SinkType* sink() const { return _sink; }
 
   void dump(Slice const& slice);
 
   void dump(Slice const* slice) { dump(*slice); }
 
-  static void dump(Slice const& slice, Sink* sink,
+  static void dump(Slice const& slice, SinkType* sink,
                    Options const* options = &Options::Defaults);
 
-  static void dump(Slice const* slice, Sink* sink,
+  static void dump(Slice const* slice, SinkType* sink,
                    Options const* options = &Options::Defaults);
 
-  static std::string toString(Slice const& slice,
-                              Options const* options = &Options::Defaults);
-
-  static std::string toString(Slice const* slice,
-                              Options const* options = &Options::Defaults);
-
   void append(Slice const& slice) { dumpValue(&slice); }
 
   void append(Slice const* slice) { dumpValue(slice); }
@@ -84,7 +94,9 @@ class Dumper {
 
   void dumpInteger(Slice const*);
 
-  void dumpString(char const*, ValueLength);
+  // fromSlice tells whether the string is part of the dumped VPack value,
+  // as opposed to e.g. a temporary passed to appendString()
+  void dumpString(char const*, ValueLength, bool fromSlice = false);
 
   inline void dumpValue(Slice const& slice, Slice const* base = nullptr) {
     dumpValue(&slice, base);
@@ -92,16 +104,52 @@ class Dumper {
 
   void dumpValue(Slice const*, Slice const* = nullptr);
 
+  void dumpCustom(Slice const*, Slice const*);
+
   void indent();
 
   void handleUnsupportedType(Slice const* slice);
 
  private:
-  Sink* _sink;
+  SinkType* _sink;
 
   int _indentation;
 };
 
+extern template class BasicDumper<Sink>;
+extern template class BasicDumper<StringSink>;
+extern template class BasicDumper<CharBufferSink>;
+extern template class BasicDumper<StringLengthSink>;
+extern template class BasicDumper<BufferedSink>;
+extern template class BasicDumper<FileDescriptorSink>;
+
+// Dumps VPack into a JSON output string, via the polymorphic Sink
+class Dumper final : public BasicDumper<Sink> {
+ public:
+  using BasicDumper<Sink>::BasicDumper;
+
+  // returns the exact number of characters the JSON for slice has
+  static ValueLength dumpLength(Slice const& slice,
+                                Options const* options = &Options::Defaults);
+
+  // values of at least this many bytes are dumped by dumpAppend() in two
+  // passes
+  static constexpr ValueLength exactReservationThreshold = 16 * 1024 * 1024;
+
+  // appends the JSON for slice to out. for values of at least
+  // exactReservationThreshold bytes, the exact length is computed first,
+  // so that out is grown only once. this takes more time, but avoids
+  // copying the output and needs half the peak memory
+  static std::string& dumpAppend(std::string& out, Slice const& slice,
+                                 Options const* options = &Options::Defaults);
+
+  static std::string toString(Slice const& slice,
+                              Options const* options = &Options::Defaults);
+
+  static std::string toString(Slice const* slice,
+                              Options const* options = &Options::Defaults);
+};
+
 }  // namespace arangodb::velocypack
 
 using VPackDumper = arangodb::velocypack::Dumper;
@@ -66,9 +66,13 @@ class Exception : public virtual std::exception {
     BuilderCustomDisallowed = 40,
     BuilderTagsDisallowed = 41,
     BuilderBCDDisallowed = 42,
+    BuilderShapeMismatch = 43,
 
     ValidatorInvalidLength = 50,
     ValidatorInvalidType = 51,
+    ValidatorNestingTooDeep = 52,
+
+    FileError = 60,
 
     UnknownError = 999
   };
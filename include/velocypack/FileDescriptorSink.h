@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/Sink.h"
+
+namespace arangodb::velocypack {
+
+struct FileDescriptorSinkOptions {
+  // size of each buffer in bytes. rounded up to a multiple of the page size
+  std::size_t bufferSize = 64 * 1024;
+
+  // number of buffers in the ring, at least 2
+  std::size_t maxBuffers = 4;
+
+  // when all buffers are filled and the file descriptor does not accept
+  // more data right now (i.e. it is non-blocking and the write would
+  // block), wait until it becomes writable. this limits the memory used
+  // to maxBuffers buffers, but blocks the producer. otherwise, further
+  // buffers are allocated as needed
+  bool backpressure = true;
+
+  // strings of at least this many bytes that the Dumper takes from a
+  // Slice are written from the Slice's memory instead of being copied
+  // into a buffer. the Slice's memory must then stay valid until the
+  // next flush(). 0 turns this off
+  std::size_t zeroCopyThreshold = 0;
+};
+
+class FileDescriptorSink final : public Sink {
+  // This sink writes to a POSIX file descriptor, e.g. of a file, pipe or
+  // socket. Output is collected in a ring of page-aligned buffers, and
+  // all filled buffers are written with a single writev() call. Buffers
+  // are allocated on demand. The file descriptor is not closed by the
+  // sink. Buffered output is written by flush() and by the destructor,
+  // but errors are only reported by flush(), so it should be called
+  // explicitly when the output is complete. As with write(), writing to
+  // a pipe or socket whose reading end is closed raises SIGPIPE unless
+  // that signal is ignored.
+
+  // a piece of output waiting to be written, either part of a buffer or
+  // memory referenced via appendReference()
+  struct Segment {
+    char const* data;
+    std::size_t length;
+    // buffer to recycle once this segment has been written. only set on
+    // the last segment of each buffer
+    char* buffer;
+  };
+
+ public:
+  FileDescriptorSink(FileDescriptorSink const&) = delete;
+  FileDescriptorSink& operator=(FileDescriptorSink const&) = delete;
+
+  // throws an Exception of type FileError if fd is negative
+  explicit FileDescriptorSink(
+      int fd, FileDescriptorSinkOptions const& options = FileDescriptorSinkOptions());
+
+  ~FileDescriptorSink();
+
+  void push_back(char c) override final {
+    if (VELOCYPACK_UNLIKELY(_used == _bufferSize)) {
+      nextBuffer();
+    }
+    _current[_used++] = c;
+  }
+
+  void append(std::string const& p) override final {
+    append(p.data(), p.size());
+  }
+
+  void append(char const* p) override final { append(p, strlen(p)); }
+
+  void append(char const* p, ValueLength len) override final {
+    if (VELOCYPACK_LIKELY(len <= _bufferSize - _used)) {
+      memcpy(_current + _used, p, checkOverflow(len));
+      _used += static_cast<std::size_t>(len);
+      return;
+    }
+    appendSlow(p, checkOverflow(len));
+  }
+
+  void reserve(ValueLength) override final {}
+
+  // appends len bytes at p, which stay valid until the next flush().
+  // chunks of at least zeroCopyThreshold bytes are written directly from
+  // p instead of being copied
+  void appendReference(char const* p, ValueLength len) {
+    if (_zeroCopyThreshold == 0 || len < _zeroCopyThreshold) {
+      append(p, len);
+      return;
+    }
+    enqueueCurrent(nullptr);
+    _pending.push_back(Segment{p, checkOverflow(len), nullptr});
+  }
+
+  // writes all buffered output, waiting for the file descriptor to become
+  // writable if necessary. throws an Exception of type FileError if
+  // writing fails
+  void flush();
+
+  // number of bytes written to the file descriptor so far
+  ValueLength written() const noexcept { return _written; }
+
+  // file descriptor written to
+  int fd() const noexcept { return _fd; }
+
+ private:
+  // moves the part of the current buffer that has not been queued yet
+  // to the queue of pending segments
+  void enqueueCurrent(char* release) {
+    if (_used > _start || release != nullptr) {
+      _pending.push_back(Segment{_current + _start, _used - _start, release});
+    }
+    _start = _used;
+  }
+
+  void appendSlow(char const* p, std::size_t len);
+
+  // queues the current buffer and makes another one current
+  void nextBuffer();
+
+  // writes pending segments. if wait is true, waits for the file
+  // descriptor to become writable if it would block, otherwise returns
+  // as soon as it would block
+  void writePending(bool wait);
+
+  char* allocateBuffer();
+
+  int const _fd;
+  std::size_t const _bufferSize;
+  std::size_t const _maxBuffers;
+  bool const _backpressure;
+  std::size_t const _zeroCopyThreshold;
+
+  // buffer currently being filled, with _used bytes in it, of which the
+  // ones from _start on have not been queued yet
+  char* _current;
+  std::size_t _used;
+  std::size_t _start;
+
+  std::deque<Segment> _pending;
+  // buffers that can be reused
+  std::vector<char*> _free;
+  // number of buffers allocated
+  std::size_t _allocated;
+  ValueLength _written;
+};
+
+}  // namespace arangodb::velocypack
+
+using VPackFileDescriptorSink = arangodb::velocypack::FileDescriptorSink;
+using VPackFileDescriptorSinkOptions =
+    arangodb::velocypack::FileDescriptorSinkOptions;
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/Options.h"
+#include "velocypack/SharedSlice.h"
+#include "velocypack/Slice.h"
+
+namespace arangodb::velocypack {
+
+class MappedFile {
+  // This class maps a file with one or many concatenated VelocyPack
+  // values into memory read-only, and hands out SharedSlices that point
+  // directly into the mapping. The mapping is released when the
+  // MappedFile and all SharedSlices obtained from it are gone.
+  // Values are validated with the Validator when they are accessed for
+  // the first time, so opening a file does not depend on its size.
+  // Options::maxValidationDepth is ignored, values of any depth are
+  // accepted. validate() checks all values up front. The file must not
+  // be changed while it is mapped. Files that cannot be mapped, e.g.
+  // pipes, are read into memory instead.
+
+  std::shared_ptr<uint8_t const> _data;
+  std::size_t _size;
+  // start of every value validated so far
+  std::vector<std::size_t> _offsets;
+  // number of bytes validated so far. only modified with _mutex held,
+  // but read without it by isValidated()
+  std::atomic<std::size_t> _validated;
+  mutable std::mutex _mutex;
+
+ public:
+  Options const* options;
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+  ~MappedFile() = default;
+
+  // maps the file, or reads it if it is not a regular file. throws an
+  // Exception of type FileError if the file cannot be opened, mapped or
+  // read
+  explicit MappedFile(std::string const& path,
+                      Options const* options = &Options::Defaults);
+
+  // start of the mapping, nullptr for an empty file
+  uint8_t const* data() const noexcept { return _data.get(); }
+
+  // size of the file in bytes
+  std::size_t size() const noexcept { return _size; }
+
+  // shares ownership of the mapping
+  std::shared_ptr<uint8_t const> const& buffer() const noexcept {
+    return _data;
+  }
+
+  // validates all values in the file that have not been validated yet.
+  // throws if any of them is invalid
+  void validate();
+
+  // whether all values have been validated
+  bool isValidated() const noexcept;
+
+  // number of values in the file. validates all values
+  ValueLength length();
+
+  // returns the value with the given index, validating all values up to
+  // it. the SharedSlice keeps the mapping alive
+  SharedSlice at(ValueLength index);
+
+  SharedSlice operator[](ValueLength index) { return at(index); }
+
+  // returns the value with the given index as a Slice, which is only
+  // valid as long as the MappedFile or a SharedSlice of it is alive
+  Slice sliceAt(ValueLength index) { return at(index).slice(); }
+
+ private:
+  // validates values until there are more than index of them or the
+  // end of the file is reached. must be called with _mutex held
+  void validateUpTo(ValueLength index);
+};
+
+}  // namespace arangodb::velocypack
+
+using VPackMappedFile = arangodb::velocypack::MappedFile;
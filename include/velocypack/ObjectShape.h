@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/Options.h"
+
+namespace arangodb::velocypack {
+
+class ObjectShape {
+  // The attribute names of Objects that are built many times with the same
+  // attributes, e.g. log events. The names are encoded (and translated with
+  // the AttributeTranslator) and sorted once. A Builder then fills an
+  // Object of this shape via Builder::openObject(ObjectShape const&) by
+  // adding the values only, and does not need to sort the index table
+  // when the Object is closed. An ObjectShape must stay alive until every
+  // Object that is built with it is closed, as Builder::close() still
+  // reads it, and can only be used by Builders with the same
+  // AttributeTranslator. Closed Objects do not refer to it anymore.
+
+  friend class Builder;
+
+  // attribute names in the original order
+  std::vector<std::string> _names;
+  // VelocyPack encoding of all names in the original order, back to back
+  std::vector<uint8_t> _keys;
+  // start of each name's encoding in _keys, plus the end of the last one
+  std::vector<ValueLength> _keyOffsets;
+  // positions of the names in sorted order
+  std::vector<ValueLength> _order;
+  // translator the keys were encoded with, if any
+  AttributeTranslator const* _translator;
+
+ public:
+  explicit ObjectShape(std::string_view const* keys, std::size_t count,
+                       Options const* options = &Options::Defaults);
+
+  explicit ObjectShape(std::initializer_list<std::string_view> keys,
+                       Options const* options = &Options::Defaults)
+      : ObjectShape(keys.begin(), keys.size(), options) {}
+
+  explicit ObjectShape(std::vector<std::string_view> const& keys,
+                       Options const* options = &Options::Defaults)
+      : ObjectShape(keys.data(), keys.size(), options) {}
+
+  template<typename T>
+  explicit ObjectShape(std::vector<T> const& keys,
+                       Options const* options = &Options::Defaults)
+      : ObjectShape(std::vector<std::string_view>(keys.begin(), keys.end()),
+                    options) {}
+
+  // number of attributes
+  std::size_t size() const noexcept { return _names.size(); }
+
+  // the attribute translator the names were encoded with. only Builders
+  // with the same translator can use the shape
+  AttributeTranslator const* attributeTranslator() const noexcept {
+    return _translator;
+  }
+
+  // the attribute name at the given position
+  std::string_view operator[](std::size_t index) const {
+    return _names.at(index);
+  }
+
+ private:
+  // encoded key of the attribute at the given position
+  uint8_t const* key(std::size_t index, ValueLength& length) const noexcept {
+    length = _keyOffsets[index + 1] - _keyOffsets[index];
+    return _keys.data() + _keyOffsets[index];
+  }
+};
+
+}  // namespace arangodb::velocypack
+
+using VPackObjectShape = arangodb::velocypack::ObjectShape;
@@ -88,6 +88,23 @@ struct Options {
   // allow building Objects without index table?
   bool buildUnindexedObjects = false;
 
+  // build Objects with at least this many members with an additional hash
+  // table over the attribute names (type 0x15), so that Slice::get() finds
+  // attributes in constant time. 0 turns this off. Objects with integer
+  // keys are always built without hash table. Note that older versions of
+  // this library do not know type 0x15 and will reject such Objects
+  ValueLength buildHashIndexedObjectsThreshold = 0;
+
+  // when the outermost Array or Object is closed, Builder computes the
+  // normalized hash of it and of all Arrays and Objects inside it that
+  // have at least this many bytes, so that Builder::normalizedHash()
+  // can return them without walking the values again. 0 turns this off.
+  // the hash of a member depends on the hash state of its parent, so
+  // each cached value is hashed on its own, and closing costs
+  // O(size * depth) instead of O(size). cached hashes are found with a
+  // binary search over their offsets, i.e. in O(log n) for n of them
+  ValueLength normalizedHashCacheThreshold = 0;
+
   // pretty-print JSON output when dumping with Dumper
   bool prettyPrint = false;
 
@@ -103,6 +120,12 @@ struct Options {
   // validate UTF-8 strings when JSON-parsing with Parser
   bool validateUtf8Strings = false;
 
+  // JSON-parse with Parser in two stages: first build an index of all
+  // structural characters in the input (using SIMD instructions if
+  // available), then build the result from that index. produces the
+  // same results as the regular one-stage parsing
+  bool useStructuralIndex = false;
+
   // validate that attribute names in Object values are actually
   // unique when creating objects via Builder. This also includes
   // creation of Object values via a Parser
@@ -123,6 +146,12 @@ struct Options {
   // dump NaN as "NaN", Infinity as "Infinity"
   bool unsupportedDoublesAsString = false;
 
+  // maximum number of significant digits when dumping doubles with Dumper.
+  // doubles that need more digits to be read back exactly are rounded to
+  // this many digits. 0 (or any value >= 17) dumps the shortest
+  // representation that is read back exactly
+  uint32_t doubleSignificantDigits = 0;
+
   // dump binary values as hex-encoded strings
   bool binaryAsHex = false;
 
@@ -144,6 +173,12 @@ struct Options {
   // disallow BCD values
   bool disallowBCD = false;
 
+  // maximum nesting depth of Arrays and Objects accepted by Validator.
+  // Validator recurses into every level, so this keeps hostile input from
+  // exhausting the stack. 0 means no limit, for trusted data that may be
+  // nested more deeply
+  uint32_t maxValidationDepth = 1000;
+
   // write tags to JSON output
   bool debugTags = false;
 
@@ -26,6 +26,9 @@
 
 #include <string>
 #include <cmath>
+#include <memory>
+#include <memory_resource>
+#include <vector>
 
 #include "velocypack/velocypack-common.h"
 #include "velocypack/Builder.h"
@@ -33,45 +36,14 @@
 #include "velocypack/Options.h"
 
 namespace arangodb::velocypack {
+struct ParsedNumber;
 
 class Parser {
   // This class can parse JSON very rapidly, but only from contiguous
-  // blocks of memory. It builds the result using the Builder.
-
-  struct ParsedNumber {
-    ParsedNumber() : intValue(0), doubleValue(0.0), isInteger(true) {}
-
-    void addDigit(int i) {
-      if (isInteger) {
-        // check if adding another digit to the int will make it overflow
-        if (intValue < 1844674407370955161ULL ||
-            (intValue == 1844674407370955161ULL && (i - '0') <= 5)) {
-          // int won't overflow
-          intValue = intValue * 10 + (i - '0');
-          return;
-        }
-        // int would overflow
-        doubleValue = static_cast<double>(intValue);
-        isInteger = false;
-      }
-
-      doubleValue = doubleValue * 10.0 + (i - '0');
-      if (std::isnan(doubleValue) || !std::isfinite(doubleValue)) {
-        throw Exception(Exception::NumberOutOfRange);
-      }
-    }
-
-    double asDouble() const {
-      if (isInteger) {
-        return static_cast<double>(intValue);
-      }
-      return doubleValue;
-    }
+  // blocks of memory. It builds the result using the Builder. See
+  // StreamParser for parsing input that arrives in chunks.
 
-    uint64_t intValue;
-    double doubleValue;
-    bool isInteger;
-  };
+  friend class StreamParser;  // Adds its numbers with addNumber().
 
   std::shared_ptr<Builder> _builder;
   Builder* _builderPtr;
@@ -79,6 +51,11 @@ class Parser {
   std::size_t _size;
   std::size_t _pos;
   int _nesting;
+  // structural index, only used when options->useStructuralIndex is set
+  std::unique_ptr<uint32_t[]> _structurals;
+  std::size_t _structuralPos;
+  // number of entries in _structurals
+  std::size_t _structuralsCapacity;
 
  public:
   Options const* options;
@@ -94,6 +71,8 @@ class Parser {
         _size(0), 
         _pos(0), 
         _nesting(0), 
+        _structuralPos(0),
+        _structuralsCapacity(0),
         options(&Options::Defaults) {
     _builder = std::make_shared<Builder>();
     _builderPtr = _builder.get();
@@ -105,6 +84,8 @@ class Parser {
         _size(0), 
         _pos(0), 
         _nesting(0), 
+        _structuralPos(0),
+        _structuralsCapacity(0),
         options(options) {
     if (VELOCYPACK_UNLIKELY(options == nullptr)) {
       throw Exception(Exception::InternalError, "Options cannot be a nullptr");
@@ -122,7 +103,9 @@ class Parser {
         _size(0), 
         _pos(0), 
         _nesting(0),
-         options(options) {
+        _structuralPos(0),
+        _structuralsCapacity(0),
+        options(options) {
     if (VELOCYPACK_UNLIKELY(options == nullptr)) {
       throw Exception(Exception::InternalError, "Options cannot be a nullptr");
     }
@@ -135,7 +118,9 @@ class Parser {
         _size(0), 
         _pos(0), 
         _nesting(0),
-         options(options) {
+        _structuralPos(0),
+        _structuralsCapacity(0),
+        options(options) {
     if (VELOCYPACK_UNLIKELY(options == nullptr)) {
       throw Exception(Exception::InternalError, "Options cannot be a nullptr");
     }
@@ -143,6 +128,27 @@ class Parser {
     _builderPtr = _builder.get();
   }
 
+  // This method produces a parser whose Builder allocates all its memory
+  // from the given memory resource, which must outlive the Builder
+  Parser(std::pmr::memory_resource* resource, Options const* options)
+      : _start(nullptr),
+        _size(0),
+        _pos(0),
+        _nesting(0),
+        _structuralPos(0),
+        _structuralsCapacity(0),
+        options(options) {
+    if (VELOCYPACK_UNLIKELY(options == nullptr)) {
+      throw Exception(Exception::InternalError, "Options cannot be a nullptr");
+    }
+    if (VELOCYPACK_UNLIKELY(resource == nullptr)) {
+      throw Exception(Exception::InternalError, "Memory resource cannot be a nullptr");
+    }
+    _builder = std::allocate_shared<Builder>(
+        std::pmr::polymorphic_allocator<Builder>(resource), resource, options);
+    _builderPtr = _builder.get();
+  }
+
   Builder const& builder() const { return *_builderPtr; }
 
   static std::shared_ptr<Builder> fromJson(
@@ -188,8 +194,7 @@ class Parser {
     return parseInternal(multi);
   }
 
-  // We probably want a parse from stream at some stage...
-  // Not with this high-performance two-pass approach. :-(
+  // For input that arrives in chunks, use StreamParser.
 
   std::shared_ptr<Builder> steal() {
     // Parser object is broken after a steal()
@@ -209,6 +214,19 @@ class Parser {
 
   void clear() { _builderPtr->clear(); }
 
+  // with options->useStructuralIndex, the Parser keeps the structural
+  // index, which has 4 bytes per input byte, for the next parse. this
+  // releases it, e.g. after parsing an unusually big input
+  void releaseStructuralIndex() noexcept {
+    _structurals.reset();
+    _structuralsCapacity = 0;
+  }
+
+  // number of input bytes the kept structural index can cover
+  std::size_t structuralIndexCapacity() const noexcept {
+    return _structuralsCapacity > 0 ? _structuralsCapacity - 1 : 0;
+  }
+
  private:
   inline int peek() const {
     if (_pos >= _size) {
@@ -263,37 +281,40 @@ class Parser {
     _builderPtr->addNull();
   }
 
-  void scanDigits(ParsedNumber& value) {
-    while (true) {
-      int i = consume();
-      if (i < 0) {
-        return;
-      }
-      if (i < '0' || i > '9') {
-        unconsume();
-        return;
-      }
-      value.addDigit(i);
-    }
+  // checks if all 8 bytes in val are ASCII digits
+  static inline bool isEightDigits(uint64_t val) noexcept {
+    return (((val & 0xF0F0F0F0F0F0F0F0ULL) |
+             (((val + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+            0x3333333333333333ULL);
   }
 
-  double scanDigitsFractional() {
-    double pot = 0.1;
-    double x = 0.0;
-    while (true) {
-      int i = consume();
-      if (i < 0) {
-        return x;
-      }
-      if (i < '0' || i > '9') {
-        unconsume();
-        return x;
-      }
-      x = x + pot * (i - '0');
-      pot /= 10.0;
-    }
+  // converts 8 ASCII digits, read in little-endian order, into their value
+  static inline uint32_t parseEightDigits(uint64_t val) noexcept {
+    uint64_t const mask = 0x000000FF000000FFULL;
+    uint64_t const mul1 = 0x000F424000000064ULL;  // 100 + (1000000ULL << 32)
+    uint64_t const mul2 = 0x0000271000000001ULL;  // 1 + (10000ULL << 32)
+    val -= 0x3030303030303030ULL;
+    val = (val * 10) + (val >> 8);
+    val = (((val & mask) * mul1) + (((val >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(val);
   }
 
+  // adds the number to the Builder: as an integer if integer is true and
+  // it fits into 64 bits, otherwise as the correctly rounded double. text
+  // must contain the digits of the number without the sign, it is only
+  // read if the mantissa was truncated. throws NumberOutOfRange if the
+  // value is too large for a double
+  static void addNumber(Builder& builder, ParsedNumber const& number,
+                        bool negative, bool integer, char const* text,
+                        std::size_t length);
+
+  // scans the digits of the integral part (fractional == false) or the
+  // fractional part (fractional == true) of a number into value
+  void scanDigits(ParsedNumber& value, bool fractional);
+
+  // scans the digits of an exponent
+  int64_t scanExponent();
+
   inline int getOneOrThrow(char const* msg) {
     int i = consume();
     if (i < 0) {
@@ -315,6 +336,26 @@ class Parser {
   void parseObject();
 
   void parseJson();
+
+  void translateAttributeName(ValueLength keyPos);
+
+  // two-stage parsing using the structural index
+  bool buildStructuralIndex();
+
+  int nextStructural();
+
+  inline void consumeStructural() {
+    ++_pos;
+    ++_structuralPos;
+  }
+
+  void parseStringIndexed(uint32_t token);
+
+  void parseArrayIndexed();
+
+  void parseObjectIndexed();
+
+  void parseJsonIndexed();
 };
 
 }  // namespace arangodb::velocypack
@@ -0,0 +1,558 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/Builder.h"
+#include "velocypack/Exception.h"
+#include "velocypack/Iterator.h"
+#include "velocypack/ObjectShape.h"
+#include "velocypack/Options.h"
+#include "velocypack/Serializable.h"
+#include "velocypack/Slice.h"
+#include "velocypack/Value.h"
+
+// Compile-time serialization of C++ structs to and from VPack, without
+// virtual calls. A struct is made serializable by describing its fields,
+// either with the macro
+//
+//   struct Event { int64_t time; std::string level; };
+//   VELOCYPACK_REFLECT(Event, time, level)
+//
+// or by writing the descriptor function it expands to by hand, which also
+// allows attribute names that differ from the member names:
+//
+//   constexpr auto velocypackFields(Event const*) {
+//     return std::make_tuple(arangodb::velocypack::field("time", &Event::time),
+//                            arangodb::velocypack::field("level", &Event::level));
+//   }
+//
+// The descriptor must be declared in the namespace of the struct, so that
+// it is found by argument-dependent lookup. Duplicate attribute names are
+// rejected at compile time. Each struct is written as an Object via an
+// ObjectShape that is built once per struct type, so its keys are neither
+// encoded nor sorted again for each value. Builders with an
+// AttributeTranslator cannot use that shape, as their keys are translated,
+// so they get the same Object via Builder::add(name, ...) for each field.
+//
+// Other types can be made serializable by specializing Serializer<T>.
+
+namespace arangodb::velocypack {
+
+// descriptor of a data member of a struct, see velocypackFields()
+template<typename Class, typename T>
+struct Field {
+  std::string_view name;
+  T Class::*member;
+};
+
+template<typename Class, typename T>
+constexpr Field<Class, T> field(std::string_view name, T Class::*member) noexcept {
+  return Field<Class, T>{name, member};
+}
+
+// whether or not T has a velocypackFields() descriptor
+template<typename T, typename = void>
+struct IsReflected : std::false_type {};
+
+template<typename T>
+struct IsReflected<T, std::void_t<decltype(velocypackFields(
+                          static_cast<T const*>(nullptr)))>>
+    : std::true_type {};
+
+// the fields of a reflected struct, evaluated at compile time
+template<typename T>
+struct Reflection {
+  static constexpr auto fields = velocypackFields(static_cast<T const*>(nullptr));
+  static constexpr std::size_t size = std::tuple_size_v<std::decay_t<decltype(fields)>>;
+
+  static constexpr std::array<std::string_view, size> names() noexcept {
+    return std::apply(
+        [](auto const&... f) {
+          return std::array<std::string_view, size>{f.name...};
+        },
+        fields);
+  }
+
+  static constexpr bool hasUniqueNames() noexcept {
+    auto const n = names();
+    for (std::size_t i = 0; i < size; ++i) {
+      for (std::size_t j = i + 1; j < size; ++j) {
+        if (n[i] == n[j]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  static_assert(hasUniqueNames(), "duplicate attribute name in velocypackFields()");
+
+  // hash of an attribute name for the lookup table below
+  static constexpr uint64_t hashName(std::string_view name, uint64_t seed) noexcept {
+    uint64_t h = seed ^ (name.size() * 0x9e3779b97f4a7c15ULL);
+    for (char c : name) {
+      h ^= static_cast<uint8_t>(c);
+      h *= 0x100000001b3ULL;
+    }
+    return h ^ (h >> 29);
+  }
+
+  // open-addressing table from attribute name hashes to field positions,
+  // with at least 4 slots per field. the seed is chosen at compile time
+  // so that no two names collide, if such a seed is found quickly.
+  // otherwise colliding names are probed linearly
+  static constexpr std::size_t slots = [] {
+    std::size_t n = 1;
+    while (n < 4 * size) {
+      n <<= 1;
+    }
+    return n;
+  }();
+
+  struct LookupTable {
+    uint64_t seed = 0;
+    // field position, or size for empty slots
+    std::array<std::size_t, slots> fields{};
+  };
+
+  static constexpr LookupTable buildLookupTable() noexcept {
+    auto const n = names();
+    LookupTable best;
+    std::size_t bestCollisions = size + 1;
+    for (uint64_t seed = 0; seed < 256 && bestCollisions > 0; ++seed) {
+      LookupTable table;
+      table.seed = seed;
+      for (auto& f : table.fields) {
+        f = size;
+      }
+      std::size_t collisions = 0;
+      for (std::size_t i = 0; i < size; ++i) {
+        std::size_t slot = hashName(n[i], seed) & (slots - 1);
+        if (table.fields[slot] != size) {
+          ++collisions;
+          do {
+            slot = (slot + 1) & (slots - 1);
+          } while (table.fields[slot] != size);
+        }
+        table.fields[slot] = i;
+      }
+      if (collisions < bestCollisions) {
+        best = table;
+        bestCollisions = collisions;
+      }
+    }
+    return best;
+  }
+
+  static constexpr LookupTable lookupTable = buildLookupTable();
+
+  // position of the field with the given attribute name, or size if there
+  // is none
+  static std::size_t find(std::string_view name) noexcept {
+    static constexpr auto n = names();
+    std::size_t slot = hashName(name, lookupTable.seed) & (slots - 1);
+    while (true) {
+      std::size_t const field = lookupTable.fields[slot];
+      if (field == size || n[field] == name) {
+        return field;
+      }
+      slot = (slot + 1) & (slots - 1);
+    }
+  }
+
+  // the keys of the struct's Objects, prepared once, for Builders without
+  // an AttributeTranslator
+  static ObjectShape const& shape() {
+    static constexpr std::array<std::string_view, size> keys = names();
+    static ObjectShape const shape = [] {
+      Options options;
+      options.attributeTranslator = nullptr;
+      return ObjectShape(keys.data(), keys.size(), &options);
+    }();
+    return shape;
+  }
+};
+
+// converts values of type T to and from VPack. specializations provide
+//   static void toVelocyPack(Builder& builder, T const& value);
+//   static void fromVelocyPack(Slice slice, T& value);
+// toVelocyPack adds exactly one value to the Builder
+template<typename T, typename = void>
+struct Serializer {
+  template<typename>
+  struct always_false : std::false_type {};
+  static_assert(always_false<T>::value, "There is no serializer for this type.");
+};
+
+// add value to the builder, as a top-level value, an Array member or an
+// Object value after its key
+template<typename T>
+void serialize(Builder& builder, T const& value) {
+  Serializer<T>::toVelocyPack(builder, value);
+}
+
+// assign the contents of slice to value
+template<typename T>
+void deserialize(Slice slice, T& value) {
+  Serializer<T>::fromVelocyPack(slice, value);
+}
+
+template<typename T>
+T deserialize(Slice slice) {
+  T value{};
+  Serializer<T>::fromVelocyPack(slice, value);
+  return value;
+}
+
+template<>
+struct Serializer<bool> {
+  static void toVelocyPack(Builder& builder, bool value) {
+    builder.add(Value(value));
+  }
+  static void fromVelocyPack(Slice slice, bool& value) {
+    value = slice.getBool();
+  }
+};
+
+template<typename T>
+struct Serializer<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+  static void toVelocyPack(Builder& builder, T value) {
+    if constexpr (std::is_floating_point<T>::value) {
+      builder.add(Value(static_cast<double>(value)));
+    } else if constexpr (std::is_signed<T>::value) {
+      builder.add(Value(static_cast<int64_t>(value)));
+    } else {
+      builder.add(Value(static_cast<uint64_t>(value)));
+    }
+  }
+  static void fromVelocyPack(Slice slice, T& value) {
+    value = slice.template getNumericValue<T>();
+  }
+};
+
+template<>
+struct Serializer<std::string> {
+  static void toVelocyPack(Builder& builder, std::string const& value) {
+    builder.add(Value(value));
+  }
+  static void fromVelocyPack(Slice slice, std::string& value) {
+    value = slice.copyString();
+  }
+};
+
+// a std::string_view points into the Slice's memory after deserialization
+template<>
+struct Serializer<std::string_view> {
+  static void toVelocyPack(Builder& builder, std::string_view value) {
+    builder.add(Value(value));
+  }
+  static void fromVelocyPack(Slice slice, std::string_view& value) {
+    value = slice.stringView();
+  }
+};
+
+template<>
+struct Serializer<Slice> {
+  static void toVelocyPack(Builder& builder, Slice value) {
+    builder.add(value);
+  }
+  static void fromVelocyPack(Slice slice, Slice& value) {
+    value = slice;
+  }
+};
+
+// an empty std::optional is written as null. null and missing values are
+// read as an empty std::optional
+template<typename T>
+struct Serializer<std::optional<T>> {
+  static void toVelocyPack(Builder& builder, std::optional<T> const& value) {
+    if (value.has_value()) {
+      Serializer<T>::toVelocyPack(builder, *value);
+    } else {
+      builder.add(Value(ValueType::Null));
+    }
+  }
+  static void fromVelocyPack(Slice slice, std::optional<T>& value) {
+    if (slice.isNone() || slice.isNull()) {
+      value.reset();
+    } else {
+      Serializer<T>::fromVelocyPack(slice, value.emplace());
+    }
+  }
+};
+
+template<typename T, typename Allocator>
+struct Serializer<std::vector<T, Allocator>> {
+  static void toVelocyPack(Builder& builder, std::vector<T, Allocator> const& value) {
+    builder.openArray();
+    for (auto const& it : value) {
+      Serializer<T>::toVelocyPack(builder, it);
+    }
+    builder.close();
+  }
+  static void fromVelocyPack(Slice slice, std::vector<T, Allocator>& value) {
+    ArrayIterator it(slice);
+    value.clear();
+    value.reserve(static_cast<std::size_t>(it.size()));
+    for (; it.valid(); it.next()) {
+      Serializer<T>::fromVelocyPack(it.value(), value.emplace_back());
+    }
+  }
+};
+
+template<typename T, typename Compare, typename Allocator>
+struct Serializer<std::map<std::string, T, Compare, Allocator>> {
+  static void toVelocyPack(Builder& builder,
+                           std::map<std::string, T, Compare, Allocator> const& value) {
+    builder.openObject();
+    for (auto const& it : value) {
+      builder.add(Value(it.first));
+      Serializer<T>::toVelocyPack(builder, it.second);
+    }
+    builder.close();
+  }
+  static void fromVelocyPack(Slice slice,
+                             std::map<std::string, T, Compare, Allocator>& value) {
+    value.clear();
+    for (auto it : ObjectIterator(slice, true)) {
+      Serializer<T>::fromVelocyPack(it.value, value[it.key.copyString()]);
+    }
+  }
+};
+
+// adapter for Builder::add(name, Serialize(...)), which writes the key
+// like any other add(name, ...) and then lets the value add itself
+template<typename T>
+struct SerializeValue final : Serializable {
+  explicit SerializeValue(T const& value) noexcept : value(value) {}
+  void toVelocyPack(Builder& builder) const override {
+    serialize(builder, value);
+  }
+  T const& value;
+};
+
+// structs with a velocypackFields() descriptor are written as Objects
+template<typename T>
+struct Serializer<T, typename std::enable_if<IsReflected<T>::value>::type> {
+  static void toVelocyPack(Builder& builder, T const& value) {
+    ObjectShape const& shape = Reflection<T>::shape();
+    if (VELOCYPACK_LIKELY(builder.options->attributeTranslator ==
+                          shape.attributeTranslator())) {
+      builder.openObject(shape);
+      std::apply(
+          [&builder, &value](auto const&... f) {
+            (serialize(builder, value.*(f.member)), ...);
+          },
+          Reflection<T>::fields);
+    } else {
+      // the keys must be translated with the Builder's translator
+      builder.openObject();
+      std::apply(
+          [&builder, &value](auto const&... f) {
+            (builder.add(f.name, Serialize(SerializeValue<std::decay_t<
+                                               decltype(value.*(f.member))>>(
+                                     value.*(f.member)))),
+             ...);
+          },
+          Reflection<T>::fields);
+    }
+    builder.close();
+  }
+
+  // reads the Object in one sequential pass with an ObjectIterator and
+  // hands each attribute to its field via Reflection<T>::find().
+  // attributes that are not present in the Object leave their fields
+  // untouched, except for std::optional fields, which are reset. unknown
+  // attributes are ignored
+  static void fromVelocyPack(Slice slice, T& value) {
+    if (VELOCYPACK_UNLIKELY(!slice.isObject())) {
+      throw Exception(Exception::InvalidValueType, "Expecting Object");
+    }
+    constexpr std::size_t size = Reflection<T>::size;
+    std::array<bool, size> seen{};
+    for (ObjectIterator it(slice, true); it.valid(); it.next()) {
+      Slice key = it.key(false);
+      std::size_t const field = Reflection<T>::find(
+          key.isString() ? key.stringView() : key.makeKey().stringView());
+      if (field != size) {
+        readers[field](it.value(), value);
+        seen[field] = true;
+      }
+    }
+    if constexpr (hasOptionalFields()) {
+      for (std::size_t i = 0; i < size; ++i) {
+        if (!seen[i] && resetters[i] != nullptr) {
+          resetters[i](value);
+        }
+      }
+    }
+  }
+
+ private:
+  template<typename F>
+  struct IsOptional : std::false_type {};
+  template<typename F>
+  struct IsOptional<std::optional<F>> : std::true_type {};
+
+  template<std::size_t I>
+  using FieldType = std::decay_t<decltype(
+      std::declval<T&>().*(std::get<I>(Reflection<T>::fields).member))>;
+
+  template<std::size_t I>
+  static void readField(Slice slice, T& value) {
+    Serializer<FieldType<I>>::fromVelocyPack(
+        slice, value.*(std::get<I>(Reflection<T>::fields).member));
+  }
+
+  template<std::size_t I>
+  static void resetField(T& value) {
+    if constexpr (IsOptional<FieldType<I>>::value) {
+      (value.*(std::get<I>(Reflection<T>::fields).member)).reset();
+    }
+  }
+
+  template<std::size_t... I>
+  static constexpr std::array<void (*)(Slice, T&), sizeof...(I)> makeReaders(
+      std::index_sequence<I...>) noexcept {
+    return {{&readField<I>...}};
+  }
+
+  template<std::size_t... I>
+  static constexpr std::array<void (*)(T&), sizeof...(I)> makeResetters(
+      std::index_sequence<I...>) noexcept {
+    return {{(IsOptional<FieldType<I>>::value ? &resetField<I> : nullptr)...}};
+  }
+
+  template<std::size_t... I>
+  static constexpr bool hasOptionalFields(std::index_sequence<I...>) noexcept {
+    return (false || ... || IsOptional<FieldType<I>>::value);
+  }
+
+  static constexpr bool hasOptionalFields() noexcept {
+    return hasOptionalFields(std::make_index_sequence<Reflection<T>::size>());
+  }
+
+  // field setters, by field position
+  static constexpr auto readers =
+      makeReaders(std::make_index_sequence<Reflection<T>::size>());
+  static constexpr auto resetters =
+      makeResetters(std::make_index_sequence<Reflection<T>::size>());
+};
+
+}  // namespace arangodb::velocypack
+
+// implementation of VELOCYPACK_REFLECT
+#define VELOCYPACK_PP_EXPAND(x) x
+#define VELOCYPACK_PP_FOR_EACH_1(M, T, x) M(T, x)
+#define VELOCYPACK_PP_FOR_EACH_2(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_1(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_3(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_2(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_4(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_3(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_5(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_4(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_6(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_5(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_7(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_6(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_8(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_7(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_9(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_8(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_10(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_9(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_11(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_10(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_12(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_11(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_13(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_12(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_14(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_13(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_15(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_14(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_16(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_15(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_17(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_16(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_18(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_17(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_19(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_18(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_20(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_19(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_21(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_20(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_22(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_21(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_23(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_22(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_24(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_23(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_25(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_24(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_26(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_25(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_27(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_26(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_28(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_27(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_29(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_28(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_30(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_29(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_31(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_30(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_32(M, T, x, ...) \
+  M(T, x), VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_31(M, T, __VA_ARGS__))
+#define VELOCYPACK_PP_FOR_EACH_SELECT(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, NAME, ...) NAME
+#define VELOCYPACK_PP_FOR_EACH(M, T, ...)                  \
+  VELOCYPACK_PP_EXPAND(VELOCYPACK_PP_FOR_EACH_SELECT(                    \
+      __VA_ARGS__, VELOCYPACK_PP_FOR_EACH_32, VELOCYPACK_PP_FOR_EACH_31, VELOCYPACK_PP_FOR_EACH_30, VELOCYPACK_PP_FOR_EACH_29, VELOCYPACK_PP_FOR_EACH_28, VELOCYPACK_PP_FOR_EACH_27, VELOCYPACK_PP_FOR_EACH_26, VELOCYPACK_PP_FOR_EACH_25, VELOCYPACK_PP_FOR_EACH_24, VELOCYPACK_PP_FOR_EACH_23, VELOCYPACK_PP_FOR_EACH_22, VELOCYPACK_PP_FOR_EACH_21, VELOCYPACK_PP_FOR_EACH_20, VELOCYPACK_PP_FOR_EACH_19, VELOCYPACK_PP_FOR_EACH_18, VELOCYPACK_PP_FOR_EACH_17, VELOCYPACK_PP_FOR_EACH_16, VELOCYPACK_PP_FOR_EACH_15, VELOCYPACK_PP_FOR_EACH_14, VELOCYPACK_PP_FOR_EACH_13, VELOCYPACK_PP_FOR_EACH_12, VELOCYPACK_PP_FOR_EACH_11, VELOCYPACK_PP_FOR_EACH_10, VELOCYPACK_PP_FOR_EACH_9, VELOCYPACK_PP_FOR_EACH_8, VELOCYPACK_PP_FOR_EACH_7, VELOCYPACK_PP_FOR_EACH_6, VELOCYPACK_PP_FOR_EACH_5, VELOCYPACK_PP_FOR_EACH_4, VELOCYPACK_PP_FOR_EACH_3, VELOCYPACK_PP_FOR_EACH_2, VELOCYPACK_PP_FOR_EACH_1)(M, T, __VA_ARGS__))
+
+#define VELOCYPACK_REFLECT_FIELD(Type, name) \
+  ::arangodb::velocypack::field(#name, &Type::name)
+
+// declare the descriptor for the given data members of Type, with the
+// member names as attribute names. must be used in the namespace of Type,
+// and supports up to 32 members
+#define VELOCYPACK_REFLECT(Type, ...)                                  \
+  [[maybe_unused]] inline constexpr auto velocypackFields(Type const*) { \
+    return std::make_tuple(                                             \
+        VELOCYPACK_PP_FOR_EACH(VELOCYPACK_REFLECT_FIELD, Type, __VA_ARGS__)); \
+  }
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -118,7 +119,7 @@ template <typename T>
 struct StreamSinkImpl final : public Sink {
   explicit StreamSinkImpl(T* stream) : stream(stream) {}
 
-  void push_back(char c) override final { *stream << c; }
+  void push_back(char c) override final { stream->put(c); }
 
   void append(std::string const& p) override final { *stream << p; }
 
@@ -138,6 +139,79 @@ struct StreamSinkImpl final : public Sink {
 typedef StreamSinkImpl<std::ostringstream> StringStreamSink;
 typedef StreamSinkImpl<std::ofstream> OutputFileStreamSink;
 
+// collects the output in a local buffer of BufferSize bytes and passes
+// it on to the underlying sink in blocks, so that the many small appends
+// of a Dumper turn into few calls of the underlying sink. T can be Sink
+// or any concrete sink type. buffered output is passed on by flush() and
+// by the destructor. errors of the underlying sink are only reported by
+// flush(), so it should be called explicitly when the output is complete
+template <typename T, std::size_t BufferSize = 16384>
+struct BufferedSinkImpl final : public Sink {
+  static_assert(BufferSize >= 4096 && BufferSize <= 65536,
+                "buffer size must be between 4 KB and 64 KB");
+
+  explicit BufferedSinkImpl(T* sink) : sink(sink), _length(0) {}
+
+  ~BufferedSinkImpl() {
+    try {
+      flush();
+    } catch (...) {
+    }
+  }
+
+  void push_back(char c) override final {
+    if (VELOCYPACK_UNLIKELY(_length == BufferSize)) {
+      flush();
+    }
+    _buffer[_length++] = c;
+  }
+
+  void append(std::string const& p) override final {
+    append(p.data(), p.size());
+  }
+
+  void append(char const* p) override final { append(p, strlen(p)); }
+
+  void append(char const* p, ValueLength len) override final {
+    if (VELOCYPACK_LIKELY(len <= BufferSize - _length)) {
+      memcpy(&_buffer[_length], p, checkOverflow(len));
+      _length += static_cast<std::size_t>(len);
+      return;
+    }
+    flush();
+    if (len >= BufferSize) {
+      // large chunks bypass the buffer
+      sink->append(p, len);
+      return;
+    }
+    memcpy(&_buffer[0], p, checkOverflow(len));
+    _length = static_cast<std::size_t>(len);
+  }
+
+  void reserve(ValueLength len) override final {
+    // reservations that fit into the buffer need not be passed on
+    if (len > BufferSize - _length) {
+      sink->reserve(_length + len);
+    }
+  }
+
+  // passes all buffered output on to the underlying sink
+  void flush() {
+    if (_length > 0) {
+      sink->append(&_buffer[0], _length);
+      _length = 0;
+    }
+  }
+
+  T* sink;
+
+ private:
+  char _buffer[BufferSize];
+  std::size_t _length;
+};
+
+typedef BufferedSinkImpl<Sink> BufferedSink;
+
 }  // namespace arangodb::velocypack
 
 using VPackSink = arangodb::velocypack::Sink;
@@ -146,3 +220,4 @@ using VPackStringSink = arangodb::velocypack::StringSink;
 using VPackStringLengthSink = arangodb::velocypack::StringLengthSink;
 using VPackStringStreamSink = arangodb::velocypack::StringStreamSink;
 using VPackOutputFileStreamSink = arangodb::velocypack::OutputFileStreamSink;
+using VPackBufferedSink = arangodb::velocypack::BufferedSink;
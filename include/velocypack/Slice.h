@@ -48,6 +48,8 @@
 #include "velocypack/ValueType.h"
 
 namespace arangodb::velocypack {
+class AttributeSet;
+class CompiledPath;
 struct Sink;
 
 template<typename, typename = void>
@@ -60,6 +62,7 @@ struct Extractor;
 // A Slice does not own the VPack data it points to!
 class Slice {
   friend class Builder;
+  friend class CompiledPath;
   friend class ArrayIterator;
   friend class ObjectIterator;
   friend class ValueSlice;
@@ -419,7 +422,7 @@ class Slice {
   }
 
   constexpr bool isSorted() const noexcept {
-    return (head() >= 0x0b && head() <= 0x0e);
+    return ((head() >= 0x0b && head() <= 0x0e) || head() == 0x15);
   }
 
   // return the value for a Bool object
@@ -527,6 +530,8 @@ class Slice {
   // attribute name
   // - 0x12      : object with 8-byte index table entries, not sorted by
   // attribute name
+  // - 0x15      : object with 4-byte index table entries, sorted by attribute
+  // name, plus a hash table over the attribute names
   Slice keyAt(ValueLength index, bool translate = true) const {
     if (VELOCYPACK_UNLIKELY(!isObject())) {
       throw Exception(Exception::InvalidValueType, "Expecting type Object");
@@ -602,6 +607,10 @@ class Slice {
   // returns a Slice(ValueType::None) if not found
   Slice get(std::string_view attribute) const;
 
+  // look for the specified precompiled attribute path inside an Object
+  // returns a Slice(ValueType::None) if not found
+  Slice get(CompiledPath const& path, bool resolveExternals = false) const;
+
   [[deprecated]] Slice get(HashedStringRef attribute) const {
     return get(std::string_view(attribute.data(), attribute.size()));
   }
@@ -614,6 +623,24 @@ class Slice {
     return get(attribute);
   }
 
+  // look for many attributes inside an Object at once, which is cheaper
+  // than calling get() for each of them. out must have room for count
+  // Slices. out[i] is set to the value of attribute keys[i], or to a
+  // Slice(ValueType::None) if not found
+  void getMany(std::string_view const* keys, std::size_t count, Slice* out) const;
+
+  void getMany(std::vector<std::string_view> const& keys,
+               std::vector<Slice>& out) const {
+    out.resize(keys.size());
+    getMany(keys.data(), keys.size(), out.data());
+  }
+
+  // look for many attributes inside an Object at once, using attribute
+  // names that were prepared up front. out must have room for keys.size()
+  // Slices, which are set in the order of the attribute names the
+  // AttributeSet was created with
+  void getMany(AttributeSet const& keys, Slice* out) const;
+
   // whether or not an Object has a specific key
   template<typename T>
   bool hasKey(std::vector<T> const& attributes) const {
@@ -907,7 +934,7 @@ class Slice {
 
   ValueLength findDataOffset(uint8_t head) const noexcept {
     // Must be called for a non-empty array or object at start():
-    VELOCYPACK_ASSERT(head != 0x01 && head != 0x0a && head <= 0x14);
+    VELOCYPACK_ASSERT(head != 0x01 && head != 0x0a && head <= 0x15);
     unsigned int fsm = SliceStaticData::FirstSubMap[head];
     uint8_t const* start = this->start();
     if (fsm == 0) {
@@ -915,6 +942,10 @@ class Slice {
       VELOCYPACK_ASSERT(head == 0x13 || head == 0x14);
       return 1 + arangodb::velocypack::getVariableValueLength(readVariableValueLength<false>(start + 1));
     }
+    if (VELOCYPACK_LIKELY(start[fsm] != 0)) {
+      // no padding between the header and the first member
+      return fsm;
+    }
     if (fsm <= 2 && start[2] != 0) {
       return 2;
     }
@@ -1087,12 +1118,9 @@ class Slice {
       }
       ValueLength end = readIntegerNonEmpty<ValueLength>(start() + 1, offsetSize);
       return (end - firstSubOffset) / s;
-    } else if (offsetSize < 8) {
-      return readIntegerNonEmpty<ValueLength>(start() + offsetSize + 1, offsetSize);
     }
 
-    ValueLength end = readIntegerNonEmpty<ValueLength>(start() + 1, offsetSize);
-    return readIntegerNonEmpty<ValueLength>(start() + end - offsetSize, offsetSize);
+    return indexedLength(offsetSize);
   }
 
   // return the number of members for an Object
@@ -1115,12 +1143,18 @@ class Slice {
     ValueLength const offsetSize = indexEntrySize(h);
     VELOCYPACK_ASSERT(offsetSize > 0);
 
+    return indexedLength(offsetSize);
+  }
+
+  // return the number of members for an Array or Object with an index table.
+  // the number is stored after the byte size, except for 8-byte wide index
+  // tables, which store it at the end of the value
+  ValueLength indexedLength(ValueLength offsetSize) const noexcept {
     if (offsetSize < 8) {
       return readIntegerNonEmpty<ValueLength>(start() + offsetSize + 1, offsetSize);
     }
-
-    ValueLength end = readIntegerNonEmpty<ValueLength>(start() + 1, offsetSize);
-    return readIntegerNonEmpty<ValueLength>(start() + end - offsetSize, offsetSize);
+    ValueLength end = readIntegerFixed<ValueLength, 8>(start() + 1);
+    return readIntegerFixed<ValueLength, 8>(start() + end - 8);
   }
 
   // get the total byte size for a String slice, including the head byte.
@@ -1145,7 +1179,7 @@ class Slice {
   Slice getNth(ValueLength index) const;
 
   // extract the nth member from an Object, note that this is the nth
-  // entry in the hash table for types 0x0b to 0x0e
+  // entry in the index table for types 0x0b to 0x0e and 0x15
   Slice getNthKey(ValueLength index, bool translate) const;
 
   // extract the nth member from an Object, no translation
@@ -1179,6 +1213,26 @@ class Slice {
   template<ValueLength offsetSize>
   Slice searchObjectKeyBinary(std::string_view attribute, ValueLength ieBase, ValueLength n) const;
 
+  // look up the specified attribute in the hash table of an Object of
+  // type 0x15
+  Slice searchObjectKeyHashed(std::string_view attribute, uint64_t hash,
+                              ValueLength ieBase, ValueLength n) const;
+
+  // return the position of the specified attribute in the index table of
+  // an Object of type 0x15, or n if not found
+  ValueLength findObjectKeyHashed(std::string_view attribute, uint64_t hash,
+                                  ValueLength ieBase, ValueLength n) const;
+
+  // look up many sorted attribute names inside an Object in one pass
+  template<typename Keys>
+  void getManySorted(Keys const& keys, Slice* out) const;
+
+  // look up many sorted attribute names in the sorted index table of an
+  // Object, in one pass over the table
+  template<ValueLength offsetSize, typename Keys>
+  void searchObjectKeysMerge(Keys const& keys, Slice* out,
+                             ValueLength ieBase, ValueLength n) const;
+
   // extracts a pointer from the slice and converts it into a
   // built-in pointer type
   char const* extractPointer() const {
@@ -1208,113 +1262,31 @@ class Slice {
 
   // get the total byte size for the slice, including the head byte
   ValueLength byteSize(uint8_t const* start) const {
-    uint8_t h = *start;
+    uint8_t const h = *start;
 
     // check if the type has a fixed length first
     ValueLength l = static_cast<ValueLength>(SliceStaticData::FixedTypeLengths[h]);
-    if (l != 0) {
+    if (VELOCYPACK_LIKELY(l != 0)) {
       // return fixed length
       return l;
     }
 
-    // types with dynamic lengths need special treatment:
-    switch (type(h)) {
-      case ValueType::Array:
-      case ValueType::Object: {
-        if (h == 0x13 || h == 0x14) {
-          // compact Array or Object
-          return readVariableValueLength<false>(start + 1);
-        }
-
-        VELOCYPACK_ASSERT(h > 0x01 && h <= 0x0e && h != 0x0a);
-        if (VELOCYPACK_UNLIKELY(h >= sizeof(SliceStaticData::WidthMap) / sizeof(SliceStaticData::WidthMap[0]))) {
-          throw Exception(Exception::InternalError, "invalid Array/Object type");
-        }
-        return readIntegerNonEmpty<ValueLength>(start + 1,
-                                                SliceStaticData::WidthMap[h]);
-      }
-
-      case ValueType::String: {
-        VELOCYPACK_ASSERT(h == 0xbf);
-
-        if (VELOCYPACK_UNLIKELY(h < 0xbf)) {
-          // we cannot get here, because the FixedTypeLengths lookup
-          // above will have kicked in already. however, the compiler
-          // claims we'll be reading across the bounds of the input
-          // here...
-          return h - 0x40;
-        }
-
-        // long UTF-8 String
-        return static_cast<ValueLength>(
-            1 + 8 + readIntegerFixed<ValueLength, 8>(start + 1));
-      }
-
-      case ValueType::Binary: {
-        VELOCYPACK_ASSERT(h >= 0xc0 && h <= 0xc7);
-        return static_cast<ValueLength>(
-            1 + h - 0xbf + readIntegerNonEmpty<ValueLength>(start + 1, h - 0xbf));
-      }
-
-      case ValueType::BCD: {
-        if (h <= 0xcf) {
-          // positive BCD
-          VELOCYPACK_ASSERT(h >= 0xc8 && h < 0xcf);
-          return static_cast<ValueLength>(
-              1 + h - 0xc7 + readIntegerNonEmpty<ValueLength>(start + 1, h - 0xc7));
-        }
-
-        // negative BCD
-        VELOCYPACK_ASSERT(h >= 0xd0 && h < 0xd7);
-        return static_cast<ValueLength>(
-            1 + h - 0xcf + readIntegerNonEmpty<ValueLength>(start + 1, h - 0xcf));
-      }
-
-      case ValueType::Tagged: {
-        uint8_t offset = tagsOffset(start);
-        return byteSize(start + offset) + offset;
-      }
-
-      case ValueType::Custom: {
-        VELOCYPACK_ASSERT(h >= 0xf4);
-        switch (h) {
-          case 0xf4:
-          case 0xf5:
-          case 0xf6: {
-            return 2 + readIntegerFixed<ValueLength, 1>(start + 1);
-          }
-
-          case 0xf7:
-          case 0xf8:
-          case 0xf9:  {
-            return 3 + readIntegerFixed<ValueLength, 2>(start + 1);
-          }
-
-          case 0xfa:
-          case 0xfb:
-          case 0xfc: {
-            return 5 + readIntegerFixed<ValueLength, 4>(start + 1);
-          }
-
-          case 0xfd:
-          case 0xfe:
-          case 0xff: {
-            return 9 + readIntegerFixed<ValueLength, 8>(start + 1);
-          }
-
-          default: {
-            // fallthrough intentional
-          }
-        }
-      }
-      default: {
-        // fallthrough intentional
-      }
+    // most other types store their length directly after the head byte
+    unsigned int const w = SliceStaticData::LengthWidthMap[h];
+    if (VELOCYPACK_LIKELY(w != 0)) {
+      // Arrays and Objects store their total byte size, all other types
+      // the number of bytes following the length field
+      ValueLength const offset = (h <= 0x15) ? 0 : 1 + w;
+      return offset + readIntegerNonEmpty<ValueLength>(start + 1, w);
     }
 
-    throw Exception(Exception::InternalError, "Invalid type for byteSize()");
+    return byteSizeDynamic(start);
   }
 
+  // get the total byte size for compact Arrays and Objects and tagged values.
+  // throws for invalid types
+  ValueLength byteSizeDynamic(uint8_t const* start) const;
+
 };
 
 static_assert(!std::is_polymorphic<Slice>::value, "Slice must not be polymorphic");
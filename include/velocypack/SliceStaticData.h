@@ -165,6 +165,142 @@ struct SliceStaticData {
     /* 0xfe */ 0,                    /* 0xff */ 0
   };
 
+  // width of the length field that directly follows the head byte, for all
+  // types that store their length in the value. Arrays and Objects store
+  // their total byte size in it, all other types the number of bytes
+  // following the length field. 0 for fixed-length types, compact Arrays
+  // and Objects, tags and invalid types
+  static constexpr uint8_t LengthWidthMap[256] = {
+    /* 0x00 */ 0,                    /* 0x01 */ 0,
+    /* 0x02 */ 1,                    /* 0x03 */ 2,
+    /* 0x04 */ 4,                    /* 0x05 */ 8,
+    /* 0x06 */ 1,                    /* 0x07 */ 2,
+    /* 0x08 */ 4,                    /* 0x09 */ 8,
+    /* 0x0a */ 0,                    /* 0x0b */ 1,
+    /* 0x0c */ 2,                    /* 0x0d */ 4,
+    /* 0x0e */ 8,                    /* 0x0f */ 1,
+    /* 0x10 */ 2,                    /* 0x11 */ 4,
+    /* 0x12 */ 8,                    /* 0x13 */ 0,
+    /* 0x14 */ 0,                    /* 0x15 */ 4,
+    /* 0x16 */ 0,                    /* 0x17 */ 0,
+    /* 0x18 */ 0,                    /* 0x19 */ 0,
+    /* 0x1a */ 0,                    /* 0x1b */ 0,
+    /* 0x1c */ 0,                    /* 0x1d */ 0,
+    /* 0x1e */ 0,                    /* 0x1f */ 0,
+    /* 0x20 */ 0,                    /* 0x21 */ 0,
+    /* 0x22 */ 0,                    /* 0x23 */ 0,
+    /* 0x24 */ 0,                    /* 0x25 */ 0,
+    /* 0x26 */ 0,                    /* 0x27 */ 0,
+    /* 0x28 */ 0,                    /* 0x29 */ 0,
+    /* 0x2a */ 0,                    /* 0x2b */ 0,
+    /* 0x2c */ 0,                    /* 0x2d */ 0,
+    /* 0x2e */ 0,                    /* 0x2f */ 0,
+    /* 0x30 */ 0,                    /* 0x31 */ 0,
+    /* 0x32 */ 0,                    /* 0x33 */ 0,
+    /* 0x34 */ 0,                    /* 0x35 */ 0,
+    /* 0x36 */ 0,                    /* 0x37 */ 0,
+    /* 0x38 */ 0,                    /* 0x39 */ 0,
+    /* 0x3a */ 0,                    /* 0x3b */ 0,
+    /* 0x3c */ 0,                    /* 0x3d */ 0,
+    /* 0x3e */ 0,                    /* 0x3f */ 0,
+    /* 0x40 */ 0,                    /* 0x41 */ 0,
+    /* 0x42 */ 0,                    /* 0x43 */ 0,
+    /* 0x44 */ 0,                    /* 0x45 */ 0,
+    /* 0x46 */ 0,                    /* 0x47 */ 0,
+    /* 0x48 */ 0,                    /* 0x49 */ 0,
+    /* 0x4a */ 0,                    /* 0x4b */ 0,
+    /* 0x4c */ 0,                    /* 0x4d */ 0,
+    /* 0x4e */ 0,                    /* 0x4f */ 0,
+    /* 0x50 */ 0,                    /* 0x51 */ 0,
+    /* 0x52 */ 0,                    /* 0x53 */ 0,
+    /* 0x54 */ 0,                    /* 0x55 */ 0,
+    /* 0x56 */ 0,                    /* 0x57 */ 0,
+    /* 0x58 */ 0,                    /* 0x59 */ 0,
+    /* 0x5a */ 0,                    /* 0x5b */ 0,
+    /* 0x5c */ 0,                    /* 0x5d */ 0,
+    /* 0x5e */ 0,                    /* 0x5f */ 0,
+    /* 0x60 */ 0,                    /* 0x61 */ 0,
+    /* 0x62 */ 0,                    /* 0x63 */ 0,
+    /* 0x64 */ 0,                    /* 0x65 */ 0,
+    /* 0x66 */ 0,                    /* 0x67 */ 0,
+    /* 0x68 */ 0,                    /* 0x69 */ 0,
+    /* 0x6a */ 0,                    /* 0x6b */ 0,
+    /* 0x6c */ 0,                    /* 0x6d */ 0,
+    /* 0x6e */ 0,                    /* 0x6f */ 0,
+    /* 0x70 */ 0,                    /* 0x71 */ 0,
+    /* 0x72 */ 0,                    /* 0x73 */ 0,
+    /* 0x74 */ 0,                    /* 0x75 */ 0,
+    /* 0x76 */ 0,                    /* 0x77 */ 0,
+    /* 0x78 */ 0,                    /* 0x79 */ 0,
+    /* 0x7a */ 0,                    /* 0x7b */ 0,
+    /* 0x7c */ 0,                    /* 0x7d */ 0,
+    /* 0x7e */ 0,                    /* 0x7f */ 0,
+    /* 0x80 */ 0,                    /* 0x81 */ 0,
+    /* 0x82 */ 0,                    /* 0x83 */ 0,
+    /* 0x84 */ 0,                    /* 0x85 */ 0,
+    /* 0x86 */ 0,                    /* 0x87 */ 0,
+    /* 0x88 */ 0,                    /* 0x89 */ 0,
+    /* 0x8a */ 0,                    /* 0x8b */ 0,
+    /* 0x8c */ 0,                    /* 0x8d */ 0,
+    /* 0x8e */ 0,                    /* 0x8f */ 0,
+    /* 0x90 */ 0,                    /* 0x91 */ 0,
+    /* 0x92 */ 0,                    /* 0x93 */ 0,
+    /* 0x94 */ 0,                    /* 0x95 */ 0,
+    /* 0x96 */ 0,                    /* 0x97 */ 0,
+    /* 0x98 */ 0,                    /* 0x99 */ 0,
+    /* 0x9a */ 0,                    /* 0x9b */ 0,
+    /* 0x9c */ 0,                    /* 0x9d */ 0,
+    /* 0x9e */ 0,                    /* 0x9f */ 0,
+    /* 0xa0 */ 0,                    /* 0xa1 */ 0,
+    /* 0xa2 */ 0,                    /* 0xa3 */ 0,
+    /* 0xa4 */ 0,                    /* 0xa5 */ 0,
+    /* 0xa6 */ 0,                    /* 0xa7 */ 0,
+    /* 0xa8 */ 0,                    /* 0xa9 */ 0,
+    /* 0xaa */ 0,                    /* 0xab */ 0,
+    /* 0xac */ 0,                    /* 0xad */ 0,
+    /* 0xae */ 0,                    /* 0xaf */ 0,
+    /* 0xb0 */ 0,                    /* 0xb1 */ 0,
+    /* 0xb2 */ 0,                    /* 0xb3 */ 0,
+    /* 0xb4 */ 0,                    /* 0xb5 */ 0,
+    /* 0xb6 */ 0,                    /* 0xb7 */ 0,
+    /* 0xb8 */ 0,                    /* 0xb9 */ 0,
+    /* 0xba */ 0,                    /* 0xbb */ 0,
+    /* 0xbc */ 0,                    /* 0xbd */ 0,
+    /* 0xbe */ 0,                    /* 0xbf */ 8,
+    /* 0xc0 */ 1,                    /* 0xc1 */ 2,
+    /* 0xc2 */ 3,                    /* 0xc3 */ 4,
+    /* 0xc4 */ 5,                    /* 0xc5 */ 6,
+    /* 0xc6 */ 7,                    /* 0xc7 */ 8,
+    /* 0xc8 */ 1,                    /* 0xc9 */ 2,
+    /* 0xca */ 3,                    /* 0xcb */ 4,
+    /* 0xcc */ 5,                    /* 0xcd */ 6,
+    /* 0xce */ 7,                    /* 0xcf */ 8,
+    /* 0xd0 */ 1,                    /* 0xd1 */ 2,
+    /* 0xd2 */ 3,                    /* 0xd3 */ 4,
+    /* 0xd4 */ 5,                    /* 0xd5 */ 6,
+    /* 0xd6 */ 7,                    /* 0xd7 */ 8,
+    /* 0xd8 */ 0,                    /* 0xd9 */ 0,
+    /* 0xda */ 0,                    /* 0xdb */ 0,
+    /* 0xdc */ 0,                    /* 0xdd */ 0,
+    /* 0xde */ 0,                    /* 0xdf */ 0,
+    /* 0xe0 */ 0,                    /* 0xe1 */ 0,
+    /* 0xe2 */ 0,                    /* 0xe3 */ 0,
+    /* 0xe4 */ 0,                    /* 0xe5 */ 0,
+    /* 0xe6 */ 0,                    /* 0xe7 */ 0,
+    /* 0xe8 */ 0,                    /* 0xe9 */ 0,
+    /* 0xea */ 0,                    /* 0xeb */ 0,
+    /* 0xec */ 0,                    /* 0xed */ 0,
+    /* 0xee */ 0,                    /* 0xef */ 0,
+    /* 0xf0 */ 0,                    /* 0xf1 */ 0,
+    /* 0xf2 */ 0,                    /* 0xf3 */ 0,
+    /* 0xf4 */ 1,                    /* 0xf5 */ 1,
+    /* 0xf6 */ 1,                    /* 0xf7 */ 2,
+    /* 0xf8 */ 2,                    /* 0xf9 */ 2,
+    /* 0xfa */ 4,                    /* 0xfb */ 4,
+    /* 0xfc */ 4,                    /* 0xfd */ 8,
+    /* 0xfe */ 8,                    /* 0xff */ 8
+  };
+
   static constexpr ValueType TypeMap[256] = {
     /* 0x00 */ VT::None,     /* 0x01 */ VT::Array,
     /* 0x02 */ VT::Array,    /* 0x03 */ VT::Array,
@@ -176,7 +312,7 @@ struct SliceStaticData {
     /* 0x0e */ VT::Object,   /* 0x0f */ VT::Object,
     /* 0x10 */ VT::Object,   /* 0x11 */ VT::Object,
     /* 0x12 */ VT::Object,   /* 0x13 */ VT::Array,
-    /* 0x14 */ VT::Object,   /* 0x15 */ VT::None,
+    /* 0x14 */ VT::Object,   /* 0x15 */ VT::Object,
     /* 0x16 */ VT::None,     /* 0x17 */ VT::Illegal,
     /* 0x18 */ VT::Null,     /* 0x19 */ VT::Bool,
     /* 0x1a */ VT::Bool,     /* 0x1b */ VT::Double,
@@ -316,6 +452,9 @@ struct SliceStaticData {
     2,  // 0x10, object with unsorted index table
     4,  // 0x11, object with unsorted index table
     8,  // 0x12, object with unsorted index table
+    0,  // 0x13, compact array, no index table
+    0,  // 0x14, compact object, no index table
+    4,  // 0x15, object with sorted index table and hash table
     0
   };
 
@@ -341,6 +480,7 @@ struct SliceStaticData {
     9,  // 0x12, object with unsorted index table,
     0,  // 0x13, compact array, no index table - note: the offset is dynamic!
     0,  // 0x14, compact object, no index table - note: the offset is dynamic!
+    9,  // 0x15, object with sorted index table and hash table
     0
   };
 
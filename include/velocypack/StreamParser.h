@@ -0,0 +1,211 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/Builder.h"
+#include "velocypack/Exception.h"
+#include "velocypack/Options.h"
+
+namespace arangodb::velocypack {
+
+class StreamParser {
+  // This class parses JSON that arrives in chunks of arbitrary size.
+  // Input is handed in via feed() and can be split at any byte, even
+  // inside strings, escape sequences or numbers. All state that is needed
+  // to continue is kept in the parser, and the result is appended to the
+  // Builder as the input arrives, so the input chunks do not need to be
+  // kept around. finish() must be called after the last chunk.
+  // The produced VPack is the same as the one produced by Parser.
+
+  enum class State : uint8_t {
+    Value,           // expecting a value (top level or after ':')
+    ArrayStart,      // after '[', expecting a value or ']'
+    ArrayValue,      // after ',' in an array, expecting a value
+    ArrayNext,       // after an array member, expecting ',' or ']'
+    ObjectStart,     // after '{', expecting a key or '}'
+    ObjectKey,       // after ',' in an object, expecting a key
+    ObjectColon,     // after a key, expecting ':'
+    ObjectNext,      // after an object value, expecting ',' or '}'
+    Done,            // after a top-level value
+    String,          // inside a string
+    StringEscape,    // after a backslash inside a string
+    StringUnicode,   // inside a \uXXXX escape sequence
+    StringUtf8,      // inside a multi-byte UTF-8 sequence
+    Number,          // inside a number
+    Literal,         // inside true, false or null
+  };
+
+  // position inside a number, so that it ends at the same byte as in
+  // Parser::parseNumber
+  enum class NumberState : uint8_t {
+    Sign,            // after '-'
+    Zero,            // after a leading '0'
+    Integer,         // inside the integer digits
+    Dot,             // after '.'
+    Fraction,        // inside the fractional digits
+    Exponent,        // after 'e' or 'E'
+    ExponentSign,    // after the sign of the exponent
+    ExponentDigits,  // inside the exponent digits
+  };
+
+  std::shared_ptr<Builder> _builder;
+  Builder* _builderPtr;
+  // nesting stack, true for objects and false for arrays
+  std::vector<bool> _nesting;
+  // number of bytes fed in previous chunks
+  std::size_t _offset;
+  // absolute position of the last error
+  std::size_t _errorPos;
+  // number of top-level values parsed
+  ValueLength _count;
+  State _state;
+  bool _multi;
+  bool _started;
+  // number of bytes of the optional BOM seen
+  uint8_t _bomPos;
+  // whether the top-level value was added to an open array of the builder
+  bool _haveReported;
+
+  // string state
+  bool _isKey;
+  bool _large;
+  uint8_t _pendingCount;
+  ValueLength _stringBase;
+  uint32_t _highSurrogate;
+  uint32_t _unicodeValue;
+
+  // number or literal state
+  std::size_t _tokenStart;
+  NumberState _numberState;
+  char const* _literal;
+  std::string _token;
+
+ public:
+  Options const* options;
+
+  StreamParser(StreamParser const&) = delete;
+  StreamParser(StreamParser&&) = delete;
+  StreamParser& operator=(StreamParser const&) = delete;
+  StreamParser& operator=(StreamParser&&) = delete;
+  ~StreamParser() = default;
+
+  explicit StreamParser(Options const* options = &Options::Defaults,
+                        bool multi = false);
+
+  explicit StreamParser(std::shared_ptr<Builder> const& builder,
+                        Options const* options = &Options::Defaults,
+                        bool multi = false);
+
+  // This method produces a parser that does not own the builder
+  explicit StreamParser(Builder& builder,
+                        Options const* options = &Options::Defaults,
+                        bool multi = false);
+
+  Builder const& builder() const { return *_builderPtr; }
+
+  // parses the next chunk of input
+  void feed(uint8_t const* data, std::size_t size);
+
+  void feed(char const* data, std::size_t size) {
+    feed(reinterpret_cast<uint8_t const*>(data), size);
+  }
+
+  void feed(std::string_view data) {
+    feed(reinterpret_cast<uint8_t const*>(data.data()), data.size());
+  }
+
+  // signals the end of input. throws if the input ended in the middle
+  // of a value, and returns the number of top-level values parsed
+  ValueLength finish();
+
+  // prepares the parser for another input, keeping the builder
+  void reset(bool multi = false);
+
+  std::shared_ptr<Builder> steal() {
+    // StreamParser object is broken after a steal()
+    std::shared_ptr<Builder> res(_builder);
+    _builder.reset();
+    _builderPtr = nullptr;
+    return res;
+  }
+
+  // Returns the position (counted over all chunks) at the time when the
+  // just reported error occurred, only use when handling an exception.
+  // The parser cannot be used further after an exception, unless reset()
+  // is called.
+  std::size_t errorPos() const { return _errorPos; }
+
+ private:
+  inline bool isWhiteSpace(uint8_t i) const noexcept {
+    return (i == ' ' || i == '\t' || i == '\n' || i == '\r');
+  }
+
+  void start();
+
+  void parseChunk(uint8_t const* data, std::size_t size, std::size_t& pos);
+
+  [[noreturn]] void throwUnfinished();
+
+  void beginTopLevel();
+
+  // position is the absolute position of c in the input
+  void beginValue(uint8_t c, std::size_t position);
+
+  void valueDone();
+
+  void beginString(bool isKey);
+
+  void continueString(uint8_t const* data, std::size_t size,
+                      std::size_t& pos);
+
+  void continueEscape(uint8_t c);
+
+  void continueUnicode(uint8_t c);
+
+  void continueUtf8(uint8_t c);
+
+  void finishString();
+
+  void continueNumber(uint8_t const* data, std::size_t size,
+                      std::size_t& pos);
+
+  void finishNumber();
+
+  void continueLiteral(uint8_t c);
+
+  void closeArray();
+
+  void closeObject();
+};
+
+}  // namespace arangodb::velocypack
+
+using VPackStreamParser = arangodb::velocypack::StreamParser;
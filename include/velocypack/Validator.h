@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "velocypack/velocypack-common.h"
 #include "velocypack/Options.h"
 
@@ -32,9 +34,43 @@ class Slice;
 
 class Validator {
   // This class can validate a binary VelocyPack value.
+  // With a concurrency greater than 1, the members of big Arrays and
+  // Objects with index table are validated on multiple threads, as their
+  // bounds are known from the index table. Compact Arrays and Objects
+  // have no index table and are always validated on one thread.
+
+  // what a Task consists of
+  enum class TaskKind : uint8_t {
+    // a value of exactly length bytes
+    Value,
+    // an Object key/value pair of exactly length bytes
+    ObjectMember,
+    // same as ObjectMember, but only String keys are allowed
+    StringKeyObjectMember
+  };
+
+  // a member of a compound value, or a top-level value, that is validated
+  // on its own
+  struct Task {
+    uint8_t const* ptr;
+    std::size_t length;
+    TaskKind kind;
+  };
 
  public:
-  explicit Validator(Options const* options = &Options::Defaults);
+  // compound values smaller than this are validated on one thread
+  static constexpr std::size_t minParallelSize = 1024 * 1024;
+
+  // concurrency is the maximum number of threads used for validating a
+  // value, 0 means the number of hardware threads. by default, values are
+  // only validated on the calling thread.
+  // the Validator recurses into every level of nested Arrays and Objects.
+  // values nested deeper than options->maxValidationDepth (1000 by
+  // default) are rejected, so that hostile input cannot exhaust the stack
+  // of the calling thread or of the threads used for validation. setting
+  // it to 0 removes the limit, which is only safe for trusted data
+  explicit Validator(Options const* options = &Options::Defaults,
+                     std::size_t concurrency = 1);
   ~Validator() = default;
 
  public:
@@ -48,6 +84,18 @@ class Validator {
   // throws if the data is invalid
   bool validate(uint8_t const* ptr, std::size_t length, bool isSubPart = false);
 
+  // validates a buffer of concatenated VelocyPack values starting at ptr,
+  // with length bytes length, and returns the number of values.
+  // throws if any of the values is invalid
+  std::size_t validateMany(char const* ptr, std::size_t length) {
+    return validateMany(reinterpret_cast<uint8_t const*>(ptr), length);
+  }
+
+  // validates a buffer of concatenated VelocyPack values starting at ptr,
+  // with length bytes length, and returns the number of values.
+  // throws if any of the values is invalid
+  std::size_t validateMany(uint8_t const* ptr, std::size_t length);
+
  private:
   void validateArray(uint8_t const* ptr, std::size_t length);
   void validateCompactArray(uint8_t const* ptr, std::size_t length);
@@ -56,15 +104,22 @@ class Validator {
   void validateObject(uint8_t const* ptr, std::size_t length);
   void validateCompactObject(uint8_t const* ptr, std::size_t length);
   void validateIndexedObject(uint8_t const* ptr, std::size_t length);
+  void validateHashIndexedObject(uint8_t const* ptr, std::size_t length);
   void validateBufferLength(std::size_t expected, std::size_t actual, bool isSubPart);
   void validateSliceLength(uint8_t const* ptr, std::size_t length, bool isSubPart);
   ValueLength readByteSize(uint8_t const*& ptr, uint8_t const* end);
+  void validateObjectMember(uint8_t const* ptr, std::size_t length, bool stringKeysOnly);
+  void validateMembers(uint8_t const* ptr, std::vector<ValueLength> const& offsets,
+                       ValueLength begin, ValueLength end, TaskKind kind);
+  void validateTask(Task const& task);
+  void validateTasks(std::vector<Task> const& tasks);
 
  public:
   Options const* options;
 
  private:
   int _level;
+  std::size_t _concurrency;
 };
 
 }  // namespace arangodb::velocypack
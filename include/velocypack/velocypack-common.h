@@ -82,6 +82,14 @@
 #define VELOCYPACK_FORCE_INLINE __forceinline
 #endif
 
+// attribute used to prevent inlining of functions, e.g. to keep big stack
+// frames out of recursive functions
+#if defined(__GNUC__) || defined(__clang__)
+#define VELOCYPACK_NOINLINE __attribute__((__noinline__))
+#elif _WIN32
+#define VELOCYPACK_NOINLINE __declspec(noinline)
+#endif
+
 #ifndef VELOCYPACK_XXHASH
 #ifndef VELOCYPACK_FASTHASH
 // default to xxhash if no hash define is set
@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/AttributeSet.h"
+#include "hash-index.h"
+
+using namespace arangodb::velocypack;
+
+AttributeSet::AttributeSet(std::string_view const* keys, std::size_t count) {
+  // sort positions by name. duplicates stay in their original order, so
+  // that the first occurrence of each name comes first
+  std::vector<std::size_t> order(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [keys](std::size_t a, std::size_t b) {
+    int res = keys[a].compare(keys[b]);
+    return res < 0 || (res == 0 && a < b);
+  });
+
+  for (std::size_t i = 0; i < count; ++i) {
+    std::string_view key = keys[order[i]];
+    if (i > 0 && key == keys[order[i - 1]]) {
+      _duplicates.emplace_back(order[i], _targets.back());
+      continue;
+    }
+    _keys.emplace_back(key);
+    _hashes.push_back(hashIndexKey(key.data(), key.size()));
+    _targets.push_back(order[i]);
+  }
+}
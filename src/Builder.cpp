@@ -22,6 +22,7 @@
 /// @author Jan Steemann
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <string_view>
@@ -31,7 +32,10 @@
 #include "velocypack/Builder.h"
 #include "velocypack/Dumper.h"
 #include "velocypack/Iterator.h"
+#include "velocypack/ObjectShape.h"
 #include "velocypack/Sink.h"
+#include "hash-index.h"
+#include "radix-sort.h"
 
 using namespace arangodb::velocypack;
 
@@ -39,8 +43,8 @@ namespace {
   
 // checks whether a memmove operation is allowed to get rid of the padding
 bool isAllowedToMemmove(Options const* options, uint8_t const* start, 
-                        std::vector<ValueLength>::iterator indexStart, 
-                        std::vector<ValueLength>::iterator indexEnd,
+                        std::pmr::vector<ValueLength>::iterator indexStart, 
+                        std::pmr::vector<ValueLength>::iterator indexEnd,
                         ValueLength offsetSize) {
   VELOCYPACK_ASSERT(offsetSize == 1 || offsetSize == 2);
 
@@ -59,6 +63,13 @@ bool isAllowedToMemmove(Options const* options, uint8_t const* start,
   return false;
 }
 
+std::pmr::memory_resource* checkResource(std::pmr::memory_resource* resource) {
+  if (VELOCYPACK_UNLIKELY(resource == nullptr)) {
+    throw Exception(Exception::InternalError, "Memory resource cannot be a nullptr");
+  }
+  return resource;
+}
+
 uint8_t determineArrayType(bool needIndexTable, ValueLength offsetSize) {
   uint8_t type;
   // Now build the table:
@@ -82,6 +93,8 @@ constexpr ValueLength linearAttributeUniquenessCutoff = 4;
   
 // struct used when sorting index tables for objects:
 struct SortEntry {
+  // first 8 bytes of the name, see radixPrefixKey()
+  uint64_t prefix;
   uint8_t const* nameStart;
   uint64_t nameSize;
   uint64_t offset;
@@ -129,6 +142,57 @@ uint8_t const* findAttrName(uint8_t const* base, uint64_t& len) {
   return findAttrName(arangodb::velocypack::Slice(base).makeKey().start(), len);
 }
 
+// index tables with at least this many entries are radix sorted
+constexpr std::size_t radixSortEntriesCutoff = 256;
+
+// return true iff a < b
+bool sortEntryLess(SortEntry const& a, SortEntry const& b) noexcept {
+  if (a.prefix != b.prefix) {
+    return a.prefix < b.prefix;
+  }
+  // the first min(8, sizea, sizeb) bytes are equal
+  uint64_t sizea = a.nameSize;
+  uint64_t sizeb = b.nameSize;
+  uint64_t const compareLength = (std::min)(sizea, sizeb);
+  if (compareLength > 8) {
+    int res = std::memcmp(a.nameStart + 8, b.nameStart + 8,
+                          static_cast<std::size_t>(compareLength - 8));
+    if (res != 0) {
+      return res < 0;
+    }
+  }
+  return sizea < sizeb;
+}
+
+// fills entries with the names at the offsets. returns true if the
+// names are in sorted order already
+bool fillSortEntries(uint8_t const* objBase, ValueLength const* offsets,
+                     std::size_t n, SortEntry* entries) {
+  bool sorted = true;
+  for (std::size_t i = 0; i < n; i++) {
+    SortEntry& e = entries[i];
+    e.offset = offsets[i];
+    e.nameStart = findAttrName(objBase + e.offset, e.nameSize);
+    e.prefix = radixPrefixKey(e.nameStart, static_cast<std::size_t>(e.nameSize));
+    if (sorted && i > 0 && sortEntryLess(e, entries[i - 1])) {
+      sorted = false;
+    }
+  }
+  return sorted;
+}
+
+void insertionSort(SortEntry* entries, std::size_t n) noexcept {
+  for (std::size_t i = 1; i < n; i++) {
+    SortEntry e = entries[i];
+    std::size_t j = i;
+    while (j > 0 && sortEntryLess(e, entries[j - 1])) {
+      entries[j] = entries[j - 1];
+      --j;
+    }
+    entries[j] = e;
+  }
+}
+
 bool checkAttributeUniquenessUnsortedBrute(ObjectIterator& it) {
   std::array<std::string_view, linearAttributeUniquenessCutoff> keys;
 
@@ -262,6 +326,26 @@ Builder::Builder(Slice slice, Options const* options)
   add(slice);
 }
 
+Builder::Builder(std::pmr::memory_resource* resource, Options const* opts)
+      : _buffer(std::allocate_shared<Buffer<uint8_t>>(
+            std::pmr::polymorphic_allocator<Buffer<uint8_t>>(checkResource(resource)),
+            resource)),
+        _bufferPtr(_buffer.get()),
+        _start(_bufferPtr->data()),
+        _pos(0),
+        _arena(),
+        _stack(_arena),
+        _indexes(resource),
+        _normalizedHashes(resource),
+        _keyWritten(false),
+        options(opts) {
+  if (VELOCYPACK_UNLIKELY(opts == nullptr)) {
+    throw Exception(Exception::InternalError, "Options cannot be a nullptr");
+  }
+  // do a full initial allocation in the arena, so we can maximize its usage
+  _stack.reserve(arenaSize / sizeof(decltype(_stack)::value_type));
+}
+
 Builder::Builder(Builder const& that)
       : _bufferPtr(nullptr),
         _start(nullptr),
@@ -269,6 +353,7 @@ Builder::Builder(Builder const& that)
         _arena(),
         _stack(_arena),
         _indexes(that._indexes),
+        _normalizedHashes(that._normalizedHashes),
         _keyWritten(that._keyWritten),
         options(that.options) {
   VELOCYPACK_ASSERT(options != nullptr);
@@ -307,6 +392,7 @@ Builder& Builder::operator=(Builder const& that) {
     _pos = that._pos;
     _stack = that._stack;
     _indexes = that._indexes;
+    _normalizedHashes = that._normalizedHashes;
     _keyWritten = that._keyWritten;
     options = that.options;
   }
@@ -322,6 +408,7 @@ Builder::Builder(Builder&& that) noexcept
       _arena(),
       _stack(_arena),
       _indexes(std::move(that._indexes)),
+      _normalizedHashes(std::move(that._normalizedHashes)),
       _keyWritten(that._keyWritten),
       options(that.options) {
       
@@ -342,8 +429,13 @@ Builder::Builder(Builder&& that) noexcept
   that.clear();
 }
 
-Builder& Builder::operator=(Builder&& that) noexcept {
+Builder& Builder::operator=(Builder&& that) {
   if (this != &that) {
+    // the index tables only take over the memory of that if both use the
+    // same memory resource, and are copied otherwise. this can throw, so
+    // it is done before anything else is modified
+    _indexes = std::move(that._indexes);
+    _normalizedHashes = std::move(that._normalizedHashes);
     _buffer = std::move(that._buffer);
     if (_buffer != nullptr) {
       _bufferPtr = _buffer.get();
@@ -359,7 +451,6 @@ Builder& Builder::operator=(Builder&& that) noexcept {
     // do a full initial allocation in the arena, so we can maximize its usage
     _stack.reserve(arenaSize / sizeof(decltype(_stack)::value_type));
     _stack = std::move(that._stack);
-    _indexes = std::move(that._indexes);
     _keyWritten = that._keyWritten;
     options = that.options;
     VELOCYPACK_ASSERT(that._buffer == nullptr);
@@ -373,45 +464,34 @@ std::string Builder::toString() const {
   Options opts;
   opts.prettyPrint = true;
 
-  std::string buffer;
-  StringSink sink(&buffer);
-  Dumper::dump(slice(), &sink, &opts);
-  return buffer;
+  return Dumper::toString(slice(), &opts);
 }
 
 std::string Builder::toJson() const {
-  std::string buffer;
-  StringSink sink(&buffer);
-  Dumper::dump(slice(), &sink);
-  return buffer;
+  return Dumper::toString(slice());
 }
   
 void Builder::sortObjectIndexShort(uint8_t* objBase,
-                                   std::vector<ValueLength>::iterator indexStart,
-                                   std::vector<ValueLength>::iterator indexEnd) const {
-  std::sort(indexStart, indexEnd, [objBase](ValueLength const& a, ValueLength const& b) {
-    uint8_t const* aa = objBase + a;
-    uint8_t const* bb = objBase + b;
-    if (*aa >= 0x40 && *aa <= 0xbe && *bb >= 0x40 && *bb <= 0xbe) {
-      // The fast path, short strings:
-      uint8_t m = (std::min)(*aa - 0x40, *bb - 0x40);
-      int c = std::memcmp(aa + 1, bb + 1, checkOverflow(m));
-      return (c < 0 || (c == 0 && *aa < *bb));
-    } else {
-      uint64_t lena;
-      uint64_t lenb;
-      aa = findAttrName(aa, lena);
-      bb = findAttrName(bb, lenb);
-      uint64_t m = (std::min)(lena, lenb);
-      int c = std::memcmp(aa, bb, checkOverflow(m));
-      return (c < 0 || (c == 0 && lena < lenb));
-    }
-  });
+                                   std::pmr::vector<ValueLength>::iterator indexStart,
+                                   std::pmr::vector<ValueLength>::iterator indexEnd) const {
+  std::size_t const n = std::distance(indexStart, indexEnd);
+  VELOCYPACK_ASSERT(n <= 32);
+  std::array<SortEntry, 32> entries;
+  if (::fillSortEntries(objBase, &*indexStart, n, entries.data())) {
+    // keys were added in sorted order
+    return;
+  }
+  ::insertionSort(entries.data(), n);
+
+  // copy back the sorted offsets
+  for (std::size_t i = 0; i < n; i++) {
+    indexStart[i] = entries[i].offset;
+  }
 }
 
 void Builder::sortObjectIndexLong(uint8_t* objBase,
-                                  std::vector<ValueLength>::iterator indexStart,
-                                  std::vector<ValueLength>::iterator indexEnd) const {
+                                  std::pmr::vector<ValueLength>::iterator indexStart,
+                                  std::pmr::vector<ValueLength>::iterator indexEnd) const {
 #ifndef VELOCYPACK_NO_THREADLOCALS
   std::unique_ptr<std::vector<SortEntry>>& tmp = ::sortEntries;
 
@@ -428,32 +508,26 @@ void Builder::sortObjectIndexLong(uint8_t* objBase,
 
   std::size_t const n = std::distance(indexStart, indexEnd);
   VELOCYPACK_ASSERT(n > 1);
-  tmp->reserve(std::max(::minSortEntriesAllocation, n));
-  for (std::size_t i = 0; i < n; i++) {
-    SortEntry e;
-    e.offset = indexStart[i];
-    e.nameStart = ::findAttrName(objBase + e.offset, e.nameSize);
-    tmp->push_back(e);
-  }
-  VELOCYPACK_ASSERT(tmp->size() == n);
-  std::sort(tmp->begin(), tmp->end(), [](SortEntry const& a,
-                                         SortEntry const& b)
-#ifdef VELOCYPACK_64BIT
-    noexcept
-#endif
-  {
-    // return true iff a < b:
-    uint64_t sizea = a.nameSize;
-    uint64_t sizeb = b.nameSize;
-    std::size_t const compareLength = checkOverflow((std::min)(sizea, sizeb));
-    int res = std::memcmp(a.nameStart, b.nameStart, compareLength);
-
-    return (res < 0 || (res == 0 && sizea < sizeb));
-  });
+  // the second half is scratch space for the radix sort
+  std::size_t const size = (n >= ::radixSortEntriesCutoff ? 2 * n : n);
+  tmp->reserve(std::max(::minSortEntriesAllocation, size));
+  tmp->resize(size);
+  SortEntry* entries = tmp->data();
+  if (::fillSortEntries(objBase, &*indexStart, n, entries)) {
+    // keys were added in sorted order
+    return;
+  }
+  if (n >= ::radixSortEntriesCutoff) {
+    // names with equal prefixes are sorted by comparison afterwards
+    radixSort(entries, entries + n, n,
+              [](SortEntry const& e) { return e.prefix; }, ::sortEntryLess);
+  } else {
+    std::sort(entries, entries + n, ::sortEntryLess);
+  }
 
   // copy back the sorted offsets
   for (std::size_t i = 0; i < n; i++) {
-    indexStart[i] = (*tmp)[i].offset;
+    indexStart[i] = entries[i].offset;
   }
 }
 
@@ -467,8 +541,8 @@ Builder& Builder::closeEmptyArrayOrObject(ValueLength pos, bool isArray) {
 }
 
 bool Builder::closeCompactArrayOrObject(ValueLength pos, bool isArray,
-                                        std::vector<ValueLength>::iterator indexStart,
-                                        std::vector<ValueLength>::iterator indexEnd) {
+                                        std::pmr::vector<ValueLength>::iterator indexStart,
+                                        std::pmr::vector<ValueLength>::iterator indexEnd) {
   std::size_t const n = std::distance(indexStart, indexEnd);
 
   // use compact notation
@@ -515,9 +589,84 @@ bool Builder::closeCompactArrayOrObject(ValueLength pos, bool isArray,
   return false;
 }
 
+bool Builder::closeHashIndexedObject(ValueLength pos,
+                                     std::pmr::vector<ValueLength>::iterator indexStart,
+                                     std::pmr::vector<ValueLength>::iterator indexEnd) {
+  ValueLength const n = std::distance(indexStart, indexEnd);
+  if (n > hashIndexMaxMembers) {
+    return false;
+  }
+
+  // the hash table can only cover string keys
+  for (ValueLength i = 0; i < n; ++i) {
+    if (!Slice(_start + pos + indexStart[i]).isString()) {
+      return false;
+    }
+  }
+
+  ValueLength const slots = hashIndexSlots(n);
+  if (_pos - pos + 4 * slots + 4 * n > 0xffffffffu) {
+    return false;
+  }
+
+  // the 9 bytes for head, byte length and number of members were already
+  // reserved, so no data needs to be moved
+  _start[pos] = 0x15;
+
+  if (n >= 2) {
+    sortObjectIndex(_start + pos, indexStart, indexEnd);
+  }
+
+  // hash table, followed by the index table
+  reserve(4 * slots + 4 * n);
+  ValueLength const hashTableBase = _pos;
+  ValueLength const tableBase = _pos + 4 * slots;
+  advance(4 * slots + 4 * n);
+  std::memset(_start + hashTableBase, 0, checkOverflow(4 * slots));
+
+  for (ValueLength i = 0; i < n; ++i) {
+    Slice key(_start + pos + indexStart[i]);
+    ValueLength len;
+    char const* p = key.getStringUnchecked(len);
+    uint64_t const hash = hashIndexKey(p, len);
+
+    // linear probing for a free slot
+    ValueLength slot = hash & (slots - 1);
+    while (readIntegerFixed<uint32_t, 4>(_start + hashTableBase + 4 * slot) != 0) {
+      slot = (slot + 1) & (slots - 1);
+    }
+    uint32_t x = hashIndexEntry(hash, i);
+    for (std::size_t j = 0; j < 4; ++j) {
+      _start[hashTableBase + 4 * slot + j] = x & 0xff;
+      x >>= 8;
+    }
+
+    ValueLength y = indexStart[i];
+    for (std::size_t j = 0; j < 4; ++j) {
+      _start[tableBase + 4 * i + j] = y & 0xff;
+      y >>= 8;
+    }
+  }
+
+  // Fix the byte length and the number of members in the beginning:
+  ValueLength x = _pos - pos;
+  for (unsigned int i = 1; i <= 4; i++) {
+    _start[pos + i] = x & 0xff;
+    x >>= 8;
+  }
+  x = n;
+  for (unsigned int i = 5; i <= 8; i++) {
+    _start[pos + i] = x & 0xff;
+    x >>= 8;
+  }
+
+  closeLevel();
+  return true;
+}
+
 Builder& Builder::closeArray(ValueLength pos, 
-                             std::vector<ValueLength>::iterator indexStart,
-                             std::vector<ValueLength>::iterator indexEnd) {
+                             std::pmr::vector<ValueLength>::iterator indexStart,
+                             std::pmr::vector<ValueLength>::iterator indexEnd) {
   std::size_t const n = std::distance(indexStart, indexEnd);
   VELOCYPACK_ASSERT(n > 0);
 
@@ -667,17 +816,81 @@ Builder& Builder::close() {
     throw Exception(Exception::BuilderNeedOpenCompound);
   }
   VELOCYPACK_ASSERT(!_stack.empty());
+  ValueLength const pos = _stack.back().startPos;
+  closeCompound();
+
+  // only cache hashes once the outermost value is sealed. closing an outer
+  // compound may still move its members around
+  if (VELOCYPACK_UNLIKELY(options->normalizedHashCacheThreshold > 0) &&
+      _stack.empty()) {
+    std::size_t const first = _normalizedHashes.size();
+    cacheNormalizedHashes(Slice(_start + pos));
+    // Object members may have been visited in index order
+    std::sort(_normalizedHashes.begin() + first, _normalizedHashes.end());
+  }
+  return *this;
+}
+
+void Builder::cacheNormalizedHashes(Slice slice) {
+  if (slice.byteSize() < options->normalizedHashCacheThreshold) {
+    // members are even smaller
+    return;
+  }
+  _normalizedHashes.emplace_back(slice.start() - _start, slice.normalizedHash());
+  if (slice.isArray()) {
+    for (auto it : ArrayIterator(slice)) {
+      if (it.isArray() || it.isObject()) {
+        cacheNormalizedHashes(it);
+      }
+    }
+  } else {
+    VELOCYPACK_ASSERT(slice.isObject());
+    for (auto it : ObjectIterator(slice, true)) {
+      if (it.value.isArray() || it.value.isObject()) {
+        cacheNormalizedHashes(it.value);
+      }
+    }
+  }
+}
+
+uint64_t Builder::normalizedHash(Slice slice) const {
+  if (!_normalizedHashes.empty() && _start != nullptr &&
+      slice.start() >= _start && slice.start() < _start + _pos) {
+    ValueLength const offset = slice.start() - _start;
+    auto it = std::lower_bound(
+        _normalizedHashes.begin(), _normalizedHashes.end(), offset,
+        [](std::pair<ValueLength, uint64_t> const& entry, ValueLength offset) {
+          return entry.first < offset;
+        });
+    if (it != _normalizedHashes.end() && it->first == offset) {
+      return it->second;
+    }
+  }
+  return slice.normalizedHash();
+}
+
+Builder& Builder::closeCompound() {
   ValueLength const pos = _stack.back().startPos;
   ValueLength const indexStartPos = _stack.back().indexStartPos;
+  ObjectShape const* shape = _stack.back().shape;
+  std::pmr::vector<ValueLength>::iterator indexStart = _indexes.begin() + indexStartPos; 
+  std::pmr::vector<ValueLength>::iterator indexEnd = _indexes.end();
+  ValueLength const n = std::distance(indexStart, indexEnd);
+
+  if (VELOCYPACK_UNLIKELY(shape != nullptr)) {
+    if (n != shape->size()) {
+      throw Exception(Exception::BuilderShapeMismatch);
+    }
+    // the Object was built like an Array so far
+    _start[pos] = 0x0b;
+  }
+
   uint8_t const head = _start[pos];
 
   VELOCYPACK_ASSERT(head == 0x06 || head == 0x0b || head == 0x13 ||
                     head == 0x14);
 
   bool const isArray = (head == 0x06 || head == 0x13);
-  std::vector<ValueLength>::iterator indexStart = _indexes.begin() + indexStartPos; 
-  std::vector<ValueLength>::iterator indexEnd = _indexes.end();
-  ValueLength const n = std::distance(indexStart, indexEnd);
 
   if (n == 0) {
     closeEmptyArrayOrObject(pos, isArray);
@@ -711,6 +924,19 @@ Builder& Builder::close() {
 
   // from here on we are sure that we are dealing with Object types only.
 
+  if (options->buildHashIndexedObjectsThreshold > 0 &&
+      n >= options->buildHashIndexedObjectsThreshold &&
+      closeHashIndexedObject(pos, indexStart, indexEnd)) {
+    // And, if desired, check attribute uniqueness:
+    if (options->checkAttributeUniqueness &&
+        n > 1 &&
+        !checkAttributeUniqueness(Slice(_start + pos))) {
+      // duplicate attribute name!
+      throw Exception(Exception::DuplicateAttributeName);
+    }
+    return *this;
+  }
+
   // fix head byte in case a compact Array / Object was originally requested
   _start[pos] = 0x0b;
 
@@ -754,14 +980,25 @@ Builder& Builder::close() {
   ValueLength tableBase = _pos;
   advance(offsetSize * n);
   // Object
-  if (n >= 2) {
-    sortObjectIndex(_start + pos, indexStart, indexEnd);
-  }
-  for (std::size_t i = 0; i < n; ++i) {
-    uint64_t x = indexStart[i];
-    for (std::size_t j = 0; j < offsetSize; ++j) {
-      _start[tableBase + offsetSize * i + j] = x & 0xff;
-      x >>= 8;
+  if (VELOCYPACK_UNLIKELY(shape != nullptr)) {
+    // the shape knows the sorted order of its keys already
+    for (std::size_t i = 0; i < n; ++i) {
+      uint64_t x = indexStart[shape->_order[i]];
+      for (std::size_t j = 0; j < offsetSize; ++j) {
+        _start[tableBase + offsetSize * i + j] = x & 0xff;
+        x >>= 8;
+      }
+    }
+  } else {
+    if (n >= 2) {
+      sortObjectIndex(_start + pos, indexStart, indexEnd);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      uint64_t x = indexStart[i];
+      for (std::size_t j = 0; j < offsetSize; ++j) {
+        _start[tableBase + offsetSize * i + j] = x & 0xff;
+        x >>= 8;
+      }
     }
   }
   // Finally fix the byte width in the type byte:
@@ -792,8 +1029,10 @@ Builder& Builder::close() {
     }
   }
 
-  // And, if desired, check attribute uniqueness:
+  // And, if desired, check attribute uniqueness. the names of a shape
+  // are unique already:
   if (options->checkAttributeUniqueness && 
+      shape == nullptr &&
       n > 1 &&
       !checkAttributeUniqueness(Slice(_start + pos))) {
     // duplicate attribute name!
@@ -820,11 +1059,12 @@ Slice Builder::getKey(std::string_view key) const {
   VELOCYPACK_ASSERT(!_stack.empty());
   ValueLength const pos = _stack.back().startPos;
   ValueLength const indexStartPos = _stack.back().indexStartPos;
-  if (VELOCYPACK_UNLIKELY(_start[pos] != 0x0b && _start[pos] != 0x14)) {
+  if (VELOCYPACK_UNLIKELY(_start[pos] != 0x0b && _start[pos] != 0x14 &&
+                          _stack.back().shape == nullptr)) {
     throw Exception(Exception::BuilderNeedOpenObject);
   }
-  std::vector<ValueLength>::const_iterator indexStart = _indexes.begin() + indexStartPos;
-  std::vector<ValueLength>::const_iterator indexEnd = _indexes.end();
+  std::pmr::vector<ValueLength>::const_iterator indexStart = _indexes.begin() + indexStartPos;
+  std::pmr::vector<ValueLength>::const_iterator indexEnd = _indexes.end();
   while (indexStart != indexEnd) {
     Slice s(_start + pos + *indexStart);
     if (s.makeKey().isEqualString(key)) {
@@ -1182,6 +1422,10 @@ uint8_t* Builder::set(ValuePair const& pair) {
 void Builder::cleanupAdd() noexcept {
   VELOCYPACK_ASSERT(!_stack.empty());
   VELOCYPACK_ASSERT(!_indexes.empty());
+  if (VELOCYPACK_UNLIKELY(_stack.back().shape != nullptr)) {
+    // remove the key that reportAdd wrote
+    resetTo(_stack.back().startPos + _indexes.back());
+  }
   _indexes.pop_back();
 }
 
@@ -1193,9 +1437,41 @@ void Builder::reportAdd() {
     // the first few attributes
     _indexes.reserve(8);
   }
+  if (VELOCYPACK_UNLIKELY(_stack.back().shape != nullptr)) {
+    reportAddShaped();
+    return;
+  }
   _indexes.push_back(_pos - _stack.back().startPos);
 }
 
+void Builder::reportAddShaped() {
+  CompoundInfo const& tos = _stack.back();
+  ValueLength const field = _indexes.size() - tos.indexStartPos;
+  if (VELOCYPACK_UNLIKELY(field >= tos.shape->size())) {
+    throw Exception(Exception::BuilderShapeMismatch);
+  }
+  // write the key of the next attribute
+  ValueLength length;
+  uint8_t const* key = tos.shape->key(field, length);
+  reserve(length);
+  _indexes.push_back(_pos - tos.startPos);
+  memcpy(_start + _pos, key, checkOverflow(length));
+  advance(length);
+}
+
+void Builder::openObject(ObjectShape const& shape) {
+  if (VELOCYPACK_UNLIKELY(shape.attributeTranslator() !=
+                          options->attributeTranslator)) {
+    // the keys of the shape could not be resolved with our translator
+    throw Exception(Exception::BuilderShapeMismatch,
+                    "ObjectShape uses a different AttributeTranslator");
+  }
+  // the Object is built like an Array of values until it is closed, so
+  // that the values can be added without keys
+  openCompoundValue(0x06);
+  _stack.back().shape = &shape;
+}
+
 
 void Builder::closeLevel() noexcept {
   VELOCYPACK_ASSERT(!_stack.empty());
@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/BulkParser.h"
+#include "velocypack/Parser.h"
+#include "parallel.h"
+
+using namespace arangodb::velocypack;
+
+BulkParser::BulkParser(Options const* options, std::size_t concurrency)
+    : _concurrency(concurrency), _errorPos(0), options(options) {
+  if (VELOCYPACK_UNLIKELY(options == nullptr)) {
+    throw Exception(Exception::InternalError, "Options cannot be a nullptr");
+  }
+  _concurrency = resolveConcurrency(_concurrency);
+}
+
+void BulkParser::clear() {
+  for (auto& shard : _shards) {
+    shard.builder->clear();
+    shard.documents.clear();
+    shard.error = nullptr;
+  }
+  _documents.clear();
+  _errorPos = 0;
+}
+
+ValueLength BulkParser::parse(uint8_t const* start, std::size_t size) {
+  clear();
+  split(start, size);
+
+  // errors are recorded per shard, so that the first one in the input
+  // can be reported together with its position
+  runParallel(_shards.size(),
+              [this, start](std::size_t i) { parseShard(start, _shards[i]); });
+
+  std::size_t count = 0;
+  for (auto const& shard : _shards) {
+    if (shard.error != nullptr) {
+      // report the first error in the input
+      _errorPos = shard.errorPos;
+      std::rethrow_exception(shard.error);
+    }
+    count += shard.documents.size();
+  }
+
+  _documents.reserve(count);
+  for (auto const& shard : _shards) {
+    _documents.insert(_documents.end(), shard.documents.begin(),
+                      shard.documents.end());
+  }
+  return _documents.size();
+}
+
+ValueLength BulkParser::concatenate(Buffer<uint8_t>& buffer,
+                                    std::vector<ValueLength>& offsets) const {
+  ValueLength total = 0;
+  for (auto const& shard : _shards) {
+    if (!shard.documents.empty()) {
+      total += shard.builder->size();
+    }
+  }
+
+  buffer.clear();
+  buffer.reserve(total);
+  offsets.clear();
+  offsets.reserve(_documents.size());
+  for (auto const& shard : _shards) {
+    if (shard.documents.empty()) {
+      continue;
+    }
+    uint8_t const* data = shard.builder->data();
+    ValueLength const base = buffer.size();
+    for (auto const* document : shard.documents) {
+      offsets.push_back(base + static_cast<ValueLength>(document - data));
+    }
+    buffer.append(data, shard.builder->size());
+  }
+  return total;
+}
+
+void BulkParser::split(uint8_t const* start, std::size_t size) {
+  std::size_t n = size / minShardSize;
+  if (n > _concurrency) {
+    n = _concurrency;
+  } else if (n == 0) {
+    n = 1;
+  }
+
+  std::size_t const previous = _shards.size();
+  _shards.resize(n);
+  for (std::size_t i = previous; i < n; ++i) {
+    _shards[i].builder = std::make_shared<Builder>(options);
+  }
+
+  // every shard but the last ends behind the first line break at or
+  // after its nominal end. shards can be empty if a line is longer than
+  // a shard
+  std::size_t begin = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    std::size_t end = size;
+    if (i + 1 < n) {
+      end = (std::max)(begin, (size / n) * (i + 1));
+      void const* p = memchr(start + end, '\n', size - end);
+      end = (p == nullptr) ? size
+                           : static_cast<std::size_t>(
+                                 static_cast<uint8_t const*>(p) - start) + 1;
+    }
+    _shards[i].begin = begin;
+    _shards[i].end = end;
+    begin = end;
+  }
+}
+
+void BulkParser::parseShard(uint8_t const* start, Shard& shard) {
+  shard.errorPos = shard.begin;
+  try {
+    // every line is parsed on its own, so that the result does not depend
+    // on where the shard boundaries are. the lines are appended to the
+    // shard's Builder, which must not be cleared between them
+    Options lineOptions = *options;
+    lineOptions.clearBuilderBeforeParse = false;
+    Parser parser(shard.builder, &lineOptions);
+
+    std::size_t begin = shard.begin;
+    while (begin < shard.end) {
+      void const* p = memchr(start + begin, '\n', shard.end - begin);
+      std::size_t const end =
+          (p == nullptr)
+              ? shard.end
+              : static_cast<std::size_t>(static_cast<uint8_t const*>(p) - start);
+
+      // Parser::parse() throws on input that consists of whitespace only
+      while (begin < end && (start[begin] == ' ' || start[begin] == '\t' ||
+                             start[begin] == '\r')) {
+        ++begin;
+      }
+      if (begin < end) {
+        try {
+          parser.parse(start + begin, end - begin, true);
+        } catch (...) {
+          shard.errorPos = begin + parser.errorPos();
+          throw;
+        }
+      }
+      begin = end + 1;
+    }
+
+    uint8_t const* p = shard.builder->data();
+    uint8_t const* end = p + shard.builder->size();
+    while (p < end) {
+      shard.documents.push_back(p);
+      p += Slice(p).byteSize();
+    }
+  } catch (...) {
+    shard.documents.clear();
+    shard.error = std::current_exception();
+  }
+}
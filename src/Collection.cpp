@@ -22,16 +22,23 @@
 /// @author Jan Steemann
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 
 #include "velocypack/velocypack-common.h"
 #include "velocypack/Collection.h"
+#include "velocypack/Compare.h"
 #include "velocypack/Iterator.h"
 #include "velocypack/Slice.h"
 #include "velocypack/Value.h"
 #include "velocypack/ValueType.h"
+#include "parallel.h"
+#include "radix-sort.h"
 
 using namespace arangodb::velocypack;
 
@@ -513,25 +520,379 @@ void Collection::visitRecursive(
   }
 }
 
-Builder Collection::sort(
-      Slice const& array,
-      std::function<bool (Slice const&, Slice const&)> lessthan) {
+namespace {
+
+// arrays with fewer members are sorted on a single thread
+constexpr std::size_t minParallelSortSize = 16384;
+
+// collects the members of an Array with a single iteration
+std::vector<Slice> arrayMembers(Slice array) {
   if (!array.isArray()) {
     throw Exception(Exception::InvalidValueType, "Expecting type Array");
   }
-  std::vector<Slice> subValues;
-  ValueLength len = array.length();
-  subValues.reserve(checkOverflow(len));
-  for (ValueLength i = 0; i < len; i++) {
-    subValues.push_back(array[i]);
+  ArrayIterator it(array);
+  std::vector<Slice> members;
+  members.reserve(checkOverflow(it.size()));
+  while (it.valid()) {
+    members.push_back(it.value());
+    it.next();
+  }
+  return members;
+}
+
+// builds an Array from the members, reserving all memory up front
+Builder buildArray(std::vector<Slice> const& members) {
+  // head byte, byte length, number of members, and one index table entry
+  // per member at most
+  ValueLength size = 1 + 8 + 8;
+  for (auto const& s : members) {
+    size += s.byteSize() + 8;
   }
-  std::sort(subValues.begin(), subValues.end(), lessthan);
   Builder b;
+  b.reserve(checkOverflow(size));
   b.openArray();
-  for (auto const&s : subValues) {
+  for (auto const& s : members) {
     b.add(s);
   }
   b.close();
   return b;
 }
 
+// sorts chunks of the values on multiple threads, and then merges
+// pairs of sorted chunks until a single one is left
+template<typename Less>
+void parallelSort(std::vector<Slice>& values, Less const& lessthan,
+                  std::size_t concurrency) {
+  concurrency = resolveConcurrency(concurrency);
+  std::size_t const n = values.size();
+  std::size_t const chunks = (std::min)(concurrency, n / (minParallelSortSize / 2));
+  if (chunks <= 1) {
+    std::sort(values.begin(), values.end(), lessthan);
+    return;
+  }
+
+  std::vector<std::size_t> bounds;
+  for (std::size_t i = 0; i <= chunks; ++i) {
+    bounds.push_back(n / chunks * i + (std::min)(i, n % chunks));
+  }
+
+  auto begin = values.begin();
+  runParallel(chunks, [&](std::size_t i) {
+    std::sort(begin + bounds[i], begin + bounds[i + 1], lessthan);
+  });
+
+  while (bounds.size() > 2) {
+    runParallel((bounds.size() - 1) / 2, [&](std::size_t i) {
+      std::inplace_merge(begin + bounds[2 * i], begin + bounds[2 * i + 1],
+                         begin + bounds[2 * i + 2], lessthan);
+    });
+    std::vector<std::size_t> merged;
+    for (std::size_t i = 0; i < bounds.size(); i += 2) {
+      merged.push_back(bounds[i]);
+    }
+    if (merged.back() != n) {
+      merged.push_back(n);
+    }
+    bounds = std::move(merged);
+  }
+}
+
+// a value and an unsigned integer that sorts the same way
+struct RadixItem {
+  uint64_t key;
+  Slice value;
+};
+
+constexpr uint64_t signBit = uint64_t(1) << 63;
+
+// radix sort keys of integers. unsigned values beyond the int64_t range
+// have no key
+bool integerKey(Slice s, uint64_t& key) {
+  if (s.isUInt()) {
+    uint64_t value = s.getUInt();
+    if (value >= signBit) {
+      return false;
+    }
+    key = value | signBit;
+  } else {
+    key = static_cast<uint64_t>(s.getInt()) ^ signBit;
+  }
+  return true;
+}
+
+// radix sort key of a double. NaN sorts first and -0.0 equals 0.0, the
+// same as in NormalizedCompare
+uint64_t doubleKey(double value) {
+  if (std::isnan(value)) {
+    return 0;
+  }
+  if (value == 0.0) {
+    value = 0.0;
+  }
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits & signBit) ? ~bits : (bits | signBit);
+}
+
+// radix sort key of a string: its first 8 bytes. strings with the same
+// prefix are sorted again afterwards
+uint64_t stringKey(std::string_view value) {
+  return radixPrefixKey(reinterpret_cast<uint8_t const*>(value.data()),
+                        value.size());
+}
+
+// sorts the values with a radix sort if all of them are integers,
+// doubles or strings. returns false if the values are of other types
+bool radixSortValues(std::vector<Slice>& values) {
+  if (values.empty()) {
+    return true;
+  }
+  // integers and doubles can only be mixed with exact comparisons
+  auto category = [](Slice value) {
+    ValueType type = value.type();
+    if (type == ValueType::SmallInt || type == ValueType::UInt) {
+      return ValueType::Int;
+    }
+    return type;
+  };
+
+  std::vector<RadixItem> items;
+  items.reserve(values.size());
+  ValueType const type = category(values[0].resolveExternals().value());
+  for (auto const& s : values) {
+    Slice value = s.resolveExternals().value();
+    if (category(value) != type) {
+      return false;
+    }
+    uint64_t key;
+    switch (type) {
+      case ValueType::Int:
+        if (!integerKey(value, key)) {
+          return false;
+        }
+        break;
+      case ValueType::Double:
+        key = doubleKey(value.getDouble());
+        break;
+      case ValueType::String:
+        key = stringKey(value.stringView());
+        break;
+      default:
+        return false;
+    }
+    items.push_back(RadixItem{key, s});
+  }
+
+  std::vector<RadixItem> buffer(items.size());
+  auto key = [](RadixItem const& item) { return item.key; };
+  if (type == ValueType::String) {
+    // strings that start with the same 8 bytes are sorted by comparison
+    radixSort(items.data(), buffer.data(), items.size(), key,
+              [](RadixItem const& lhs, RadixItem const& rhs) {
+                return NormalizedCompare::compare(lhs.value, rhs.value) < 0;
+              });
+  } else {
+    radixSort(items.data(), buffer.data(), items.size(), key);
+  }
+
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    values[i] = items[i].value;
+  }
+  return true;
+}
+
+// open addressing hash set of Slices, sized once for a known maximum
+// number of values
+template<typename Hash, typename Equal>
+class SliceSet {
+ public:
+  explicit SliceSet(std::size_t n) {
+    std::size_t size = 16;
+    while (size < 2 * n) {
+      size *= 2;
+    }
+    _slots.resize(size);
+    _mask = size - 1;
+  }
+
+  // returns false if an equal value is in the set already
+  bool insert(Slice value) {
+    uint64_t const hash = Hash()(value);
+    Slot* slot = find(value, hash);
+    if (slot->value != nullptr) {
+      return false;
+    }
+    slot->hash = hash;
+    slot->value = value.start();
+    return true;
+  }
+
+  bool contains(Slice value) {
+    return find(value, Hash()(value))->value != nullptr;
+  }
+
+ private:
+  struct Slot {
+    uint64_t hash = 0;
+    // nullptr for an empty slot
+    uint8_t const* value = nullptr;
+  };
+
+  // returns the slot with an equal value, or the empty slot to put it in
+  Slot* find(Slice value, uint64_t hash) {
+    std::size_t i = static_cast<std::size_t>(hash) & _mask;
+    while (true) {
+      Slot& slot = _slots[i];
+      if (slot.value == nullptr ||
+          (slot.hash == hash && Equal()(Slice(slot.value), value))) {
+        return &slot;
+      }
+      i = (i + 1) & _mask;
+    }
+  }
+
+  std::vector<Slot> _slots;
+  std::size_t _mask;
+};
+
+enum class SetOperation { Unique, Intersect, Union, Difference };
+
+template<typename Hash, typename Equal>
+std::vector<Slice> hashSetOperation(SetOperation operation,
+                                    std::vector<Slice> const& left,
+                                    std::vector<Slice> const& right) {
+  std::vector<Slice> result;
+  // values already in the result
+  SliceSet<Hash, Equal> seen(left.size() + right.size());
+
+  if (operation == SetOperation::Unique || operation == SetOperation::Union) {
+    for (auto const& s : left) {
+      if (seen.insert(s)) {
+        result.push_back(s);
+      }
+    }
+    for (auto const& s : right) {
+      if (seen.insert(s)) {
+        result.push_back(s);
+      }
+    }
+    return result;
+  }
+
+  SliceSet<Hash, Equal> other(right.size());
+  for (auto const& s : right) {
+    other.insert(s);
+  }
+  bool const wanted = (operation == SetOperation::Intersect);
+  for (auto const& s : left) {
+    if (other.contains(s) == wanted && seen.insert(s)) {
+      result.push_back(s);
+    }
+  }
+  return result;
+}
+
+std::vector<Slice> mergeSetOperation(SetOperation operation,
+                                     std::vector<Slice> const& left,
+                                     std::vector<Slice> const& right) {
+  std::vector<Slice> result;
+  // the result is sorted, so duplicates can only follow each other
+  auto emit = [&result](Slice s) {
+    if (result.empty() || NormalizedCompare::compare(result.back(), s) != 0) {
+      result.push_back(s);
+    }
+  };
+
+  std::size_t l = 0;
+  std::size_t r = 0;
+  while (l < left.size() && r < right.size()) {
+    int res = NormalizedCompare::compare(left[l], right[r]);
+    if (res < 0) {
+      if (operation != SetOperation::Intersect) {
+        emit(left[l]);
+      }
+      ++l;
+    } else if (res > 0) {
+      if (operation == SetOperation::Union) {
+        emit(right[r]);
+      }
+      ++r;
+    } else {
+      if (operation != SetOperation::Difference) {
+        emit(left[l]);
+      }
+      ++l;
+    }
+  }
+  if (operation != SetOperation::Intersect) {
+    for (; l < left.size(); ++l) {
+      emit(left[l]);
+    }
+  }
+  if (operation == SetOperation::Union) {
+    for (; r < right.size(); ++r) {
+      emit(right[r]);
+    }
+  }
+  return result;
+}
+
+Builder setOperation(SetOperation operation, Slice left, Slice right,
+                     Collection::SetMode mode) {
+  std::vector<Slice> l = arrayMembers(left);
+  std::vector<Slice> r;
+  if (operation != SetOperation::Unique) {
+    r = arrayMembers(right);
+  }
+
+  switch (mode) {
+    case Collection::BinaryHashing:
+      return buildArray(hashSetOperation<BinaryCompare::Hash, BinaryCompare::Equal>(
+          operation, l, r));
+    case Collection::NormalizedHashing:
+      return buildArray(
+          hashSetOperation<NormalizedCompare::Hash, NormalizedCompare::Equal>(
+              operation, l, r));
+    case Collection::SortedMerge:
+      return buildArray(mergeSetOperation(operation, l, r));
+  }
+  throw Exception(Exception::InvalidValueType, "Invalid set mode");
+}
+
+}  // namespace
+
+Builder Collection::sort(
+      Slice const& array,
+      std::function<bool (Slice const&, Slice const&)> lessthan,
+      std::size_t concurrency) {
+  std::vector<Slice> subValues = arrayMembers(array);
+  parallelSort(subValues, lessthan, concurrency);
+  return buildArray(subValues);
+}
+
+Builder Collection::sort(Slice const& array, std::size_t concurrency) {
+  std::vector<Slice> subValues = arrayMembers(array);
+  if (!radixSortValues(subValues)) {
+    parallelSort(subValues, NormalizedCompare::Less(), concurrency);
+  }
+  return buildArray(subValues);
+}
+
+Builder Collection::unique(Slice const& array, SetMode mode) {
+  return setOperation(SetOperation::Unique, array, Slice(), mode);
+}
+
+Builder Collection::intersect(Slice const& left, Slice const& right,
+                              SetMode mode) {
+  return setOperation(SetOperation::Intersect, left, right, mode);
+}
+
+Builder Collection::unionOf(Slice const& left, Slice const& right,
+                            SetMode mode) {
+  return setOperation(SetOperation::Union, left, right, mode);
+}
+
+Builder Collection::difference(Slice const& left, Slice const& right,
+                               SetMode mode) {
+  return setOperation(SetOperation::Difference, left, right, mode);
+}
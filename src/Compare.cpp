@@ -23,17 +23,270 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "velocypack/Compare.h"
-#include "velocypack/Collection.h"
 #include "velocypack/Exception.h"
 #include "velocypack/Iterator.h"
 #include "velocypack/Options.h"
 #include "velocypack/Slice.h"
+#include "velocypack/SmallVector.h"
 #include "velocypack/ValueType.h"
 
-#include <set>
+#include "hash-index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
 
 using namespace arangodb::velocypack;
 
+namespace {
+
+// position of a type in the order of compare(), and its tag in sort keys.
+// 0 is the terminator of Arrays and Objects in sort keys
+enum SortRank : uint8_t {
+  RankMinKey = 1,
+  RankNone,
+  RankIllegal,
+  RankNull,
+  RankBool,
+  RankNumber,
+  RankUTCDate,
+  RankString,
+  RankBinary,
+  RankArray,
+  RankObject,
+  RankMaxKey
+};
+
+SortRank sortRank(Slice slice) {
+  switch (slice.type()) {
+    case ValueType::MinKey:
+      return RankMinKey;
+    case ValueType::None:
+      return RankNone;
+    case ValueType::Illegal:
+      return RankIllegal;
+    case ValueType::Null:
+      return RankNull;
+    case ValueType::Bool:
+      return RankBool;
+    case ValueType::Double:
+    case ValueType::Int:
+    case ValueType::UInt:
+    case ValueType::SmallInt:
+      return RankNumber;
+    case ValueType::UTCDate:
+      return RankUTCDate;
+    case ValueType::String:
+      return RankString;
+    case ValueType::Binary:
+      return RankBinary;
+    case ValueType::Array:
+      return RankArray;
+    case ValueType::Object:
+      return RankObject;
+    case ValueType::MaxKey:
+      return RankMaxKey;
+    case ValueType::Custom:
+      throw Exception(Exception::NotImplemented, "compare for Custom type is not implemented");
+    case ValueType::BCD:
+      throw Exception(Exception::NotImplemented, "compare for BCD type is not implemented");
+    default:
+      throw Exception(Exception::InternalError, "invalid value type for compare");
+  }
+}
+
+// strips Externals and tags
+Slice sortValue(Slice slice) {
+  return slice.resolveExternals().value();
+}
+
+// exact representation of any number. non-zero finite values are
+// 1.fraction * 2^exponent, with the fraction bits left-aligned
+struct NumberKey {
+  enum Kind : uint8_t {
+    NaN = 0,
+    NegativeInfinity,
+    Negative,
+    Zero,
+    Positive,
+    PositiveInfinity
+  };
+
+  Kind kind;
+  int32_t exponent;
+  uint64_t fraction;
+};
+
+NumberKey numberKey(uint64_t magnitude, bool negative) {
+  if (magnitude == 0) {
+    return NumberKey{NumberKey::Zero, 0, 0};
+  }
+  int32_t exponent = 63;
+  while ((magnitude & 0xff00000000000000ULL) == 0) {
+    magnitude <<= 8;
+    exponent -= 8;
+  }
+  while ((magnitude & 0x8000000000000000ULL) == 0) {
+    magnitude <<= 1;
+    --exponent;
+  }
+  return NumberKey{negative ? NumberKey::Negative : NumberKey::Positive,
+                   exponent, magnitude << 1};
+}
+
+NumberKey numberKey(Slice slice) {
+  switch (slice.type()) {
+    case ValueType::UInt:
+      return numberKey(slice.getUIntUnchecked(), false);
+    case ValueType::Int:
+    case ValueType::SmallInt: {
+      int64_t v = slice.getIntUnchecked();
+      if (v < 0) {
+        return numberKey(static_cast<uint64_t>(-(v + 1)) + 1, true);
+      }
+      return numberKey(static_cast<uint64_t>(v), false);
+    }
+    default: {
+      VELOCYPACK_ASSERT(slice.isDouble());
+      double v = slice.getDouble();
+      if (std::isnan(v)) {
+        return NumberKey{NumberKey::NaN, 0, 0};
+      }
+      if (std::isinf(v)) {
+        return NumberKey{v < 0 ? NumberKey::NegativeInfinity : NumberKey::PositiveInfinity, 0, 0};
+      }
+      if (v == 0.0) {
+        return NumberKey{NumberKey::Zero, 0, 0};
+      }
+      int exponent;
+      // mantissa in [0.5, 1), with at most 53 significant bits
+      double mantissa = std::frexp(std::fabs(v), &exponent);
+      NumberKey key = numberKey(static_cast<uint64_t>(std::ldexp(mantissa, 64)), v < 0);
+      key.exponent = exponent - 1;
+      return key;
+    }
+  }
+}
+
+int compareNumbers(Slice lhs, Slice rhs) {
+  NumberKey const l = numberKey(lhs);
+  NumberKey const r = numberKey(rhs);
+  if (l.kind != r.kind) {
+    return l.kind < r.kind ? -1 : 1;
+  }
+  if (l.kind != NumberKey::Positive && l.kind != NumberKey::Negative) {
+    return 0;
+  }
+  int res = 0;
+  if (l.exponent != r.exponent) {
+    res = l.exponent < r.exponent ? -1 : 1;
+  } else if (l.fraction != r.fraction) {
+    res = l.fraction < r.fraction ? -1 : 1;
+  }
+  return l.kind == NumberKey::Negative ? -res : res;
+}
+
+int compareBytes(uint8_t const* l, ValueLength nl, uint8_t const* r, ValueLength nr) {
+  int res = std::memcmp(l, r, static_cast<std::size_t>((std::min)(nl, nr)));
+  if (res != 0) {
+    return res;
+  }
+  return nl == nr ? 0 : (nl < nr ? -1 : 1);
+}
+
+using Member = std::pair<std::string_view, Slice>;
+using MemberList = SmallVector<Member, 16 * sizeof(Member)>;
+
+// all members of an Object, in attribute name order
+void sortedMembers(Slice slice, MemberList& members) {
+  bool const sorted = slice.isSorted();
+  members.reserve(checkOverflow(slice.length()));
+  // sorted Objects are iterated in index table order
+  for (ObjectIterator it(slice, !sorted); it.valid(); it.next()) {
+    Slice key = it.key(false);
+    members.emplace_back(key.makeKey().stringView(),
+                         Slice(key.start() + key.byteSize()));
+  }
+  if (!sorted) {
+    std::sort(members.begin(), members.end(),
+              [](Member const& a, Member const& b) { return a.first < b.first; });
+  }
+}
+
+void appendBigEndian(std::string& out, uint64_t value, std::size_t length) {
+  for (std::size_t i = length; i > 0; --i) {
+    out.push_back(static_cast<char>((value >> (8 * (i - 1))) & 0xff));
+  }
+}
+
+// escapes 0x00 bytes as 0x00 0xff and terminates with 0x00 0x01, so that
+// a byte string sorts before all of its extensions
+void appendBytes(std::string& out, uint8_t const* p, ValueLength length) {
+  uint8_t const* end = p + length;
+  while (p < end) {
+    uint8_t const* zero = static_cast<uint8_t const*>(std::memchr(p, 0, end - p));
+    if (zero == nullptr) {
+      out.append(reinterpret_cast<char const*>(p), end - p);
+      break;
+    }
+    out.append(reinterpret_cast<char const*>(p), zero - p);
+    out.push_back('\x00');
+    out.push_back('\xff');
+    p = zero + 1;
+  }
+  out.push_back('\x00');
+  out.push_back('\x01');
+}
+
+// compares two Objects with n members each, neither of which has a
+// sorted index table. the hash table lives in this function's own stack
+// frame, so that it does not enlarge the frame of every recursion level
+VELOCYPACK_NOINLINE bool equalsUnsortedObjects(Slice lhs, Slice rhs, ValueLength n) {
+  // put the attribute names of rhs into a hash table, which lives on the
+  // stack unless the Objects are big
+  ValueLength slots = 32;
+  while (slots < 2 * n) {
+    slots <<= 1;
+  }
+  ValueLength const mask = slots - 1;
+  SmallVector<uint8_t const*, 256 * sizeof(uint8_t const*)>::allocator_type::arena_type arena;
+  SmallVector<uint8_t const*, 256 * sizeof(uint8_t const*)> table{arena};
+  table.resize(checkOverflow(slots), nullptr);
+
+  for (ObjectIterator it(rhs, true); it.valid(); it.next()) {
+    Slice key = it.key(false);
+    std::string_view name = key.makeKey().stringView();
+    ValueLength slot = hashIndexKey(name.data(), name.size()) & mask;
+    while (table[slot] != nullptr) {
+      slot = (slot + 1) & mask;
+    }
+    table[slot] = key.start();
+  }
+
+  for (ObjectIterator it(lhs, true); it.valid(); it.next()) {
+    std::string_view name = it.key(true).stringView();
+    ValueLength slot = hashIndexKey(name.data(), name.size()) & mask;
+    while (true) {
+      if (table[slot] == nullptr) {
+        return false;
+      }
+      Slice key(table[slot]);
+      if (key.makeKey().stringView() == name) {
+        // recurse
+        if (!NormalizedCompare::equals(it.value(), Slice(key.start() + key.byteSize()))) {
+          return false;
+        }
+        break;
+      }
+      slot = (slot + 1) & mask;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 bool BinaryCompare::equals(Slice lhs, Slice rhs) {
   return lhs.binaryEquals(rhs);
 }
@@ -76,6 +329,55 @@ bool NormalizedCompare::equalsStrings(Slice lhs, Slice rhs) {
   return (nl == nr && (std::memcmp(left, right, nl) == 0));
 }
 
+bool NormalizedCompare::equalsObjects(Slice lhs, Slice rhs) {
+  ValueLength const n = lhs.length();
+  if (n != rhs.length()) {
+    return false;
+  }
+
+  if (lhs.isSorted() && rhs.isSorted()) {
+    // both index tables are sorted by attribute name, so equal Objects
+    // have the same attribute names at the same positions
+    for (ValueLength i = 0; i < n; ++i) {
+      Slice lhsKey = lhs.keyAt(i, false);
+      Slice rhsKey = rhs.keyAt(i, false);
+      if (lhsKey.isString() && rhsKey.isString()) {
+        if (lhsKey.stringView() != rhsKey.stringView()) {
+          return false;
+        }
+      } else if (lhsKey.makeKey().stringView() != rhsKey.makeKey().stringView()) {
+        // at least one translated attribute name
+        return false;
+      }
+      // recurse
+      if (!equals(Slice(lhsKey.start() + lhsKey.byteSize()),
+                  Slice(rhsKey.start() + rhsKey.byteSize()))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  if (lhs.isSorted() || rhs.isSorted() || n <= 16) {
+    // look up the attributes of the unsorted side in the sorted side,
+    // small Objects are simply scanned
+    if (lhs.isSorted()) {
+      std::swap(lhs, rhs);
+    }
+    for (ObjectIterator it(lhs, true); it.valid(); it.next()) {
+      Slice other = rhs.get(it.key(true).stringView());
+      // recurse
+      if (other.isNone() || !equals(it.value(), other)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // neither side has a sorted index table
+  return equalsUnsortedObjects(lhs, rhs, n);
+}
+
 bool NormalizedCompare::equals(Slice lhs, Slice rhs) {
   lhs = lhs.resolveExternals();
   rhs = rhs.resolveExternals();
@@ -128,17 +430,7 @@ bool NormalizedCompare::equals(Slice lhs, Slice rhs) {
       return true;
     }
     case ValueType::Object: {
-      std::set<std::string> keys;
-      // get all keys and bring them in order
-      Collection::unorderedKeys(lhs, keys);
-      Collection::unorderedKeys(rhs, keys);
-      for (auto const& key : keys) {
-        // recurse
-        if (!equals(lhs.get(key), rhs.get(key))) {
-          return false;
-        }
-      }
-      return true;
+      return equalsObjects(lhs, rhs);
     }
     case ValueType::Custom: {
       throw Exception(Exception::NotImplemented, "equals comparison for Custom type is not implemented");
@@ -149,6 +441,157 @@ bool NormalizedCompare::equals(Slice lhs, Slice rhs) {
   }
 }
 
+int NormalizedCompare::compare(Slice lhs, Slice rhs) {
+  lhs = sortValue(lhs);
+  rhs = sortValue(rhs);
+  SortRank const lhsRank = sortRank(lhs);
+  SortRank const rhsRank = sortRank(rhs);
+
+  if (lhsRank != rhsRank) {
+    return lhsRank < rhsRank ? -1 : 1;
+  }
+
+  switch (lhsRank) {
+    case RankBool: {
+      return static_cast<int>(lhs.getBoolean()) - static_cast<int>(rhs.getBoolean());
+    }
+    case RankNumber: {
+      return compareNumbers(lhs, rhs);
+    }
+    case RankUTCDate: {
+      int64_t l = lhs.getUTCDate();
+      int64_t r = rhs.getUTCDate();
+      return l == r ? 0 : (l < r ? -1 : 1);
+    }
+    case RankString: {
+      std::string_view l = lhs.stringView();
+      std::string_view r = rhs.stringView();
+      return compareBytes(reinterpret_cast<uint8_t const*>(l.data()), l.size(),
+                          reinterpret_cast<uint8_t const*>(r.data()), r.size());
+    }
+    case RankBinary: {
+      ValueLength nl;
+      uint8_t const* l = lhs.getBinary(nl);
+      ValueLength nr;
+      uint8_t const* r = rhs.getBinary(nr);
+      return compareBytes(l, nl, r, nr);
+    }
+    case RankArray: {
+      ArrayIterator l(lhs);
+      ArrayIterator r(rhs);
+      while (l.valid() && r.valid()) {
+        // recurse
+        int res = compare(l.value(), r.value());
+        if (res != 0) {
+          return res;
+        }
+        l.next();
+        r.next();
+      }
+      return l.valid() ? 1 : (r.valid() ? -1 : 0);
+    }
+    case RankObject: {
+      MemberList::allocator_type::arena_type lhsArena;
+      MemberList l{lhsArena};
+      sortedMembers(lhs, l);
+      MemberList::allocator_type::arena_type rhsArena;
+      MemberList r{rhsArena};
+      sortedMembers(rhs, r);
+
+      std::size_t const n = (std::min)(l.size(), r.size());
+      for (std::size_t i = 0; i < n; ++i) {
+        int res = l[i].first.compare(r[i].first);
+        if (res != 0) {
+          return res < 0 ? -1 : 1;
+        }
+        // recurse
+        res = compare(l[i].second, r[i].second);
+        if (res != 0) {
+          return res;
+        }
+      }
+      return l.size() == r.size() ? 0 : (l.size() < r.size() ? -1 : 1);
+    }
+    default: {
+      // types without a value
+      return 0;
+    }
+  }
+}
+
+void NormalizedCompare::appendSortKey(Slice slice, std::string& out) {
+  slice = sortValue(slice);
+  SortRank const rank = sortRank(slice);
+  out.push_back(static_cast<char>(rank));
+
+  switch (rank) {
+    case RankBool: {
+      out.push_back(slice.getBoolean() ? '\x01' : '\x00');
+      break;
+    }
+    case RankNumber: {
+      NumberKey const key = numberKey(slice);
+      out.push_back(static_cast<char>(key.kind));
+      if (key.kind == NumberKey::Positive || key.kind == NumberKey::Negative) {
+        // negative values sort in reverse order of their magnitude
+        uint64_t const flip = (key.kind == NumberKey::Negative) ? ~0ULL : 0ULL;
+        appendBigEndian(out, (static_cast<uint64_t>(key.exponent + 0x8000)) ^ flip, 2);
+        appendBigEndian(out, key.fraction ^ flip, 8);
+      }
+      break;
+    }
+    case RankUTCDate: {
+      // flip the sign bit so that negative values sort first
+      appendBigEndian(out, static_cast<uint64_t>(slice.getUTCDate()) ^ 0x8000000000000000ULL, 8);
+      break;
+    }
+    case RankString: {
+      std::string_view value = slice.stringView();
+      appendBytes(out, reinterpret_cast<uint8_t const*>(value.data()), value.size());
+      break;
+    }
+    case RankBinary: {
+      ValueLength length;
+      uint8_t const* value = slice.getBinary(length);
+      appendBytes(out, value, length);
+      break;
+    }
+    case RankArray: {
+      for (ArrayIterator it(slice); it.valid(); it.next()) {
+        // recurse
+        appendSortKey(it.value(), out);
+      }
+      out.push_back('\x00');
+      break;
+    }
+    case RankObject: {
+      MemberList::allocator_type::arena_type arena;
+      MemberList members{arena};
+      sortedMembers(slice, members);
+      for (auto const& member : members) {
+        // every member starts with 0x01, so that it sorts after the end
+        out.push_back('\x01');
+        appendBytes(out, reinterpret_cast<uint8_t const*>(member.first.data()),
+                    member.first.size());
+        // recurse
+        appendSortKey(member.second, out);
+      }
+      out.push_back('\x00');
+      break;
+    }
+    default: {
+      // types without a value
+      break;
+    }
+  }
+}
+
+std::string NormalizedCompare::sortKey(Slice slice) {
+  std::string result;
+  appendSortKey(slice, result);
+  return result;
+}
+
 size_t NormalizedCompare::Hash::operator()(arangodb::velocypack::Slice const& slice) const {
   return static_cast<size_t>(slice.normalizedHash());
 }
@@ -157,3 +600,8 @@ bool NormalizedCompare::Equal::operator()(arangodb::velocypack::Slice const& lhs
                                           arangodb::velocypack::Slice const& rhs) const {
   return NormalizedCompare::equals(lhs, rhs);
 }
+
+bool NormalizedCompare::Less::operator()(arangodb::velocypack::Slice const& lhs,
+                                         arangodb::velocypack::Slice const& rhs) const {
+  return NormalizedCompare::compare(lhs, rhs) < 0;
+}
@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/AttributeTranslator.h"
+#include "velocypack/CompiledPath.h"
+#include "velocypack/Exception.h"
+#include "velocypack/Options.h"
+#include "hash-index.h"
+
+using namespace arangodb::velocypack;
+
+CompiledPath::Step::Step(std::string_view name)
+    : name(name),
+      head(name.size() <= 126 ? static_cast<uint8_t>(0x40 + name.size())
+                              : uint8_t(0xbf)),
+      hash(hashIndexKey(name.data(), name.size())),
+      id(0),
+      translated(false),
+      guess(0) {
+  AttributeTranslator const* translator = Options::Defaults.attributeTranslator;
+  if (translator != nullptr) {
+    uint8_t const* p = translator->translate(name);
+    if (p != nullptr) {
+      id = Slice(p).getUInt();
+      translated = true;
+    }
+  }
+}
+
+CompiledPath::Step::Step(Step const& other)
+    : name(other.name),
+      head(other.head),
+      hash(other.hash),
+      id(other.id),
+      translated(other.translated),
+      guess(other.guess.load(std::memory_order_relaxed)) {}
+
+CompiledPath::CompiledPath(std::vector<std::string_view> const& path) {
+  if (VELOCYPACK_UNLIKELY(path.empty())) {
+    throw Exception(Exception::InvalidAttributePath);
+  }
+  _steps.reserve(path.size());
+  for (auto const& name : path) {
+    _steps.emplace_back(name);
+  }
+}
+
+Slice CompiledPath::get(Slice slice, bool resolveExternals) const {
+  // use the Slice as the starting point
+  Slice last = slice;
+  if (resolveExternals) {
+    last = last.resolveExternal();
+  }
+  if (VELOCYPACK_UNLIKELY(!last.isObject())) {
+    throw Exception(Exception::InvalidValueType, "Expecting Object");
+  }
+
+  for (std::size_t i = 0; i < _steps.size(); ++i) {
+    // fetch subattribute
+    last = lookup(last, _steps[i]);
+    if (last.isExternal()) {
+      last = last.resolveExternal();
+    }
+    // abort as early as possible
+    if (last.isNone() || (i + 1 < _steps.size() && !last.isObject())) {
+      return Slice();
+    }
+  }
+  return last;
+}
+
+Slice CompiledPath::lookup(Slice slice, Step const& step) const {
+  VELOCYPACK_ASSERT(slice.isObject());
+
+  // translates an integer key
+  auto translateKey = [](Slice key) -> Slice {
+    VELOCYPACK_ASSERT(key.isSmallInt() || key.isUInt());
+    if (VELOCYPACK_UNLIKELY(Options::Defaults.attributeTranslator == nullptr)) {
+      throw Exception(Exception::NeedAttributeTranslator);
+    }
+    return key.translateUnchecked();
+  };
+
+  auto matches = [&step, &translateKey](Slice key) -> bool {
+    uint8_t const h = key.head();
+    if (h == step.head && h != 0xbf) {
+      // short string of the same length
+      return std::memcmp(key.start() + 1, step.name.data(), step.name.size()) == 0;
+    }
+    if (key.isString()) {
+      // a long string, which may also hold a short name
+      return key.isEqualStringUnchecked(step.name);
+    }
+    if (step.translated) {
+      return key.getUInt() == step.id;
+    }
+    return translateKey(key).isEqualString(step.name);
+  };
+
+  auto const h = slice.head();
+  if (h == 0x0a) {
+    // empty object
+    return Slice();
+  }
+  if (h == 0x14) {
+    // compact Object, no index table to remember a position in
+    return slice.getFromCompactObject(step.name);
+  }
+
+  uint8_t const* start = slice.start();
+  ValueLength const offsetSize = slice.indexEntrySize(h);
+  VELOCYPACK_ASSERT(offsetSize > 0);
+  ValueLength const end = readIntegerNonEmpty<ValueLength>(start + 1, offsetSize);
+
+  // read number of items
+  ValueLength n;
+  ValueLength ieBase;
+  if (offsetSize < 8) {
+    n = readIntegerNonEmpty<ValueLength>(start + 1 + offsetSize, offsetSize);
+    ieBase = end - n * offsetSize;
+  } else {
+    n = readIntegerNonEmpty<ValueLength>(start + end - offsetSize, offsetSize);
+    ieBase = end - n * offsetSize - offsetSize;
+  }
+
+  if (n == 1 && h != 0x15) {
+    // Just one attribute, there is no index table!
+    Slice key(start + slice.findDataOffset(h));
+    if (matches(key)) {
+      return Slice(key.start() + key.byteSize());
+    }
+    return Slice();
+  }
+
+  auto keyAt = [=](ValueLength index) {
+    return Slice(start + readIntegerNonEmpty<ValueLength>(
+                             start + ieBase + index * offsetSize, offsetSize));
+  };
+
+  // Objects of the same shape have the attribute at the same position
+  ValueLength position = step.guess.load(std::memory_order_relaxed);
+  if (position < n) {
+    Slice key = keyAt(position);
+    if (matches(key)) {
+      return Slice(key.start() + key.byteSize());
+    }
+  }
+
+  if (h == 0x15) {
+    position = slice.findObjectKeyHashed(step.name, step.hash, ieBase, n);
+  } else if (h <= 0x0e) {
+    // binary search in the sorted index table
+    ValueLength low = 0;
+    ValueLength high = n;
+    while (low < high) {
+      ValueLength mid = low + (high - low) / 2;
+      Slice key = keyAt(mid);
+      int res;
+      if (key.isString()) {
+        res = key.compareStringUnchecked(step.name);
+      } else {
+        res = translateKey(key).compareString(step.name);
+      }
+      if (res < 0) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    position = low;
+    if (position < n && !matches(keyAt(position))) {
+      position = n;
+    }
+  } else {
+    // unsorted index table
+    for (position = 0; position < n; ++position) {
+      if (matches(keyAt(position))) {
+        break;
+      }
+    }
+  }
+
+  if (position >= n) {
+    return Slice();
+  }
+
+  step.guess.store(position, std::memory_order_relaxed);
+  Slice key = keyAt(position);
+  return Slice(key.start() + key.byteSize());
+}
@@ -22,26 +22,60 @@
 /// @author Jan Steemann
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <cmath>
+#include <type_traits>
 
 #include "velocypack/velocypack-common.h"
 #include "velocypack/Dumper.h"
 #include "velocypack/Exception.h"
+#include "velocypack/FileDescriptorSink.h"
 #include "velocypack/HexDump.h"
 #include "velocypack/Iterator.h"
 #include "velocypack/Sink.h"
 #include "velocypack/ValueType.h"
+#include "asm-functions.h"
+#include "dtoa.h"
 
 using namespace arangodb::velocypack;
 
-// forward for fpconv function declared elsewhere
-namespace arangodb {
-namespace velocypack {
-int fpconv_dtoa(double fp, char dest[24]);
+namespace {
+
+// appends a run of string bytes that need no escaping. if they are part
+// of the dumped VPack value, a FileDescriptorSink may write them without
+// copying
+template <typename SinkType>
+inline void appendUnescaped(SinkType* sink, uint8_t const* p, std::size_t n,
+                            bool fromSlice) {
+  if constexpr (std::is_same<SinkType, FileDescriptorSink>::value) {
+    if (fromSlice) {
+      sink->appendReference(reinterpret_cast<char const*>(p), n);
+      return;
+    }
+  }
+  sink->append(reinterpret_cast<char const*>(p), n);
 }
+
+// a dumper into a StringLengthSink only computes the length of the JSON.
+// it skips producing characters whenever their number is known upfront
+template <typename SinkType>
+constexpr bool countOnly = std::is_same<SinkType, StringLengthSink>::value;
+
+// number of decimal digits of v
+inline ValueLength decimalDigits(uint64_t v) noexcept {
+  ValueLength n = 1;
+  uint64_t limit = 10;
+  while (n < 20 && v >= limit) {
+    ++n;
+    limit *= 10;
+  }
+  return n;
 }
-  
-Dumper::Dumper(Sink* sink, Options const* options)
+
+}  // namespace
+
+template <typename SinkType>
+BasicDumper<SinkType>::BasicDumper(SinkType* sink, Options const* options)
     : options(options), 
       _sink(sink), 
       _indentation(0) {
@@ -53,44 +87,46 @@ Dumper::Dumper(Sink* sink, Options const* options)
   }
 }
   
-void Dumper::dump(Slice const& slice) {
+template <typename SinkType>
+void BasicDumper<SinkType>::dump(Slice const& slice) {
   _indentation = 0;
   _sink->reserve(slice.byteSize());
   dumpValue(&slice);
 }
   
-/*static*/ void Dumper::dump(Slice const& slice, Sink* sink,
-                             Options const* options) {
-  Dumper dumper(sink, options);
+template <typename SinkType>
+/*static*/ void BasicDumper<SinkType>::dump(Slice const& slice, SinkType* sink,
+                                            Options const* options) {
+  BasicDumper dumper(sink, options);
   dumper.dump(slice);
 }
 
-/*static*/ void Dumper::dump(Slice const* slice, Sink* sink,
-                             Options const* options) {
+template <typename SinkType>
+/*static*/ void BasicDumper<SinkType>::dump(Slice const* slice, SinkType* sink,
+                                            Options const* options) {
   dump(*slice, sink, options);
 }
 
-/*static*/ std::string Dumper::toString(Slice const& slice,
-                                        Options const* options) {
-  std::string buffer;
-  StringSink sink(&buffer);
-  dump(slice, &sink, options);
-  return buffer;
-}
-  
-/*static*/ std::string Dumper::toString(Slice const* slice,
-                                        Options const* options) {
-  return toString(*slice, options);
-}
-  
-void Dumper::appendString(char const* src, ValueLength len) {
+template <typename SinkType>
+void BasicDumper<SinkType>::appendString(char const* src, ValueLength len) {
   _sink->reserve(2 + len);
   _sink->push_back('"');
   dumpString(src, len);
   _sink->push_back('"');
 }
 
-void Dumper::appendInt(int64_t v) {
+template <typename SinkType>
+void BasicDumper<SinkType>::appendInt(int64_t v) {
+  if constexpr (countOnly<SinkType>) {
+    if (v == INT64_MIN) {
+      _sink->length += 20;
+    } else {
+      _sink->length += (v < 0) ? 1 + decimalDigits(static_cast<uint64_t>(-v))
+                               : decimalDigits(static_cast<uint64_t>(v));
+    }
+    return;
+  }
+
   if (v == INT64_MIN) {
     _sink->append("-9223372036854775808", 20);
     return;
@@ -158,7 +194,13 @@ void Dumper::appendInt(int64_t v) {
   _sink->push_back('0' + (v % 10));
 }
 
-void Dumper::appendUInt(uint64_t v) {
+template <typename SinkType>
+void BasicDumper<SinkType>::appendUInt(uint64_t v) {
+  if constexpr (countOnly<SinkType>) {
+    _sink->length += decimalDigits(v);
+    return;
+  }
+
   if (10000000000000000000ULL <= v) {
     _sink->push_back('0' + (v / 10000000000000000000ULL) % 10);
   }
@@ -220,13 +262,26 @@ void Dumper::appendUInt(uint64_t v) {
   _sink->push_back('0' + (v % 10));
 }
 
-void Dumper::appendDouble(double v) {
-  char temp[24];
-  int len = fpconv_dtoa(v, &temp[0]);
+template <typename SinkType>
+void BasicDumper<SinkType>::appendDouble(double v) {
+  char temp[maxDoubleStringLength];
+  int const digits = static_cast<int>(
+      std::min<uint32_t>(options->doubleSignificantDigits, 17));
+  if constexpr (countOnly<SinkType>) {
+    _sink->length += doubleStringLength(v, digits);
+    return;
+  }
+  std::size_t len = doubleToString(v, &temp[0], digits);
   _sink->append(&temp[0], static_cast<ValueLength>(len));
 }
 
-void Dumper::dumpUnicodeCharacter(uint16_t value) {
+template <typename SinkType>
+void BasicDumper<SinkType>::dumpUnicodeCharacter(uint16_t value) {
+  if constexpr (countOnly<SinkType>) {
+    _sink->length += 6;
+    return;
+  }
+
   _sink->append("\\u", 2);
   
   uint16_t p;
@@ -243,7 +298,8 @@ void Dumper::dumpUnicodeCharacter(uint16_t value) {
   _sink->push_back((p < 10) ? ('0' + p) : ('A' + p - 10));
 }
 
-void Dumper::dumpInteger(Slice const* slice) {
+template <typename SinkType>
+void BasicDumper<SinkType>::dumpInteger(Slice const* slice) {
   VELOCYPACK_ASSERT(slice->isInteger());
 
   if (slice->isType(ValueType::UInt)) {
@@ -264,7 +320,9 @@ void Dumper::dumpInteger(Slice const* slice) {
   }
 }
 
-void Dumper::dumpString(char const* src, ValueLength len) {
+template <typename SinkType>
+void BasicDumper<SinkType>::dumpString(char const* src, ValueLength len,
+                                       bool fromSlice) {
   static char const EscapeTable[256] = {
       // 0    1    2    3    4    5    6    7    8    9    A    B    C    D    E
       // F
@@ -302,7 +360,29 @@ void Dumper::dumpString(char const* src, ValueLength len) {
 
   uint8_t const* p = reinterpret_cast<uint8_t const*>(src);
   uint8_t const* e = p + len;
+  // set when the string contains invalid UTF-8. from then on, every byte
+  // is handled individually below
+  bool byteByByte = false;
   while (p < e) {
+    if (!byteByByte) {
+      // bulk-append the following run of bytes that need no escaping
+      bool highBit;
+      std::size_t n = JSONEscapeScan(p, static_cast<std::size_t>(e - p),
+                                     options->escapeForwardSlashes,
+                                     options->escapeUnicode, highBit);
+      if (n > 0) {
+        if (highBit && !ValidateUtf8String(p, n)) {
+          byteByByte = true;
+        } else {
+          appendUnescaped(_sink, p, n, fromSlice);
+          p += n;
+          if (p == e) {
+            break;
+          }
+        }
+      }
+    }
+
     uint8_t c = *p;
 
     if ((c & 0x80U) == 0) {
@@ -379,7 +459,8 @@ void Dumper::dumpString(char const* src, ValueLength len) {
   }
 }
 
-void Dumper::dumpValue(Slice const* slice, Slice const* base) {
+template <typename SinkType>
+void BasicDumper<SinkType>::dumpValue(Slice const* slice, Slice const* base) {
   if (base == nullptr) {
     base = slice;
     VELOCYPACK_ASSERT(base != nullptr);
@@ -445,7 +526,10 @@ void Dumper::dumpValue(Slice const* slice, Slice const* base) {
     }
 
     case ValueType::Object: {
-      ObjectIterator it(*slice, !options->dumpAttributesInIndexOrder);
+      // the order of the attributes does not matter for the length, and
+      // sequential iteration is cheaper
+      ObjectIterator it(*slice, countOnly<SinkType> ||
+                                    !options->dumpAttributesInIndexOrder);
       _sink->push_back('{');
       if (options->prettyPrint) {
         _sink->push_back('\n');
@@ -531,7 +615,7 @@ void Dumper::dumpValue(Slice const* slice, Slice const* base) {
       char const* p = slice->getString(len);
       _sink->reserve(2 + len);
       _sink->push_back('"');
-      dumpString(p, len);
+      dumpString(p, len, true);
       _sink->push_back('"');
       break;
     }
@@ -552,6 +636,10 @@ void Dumper::dumpValue(Slice const* slice, Slice const* base) {
         _sink->push_back('"');
         ValueLength len;
         uint8_t const* bin = slice->getBinary(len);
+        if constexpr (countOnly<SinkType>) {
+          _sink->length += 2 * len + 1;
+          break;
+        }
         for (ValueLength i = 0; i < len; ++i) {
           uint8_t value = bin[i];
           uint8_t x = value / 16;
@@ -589,25 +677,38 @@ void Dumper::dumpValue(Slice const* slice, Slice const* base) {
     }
 
     case ValueType::Custom: {
-      if (options->customTypeHandler == nullptr) {
-        throw Exception(Exception::NeedCustomTypeHandler);
-      } else {
-        options->customTypeHandler->dump(*slice, this, *base);
-      }
+      dumpCustom(slice, base);
       break;
     }
   }
 }
   
-void Dumper::indent() {
+template <typename SinkType>
+void BasicDumper<SinkType>::dumpCustom(Slice const* slice, Slice const* base) {
+  if (options->customTypeHandler == nullptr) {
+    throw Exception(Exception::NeedCustomTypeHandler);
+  }
+  // custom type handlers work on a Dumper, which writes into the same sink
+  Dumper dumper(_sink, options);
+  dumper._indentation = _indentation;
+  options->customTypeHandler->dump(*slice, &dumper, *base);
+}
+
+template <typename SinkType>
+void BasicDumper<SinkType>::indent() {
   std::size_t n = _indentation;
+  if constexpr (countOnly<SinkType>) {
+    _sink->length += 2 * n;
+    return;
+  }
   _sink->reserve(2 * n);
   for (std::size_t i = 0; i < n; ++i) {
     _sink->append("  ", 2);
   }
 }
 
-void Dumper::handleUnsupportedType(Slice const* slice) {
+template <typename SinkType>
+void BasicDumper<SinkType>::handleUnsupportedType(Slice const* slice) {
   if (options->unsupportedTypeBehavior == Options::NullifyUnsupportedType) {
     _sink->append("null", 4);
     return;
@@ -618,3 +719,45 @@ void Dumper::handleUnsupportedType(Slice const* slice) {
 
   throw Exception(Exception::NoJsonEquivalent);
 }
+
+/*static*/ ValueLength Dumper::dumpLength(Slice const& slice,
+                                          Options const* options) {
+  StringLengthSink sink;
+  BasicDumper<StringLengthSink>::dump(slice, &sink, options);
+  return sink.length;
+}
+
+/*static*/ std::string& Dumper::dumpAppend(std::string& out,
+                                           Slice const& slice,
+                                           Options const* options) {
+  if (slice.byteSize() >= exactReservationThreshold) {
+    // compute the exact length first, so that the string is allocated
+    // once and never copied. for smaller values, this costs more time
+    // than growing the string
+    out.reserve(checkOverflow(out.size() + dumpLength(slice, options)));
+  }
+  StringSink sink(&out);
+  BasicDumper<StringSink>::dump(slice, &sink, options);
+  return out;
+}
+
+/*static*/ std::string Dumper::toString(Slice const& slice,
+                                        Options const* options) {
+  std::string buffer;
+  dumpAppend(buffer, slice, options);
+  return buffer;
+}
+
+/*static*/ std::string Dumper::toString(Slice const* slice,
+                                        Options const* options) {
+  return toString(*slice, options);
+}
+
+namespace arangodb::velocypack {
+template class BasicDumper<Sink>;
+template class BasicDumper<StringSink>;
+template class BasicDumper<CharBufferSink>;
+template class BasicDumper<StringLengthSink>;
+template class BasicDumper<BufferedSink>;
+template class BasicDumper<FileDescriptorSink>;
+}  // namespace arangodb::velocypack
@@ -92,11 +92,18 @@ char const* Exception::message(ExceptionType type) noexcept {
       return "Tagged types are not allowed in this configuration";
     case BuilderBCDDisallowed:
       return "BCD types are not allowed in this configuration";
+    case BuilderShapeMismatch:
+      return "Number of values does not match the Object shape";
   
     case ValidatorInvalidType:
       return "Invalid type found in binary data";
     case ValidatorInvalidLength:
       return "Invalid length found in binary data";
+    case ValidatorNestingTooDeep:
+      return "Binary data is nested too deeply";
+
+    case FileError:
+      return "File error";
 
     case UnknownError:
     default:
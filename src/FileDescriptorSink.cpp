@@ -0,0 +1,234 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <climits>
+#include <new>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/FileDescriptorSink.h"
+#include "velocypack/Exception.h"
+
+using namespace arangodb::velocypack;
+
+namespace {
+
+std::size_t pageSize() {
+#ifdef _WIN32
+  return 4096;
+#else
+  static std::size_t const size = [] {
+    long size = ::sysconf(_SC_PAGESIZE);
+    return (size > 0) ? static_cast<std::size_t>(size) : std::size_t(4096);
+  }();
+  return size;
+#endif
+}
+
+// maximum number of segments written with a single call
+#if !defined(_WIN32) && defined(IOV_MAX)
+constexpr int maxIovecs = (IOV_MAX < 256) ? IOV_MAX : 256;
+#else
+constexpr int maxIovecs = 256;
+#endif
+
+#ifndef _WIN32
+// waits until fd becomes writable
+void waitWritable(int fd) {
+  struct pollfd p;
+  p.fd = fd;
+  p.events = POLLOUT;
+  while (::poll(&p, 1, -1) < 0) {
+    if (errno != EINTR) {
+      throw Exception(Exception::FileError, "Cannot poll file descriptor");
+    }
+  }
+  // errors and hangups are reported by the next write
+}
+#endif
+
+}  // namespace
+
+FileDescriptorSink::FileDescriptorSink(int fd,
+                                       FileDescriptorSinkOptions const& options)
+    : _fd(fd),
+      _bufferSize(std::max<std::size_t>(
+          (options.bufferSize + pageSize() - 1) / pageSize() * pageSize(),
+          pageSize())),
+      _maxBuffers(std::max<std::size_t>(options.maxBuffers, 2)),
+      _backpressure(options.backpressure),
+      _zeroCopyThreshold(options.zeroCopyThreshold),
+      _current(nullptr),
+      _used(0),
+      _start(0),
+      _allocated(0),
+      _written(0) {
+  if (fd < 0) {
+    throw Exception(Exception::FileError, "Invalid file descriptor");
+  }
+  _current = allocateBuffer();
+}
+
+FileDescriptorSink::~FileDescriptorSink() {
+  try {
+    flush();
+  } catch (...) {
+  }
+
+  std::align_val_t const alignment{pageSize()};
+  for (auto const& it : _pending) {
+    if (it.buffer != nullptr) {
+      ::operator delete(it.buffer, alignment);
+    }
+  }
+  for (char* buffer : _free) {
+    ::operator delete(buffer, alignment);
+  }
+  ::operator delete(_current, alignment);
+}
+
+void FileDescriptorSink::flush() {
+  enqueueCurrent(nullptr);
+  writePending(true);
+  // everything has been written, so the current buffer can be refilled
+  // from its start
+  _used = 0;
+  _start = 0;
+}
+
+void FileDescriptorSink::appendSlow(char const* p, std::size_t len) {
+  while (len > 0) {
+    if (_used == _bufferSize) {
+      nextBuffer();
+    }
+    std::size_t n = std::min(len, _bufferSize - _used);
+    memcpy(_current + _used, p, n);
+    _used += n;
+    p += n;
+    len -= n;
+  }
+}
+
+void FileDescriptorSink::nextBuffer() {
+  if (_free.empty() && _allocated >= _maxBuffers) {
+    // all other buffers are waiting to be written. without backpressure,
+    // we only write what the file descriptor accepts right now and
+    // allocate another buffer if that is not enough
+    writePending(_backpressure);
+  }
+
+  char* next;
+  if (!_free.empty()) {
+    next = _free.back();
+    _free.pop_back();
+  } else {
+    next = allocateBuffer();
+  }
+  enqueueCurrent(_current);
+  _current = next;
+  _used = 0;
+  _start = 0;
+}
+
+void FileDescriptorSink::writePending(bool wait) {
+  while (!_pending.empty()) {
+#ifdef _WIN32
+    // there is no writev() and no way to wait for CRT file descriptors,
+    // which are always blocking
+    Segment const& front = _pending.front();
+    int result = 0;
+    if (front.length > 0) {
+      unsigned int length = static_cast<unsigned int>(
+          std::min<std::size_t>(front.length, INT_MAX));
+      result = ::_write(_fd, front.data, length);
+      if (result < 0) {
+        throw Exception(Exception::FileError, "Cannot write to file descriptor");
+      }
+    }
+#else
+    struct iovec iov[maxIovecs];
+    int count = 0;
+    for (auto it = _pending.begin(); it != _pending.end() && count < maxIovecs;
+         ++it) {
+      if (it->length > 0) {
+        iov[count].iov_base = const_cast<char*>(it->data);
+        iov[count].iov_len = it->length;
+        ++count;
+      }
+    }
+
+    ssize_t result = 0;
+    if (count > 0) {
+      result = ::writev(_fd, &iov[0], count);
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          if (!wait) {
+            return;
+          }
+          waitWritable(_fd);
+          continue;
+        }
+        throw Exception(Exception::FileError, "Cannot write to file descriptor");
+      }
+    }
+#endif
+
+    // drop everything that was written, recycling the buffers
+    _written += static_cast<ValueLength>(result);
+    std::size_t remaining = static_cast<std::size_t>(result);
+    while (!_pending.empty()) {
+      Segment& segment = _pending.front();
+      if (segment.length > remaining) {
+        segment.data += remaining;
+        segment.length -= remaining;
+        break;
+      }
+      remaining -= segment.length;
+      if (segment.buffer != nullptr) {
+        _free.push_back(segment.buffer);
+      }
+      _pending.pop_front();
+    }
+  }
+}
+
+char* FileDescriptorSink::allocateBuffer() {
+  char* buffer = static_cast<char*>(
+      ::operator new(_bufferSize, std::align_val_t{pageSize()}));
+  ++_allocated;
+  return buffer;
+}
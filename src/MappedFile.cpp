@@ -0,0 +1,234 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <limits>
+#include <string>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/MappedFile.h"
+#include "velocypack/Exception.h"
+#include "velocypack/Validator.h"
+
+using namespace arangodb::velocypack;
+
+namespace {
+
+// wraps data read into memory, for files that cannot be mapped
+std::shared_ptr<uint8_t const> ownData(std::string&& content,
+                                       std::size_t& size) {
+  size = content.size();
+  if (size == 0) {
+    return nullptr;
+  }
+  auto holder = std::make_shared<std::string>(std::move(content));
+  // the aliasing constructor keeps the string alive
+  return std::shared_ptr<uint8_t const>(
+      holder, reinterpret_cast<uint8_t const*>(holder->data()));
+}
+
+#ifdef _WIN32
+
+std::shared_ptr<uint8_t const> mapFile(std::string const& path,
+                                       std::size_t& size) {
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw Exception(Exception::FileError, "Cannot open file");
+  }
+
+  if (GetFileType(file) != FILE_TYPE_DISK) {
+    // pipes and the like cannot be mapped, so read them
+    std::string content;
+    char buffer[32768];
+    DWORD n = 0;
+    BOOL ok;
+    while ((ok = ReadFile(file, buffer, sizeof(buffer), &n, nullptr)) && n > 0) {
+      content.append(buffer, n);
+    }
+    // the writing end of a closed pipe is reported as an error
+    bool const failed = !ok && GetLastError() != ERROR_BROKEN_PIPE;
+    CloseHandle(file);
+    if (failed) {
+      throw Exception(Exception::FileError, "Cannot read file");
+    }
+    return ownData(std::move(content), size);
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize)) {
+    CloseHandle(file);
+    throw Exception(Exception::FileError, "Cannot determine file size");
+  }
+  size = checkOverflow(static_cast<ValueLength>(fileSize.QuadPart));
+  if (size == 0) {
+    // empty files cannot be mapped
+    CloseHandle(file);
+    return nullptr;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    throw Exception(Exception::FileError, "Cannot map file");
+  }
+  void* p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  // the view keeps the mapping alive
+  CloseHandle(mapping);
+  if (p == nullptr) {
+    throw Exception(Exception::FileError, "Cannot map file");
+  }
+
+  return std::shared_ptr<uint8_t const>(
+      static_cast<uint8_t const*>(p),
+      [](uint8_t const* p) { UnmapViewOfFile(p); });
+}
+
+#else
+
+std::shared_ptr<uint8_t const> mapFile(std::string const& path,
+                                       std::size_t& size) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw Exception(Exception::FileError, "Cannot open file");
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw Exception(Exception::FileError, "Cannot determine file size");
+  }
+  if (!S_ISREG(st.st_mode)) {
+    // pipes and the like cannot be mapped, so read them
+    std::string content;
+    char buffer[32768];
+    while (true) {
+      ssize_t n = ::read(fd, buffer, sizeof(buffer));
+      if (n > 0) {
+        content.append(buffer, static_cast<std::size_t>(n));
+      } else if (n == 0) {
+        break;
+      } else if (errno != EINTR) {
+        ::close(fd);
+        throw Exception(Exception::FileError, "Cannot read file");
+      }
+    }
+    ::close(fd);
+    return ownData(std::move(content), size);
+  }
+  size = checkOverflow(static_cast<ValueLength>(st.st_size));
+  if (size == 0) {
+    // empty files cannot be mapped
+    ::close(fd);
+    return nullptr;
+  }
+
+  void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping stays valid after closing the file
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    throw Exception(Exception::FileError, "Cannot map file");
+  }
+
+  return std::shared_ptr<uint8_t const>(
+      static_cast<uint8_t const*>(p), [size](uint8_t const* p) {
+        ::munmap(const_cast<uint8_t*>(p), size);
+      });
+}
+
+#endif
+
+}  // namespace
+
+MappedFile::MappedFile(std::string const& path, Options const* options)
+    : _size(0), _validated(0), options(options) {
+  if (VELOCYPACK_UNLIKELY(options == nullptr)) {
+    throw Exception(Exception::InternalError, "Options cannot be a nullptr");
+  }
+  _data = mapFile(path, _size);
+}
+
+void MappedFile::validate() {
+  std::lock_guard<std::mutex> guard(_mutex);
+  validateUpTo(std::numeric_limits<ValueLength>::max());
+}
+
+bool MappedFile::isValidated() const noexcept {
+  return _validated.load(std::memory_order_acquire) == _size;
+}
+
+ValueLength MappedFile::length() {
+  std::lock_guard<std::mutex> guard(_mutex);
+  validateUpTo(std::numeric_limits<ValueLength>::max());
+  return _offsets.size();
+}
+
+SharedSlice MappedFile::at(ValueLength index) {
+  std::size_t offset;
+  {
+    std::lock_guard<std::mutex> guard(_mutex);
+    validateUpTo(index);
+    if (index >= _offsets.size()) {
+      throw Exception(Exception::IndexOutOfBounds);
+    }
+    offset = _offsets[index];
+  }
+  // the aliasing constructor shares ownership of the mapping
+  return SharedSlice(std::shared_ptr<uint8_t const>(_data, _data.get() + offset));
+}
+
+void MappedFile::validateUpTo(ValueLength index) {
+  // only modified with _mutex held, so it can be read relaxed here
+  std::size_t validated = _validated.load(std::memory_order_relaxed);
+  if (_offsets.size() > index || validated == _size) {
+    return;
+  }
+
+  uint8_t const* start = _data.get();
+  // files are written by the Builder, which can produce values of any
+  // depth, so they are validated without a nesting limit
+  Options validatorOptions = *options;
+  validatorOptions.maxValidationDepth = 0;
+  Validator validator(&validatorOptions);
+  while (_offsets.size() <= index && validated < _size) {
+    validator.validate(start + validated, _size - validated, true);
+    _offsets.push_back(validated);
+    validated += static_cast<std::size_t>(Slice(start + validated).byteSize());
+    _validated.store(validated, std::memory_order_release);
+  }
+}
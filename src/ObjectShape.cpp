@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/AttributeTranslator.h"
+#include "velocypack/Exception.h"
+#include "velocypack/ObjectShape.h"
+#include "velocypack/Slice.h"
+
+using namespace arangodb::velocypack;
+
+ObjectShape::ObjectShape(std::string_view const* keys, std::size_t count,
+                         Options const* options)
+    : _translator(nullptr) {
+  if (VELOCYPACK_UNLIKELY(options == nullptr)) {
+    throw Exception(Exception::InternalError, "Options cannot be a nullptr");
+  }
+  _translator = options->attributeTranslator;
+
+  _names.reserve(count);
+  _keyOffsets.reserve(count + 1);
+  _order.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    std::string_view name = keys[i];
+    _names.emplace_back(name);
+    _keyOffsets.push_back(_keys.size());
+    _order.push_back(i);
+
+    if (options->attributeTranslator != nullptr) {
+      // check if a translation for the attribute name exists
+      uint8_t const* translated = options->attributeTranslator->translate(name);
+      if (translated != nullptr) {
+        ValueLength const l = Slice(translated).byteSize();
+        _keys.insert(_keys.end(), translated, translated + l);
+        continue;
+      }
+    }
+
+    if (name.size() <= 126) {
+      // short string
+      _keys.push_back(static_cast<uint8_t>(0x40 + name.size()));
+    } else {
+      // long string
+      _keys.push_back(0xbf);
+      uint64_t x = name.size();
+      for (std::size_t j = 0; j < 8; ++j) {
+        _keys.push_back(static_cast<uint8_t>(x & 0xff));
+        x >>= 8;
+      }
+    }
+    _keys.insert(_keys.end(), name.begin(), name.end());
+  }
+  _keyOffsets.push_back(_keys.size());
+
+  // same order as the index table of a sorted Object
+  std::sort(_order.begin(), _order.end(), [this](ValueLength a, ValueLength b) {
+    return std::string_view(_names[a]) < std::string_view(_names[b]);
+  });
+  for (std::size_t i = 1; i < count; ++i) {
+    if (_names[_order[i - 1]] == _names[_order[i]]) {
+      throw Exception(Exception::DuplicateAttributeName);
+    }
+  }
+}
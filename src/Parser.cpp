@@ -27,7 +27,9 @@
 #include "velocypack/Value.h"
 #include "velocypack/ValueType.h"
 #include "asm-functions.h"
+#include "fast-float.h"
 
+#include <cmath>
 #include <cstdlib>
 
 using namespace arangodb::velocypack;
@@ -47,6 +49,8 @@ ValueLength Parser::parseInternal(bool multi) {
     _pos += 3;
   }
 
+  bool const indexed = options->useStructuralIndex && buildStructuralIndex();
+
   ValueLength nr = 0;
   do {
     bool haveReported = false;
@@ -64,7 +68,11 @@ ValueLength Parser::parseInternal(bool multi) {
       }
     }
     try {
-      parseJson();
+      if (indexed) {
+        parseJsonIndexed();
+      } else {
+        parseJson();
+      }
     } catch (...) {
       if (haveReported) {
         _builderPtr->cleanupAdd();
@@ -72,8 +80,12 @@ ValueLength Parser::parseInternal(bool multi) {
       throw;
     }
     nr++;
-    while (_pos < _size && isWhiteSpace(_start[_pos])) {
-      ++_pos;
+    if (indexed) {
+      nextStructural();  // return value intentionally not checked
+    } else {
+      while (_pos < _size && isWhiteSpace(_start[_pos])) {
+        ++_pos;
+      }
     }
     if (!multi && _pos != _size) {
       consume();  // to get error reporting right. return value intentionally not checked
@@ -118,9 +130,87 @@ int Parser::skipWhiteSpace(char const* err) {
   throw Exception(Exception::ParseError, err);
 }
 
+void Parser::addNumber(Builder& builder, ParsedNumber const& number,
+                       bool negative, bool integer, char const* text,
+                       std::size_t length) {
+  if (integer && number.exponent == 0) {
+    // integer that fits into 64 bits
+    if (!negative) {
+      builder.addUInt(number.mantissa);
+      return;
+    }
+    if (number.mantissa <= static_cast<uint64_t>(INT64_MAX)) {
+      builder.addInt(-static_cast<int64_t>(number.mantissa));
+      return;
+    }
+    if (number.mantissa == toUInt64(INT64_MIN)) {
+      builder.addInt(INT64_MIN);
+      return;
+    }
+    // the integer is too large. fall through to convert it into a double
+  }
+
+  double value = decimalToDouble(number.mantissa, number.exponent);
+  if (VELOCYPACK_UNLIKELY(number.truncated)) {
+    // non-zero digits were dropped from the mantissa, so the exact value
+    // is somewhere between mantissa and mantissa + 1 (times 10^exponent).
+    // if both round to the same double, that is the result
+    if (number.mantissa == UINT64_MAX ||
+        decimalToDouble(number.mantissa + 1, number.exponent) != value) {
+      value = decimalToDoubleSlow(text, length, value);
+    }
+  }
+  if (VELOCYPACK_UNLIKELY(std::isinf(value))) {
+    throw Exception(Exception::NumberOutOfRange);
+  }
+  builder.addDouble(negative ? -value : value);
+}
+
+// scans the digits of the integral part (fractional == false) or the
+// fractional part (fractional == true) of a number into value
+void Parser::scanDigits(ParsedNumber& value, bool fractional) {
+  if constexpr (isLittleEndian()) {
+    // consume blocks of 8 digits at once while the mantissa cannot
+    // overflow
+    while (_size - _pos >= 8 && value.mantissa < 100000000000ULL) {
+      uint64_t val;
+      memcpy(&val, _start + _pos, sizeof(val));
+      if (!isEightDigits(val)) {
+        break;
+      }
+      value.mantissa = value.mantissa * 100000000ULL + parseEightDigits(val);
+      if (fractional) {
+        value.exponent -= 8;
+      }
+      _pos += 8;
+    }
+  }
+  while (_pos < _size) {
+    unsigned int d = static_cast<unsigned int>(_start[_pos]) - '0';
+    if (d > 9) {
+      return;
+    }
+    value.addDigit(d, fractional);
+    ++_pos;
+  }
+}
+
+// scans the digits of an exponent
+int64_t Parser::scanExponent() {
+  int64_t exponent = 0;
+  while (_pos < _size) {
+    unsigned int d = static_cast<unsigned int>(_start[_pos]) - '0';
+    if (d > 9) {
+      break;
+    }
+    exponent = ParsedNumber::addExponentDigit(exponent, d);
+    ++_pos;
+  }
+  return exponent;
+}
+
 // parses a number value
 void Parser::parseNumber() {
-  std::size_t startPos = _pos;
   ParsedNumber numberValue;
   bool negative = false;
   int i = consume();
@@ -133,94 +223,51 @@ void Parser::parseNumber() {
   if (i < '0' || i > '9') {
     throw Exception(Exception::ParseError, "Expecting digit");
   }
+  // start of the number, without the sign
+  std::size_t const startPos = _pos - 1;
 
   if (i != '0') {
     unconsume();
-    scanDigits(numberValue);
+    scanDigits(numberValue, false);
   }
+  bool integer = true;
   i = consume();
   if (i < 0 || (i != '.' && i != 'e' && i != 'E')) {
     if (i >= 0) {
       unconsume();
     }
-    if (!numberValue.isInteger) {
-      if (negative) {
-        _builderPtr->addDouble(-numberValue.doubleValue);
-      } else {
-        _builderPtr->addDouble(numberValue.doubleValue);
+  } else {
+    integer = false;
+    if (i == '.') {
+      // fraction. skip over '.'
+      i = getOneOrThrow("Incomplete number");
+      if (i < '0' || i > '9') {
+        throw Exception(Exception::ParseError, "Incomplete number");
       }
-    } else if (negative) {
-      if (numberValue.intValue <= static_cast<uint64_t>(INT64_MAX)) {
-        _builderPtr->addInt(-static_cast<int64_t>(numberValue.intValue));
-      } else if (numberValue.intValue == toUInt64(INT64_MIN)) {
-        _builderPtr->addInt(INT64_MIN);
-      } else {
-        _builderPtr->addDouble(-static_cast<double>(numberValue.intValue));
+      unconsume();
+      scanDigits(numberValue, true);
+      i = consume();
+    }
+    if (i == 'e' || i == 'E') {
+      i = getOneOrThrow("Incomplete number");
+      bool negativeExponent = false;
+      if (i == '+' || i == '-') {
+        negativeExponent = (i == '-');
+        i = getOneOrThrow("Incomplete number");
       }
-    } else {
-      _builderPtr->addUInt(numberValue.intValue);
+      if (i < '0' || i > '9') {
+        throw Exception(Exception::ParseError, "Incomplete number");
+      }
+      unconsume();
+      int64_t exponent = scanExponent();
+      numberValue.exponent += negativeExponent ? -exponent : exponent;
+    } else if (i >= 0) {
+      unconsume();
     }
-    return;
   }
 
-  double fractionalPart;
-  if (i == '.') {
-    // fraction. skip over '.'
-    i = getOneOrThrow("Incomplete number");
-    if (i < '0' || i > '9') {
-      throw Exception(Exception::ParseError, "Incomplete number");
-    }
-    unconsume();
-    fractionalPart = scanDigitsFractional();
-    if (negative) {
-      fractionalPart = -numberValue.asDouble() - fractionalPart;
-    } else {
-      fractionalPart = numberValue.asDouble() + fractionalPart;
-    }
-    i = consume();
-    if (i < 0) {
-      _builderPtr->addDouble(fractionalPart);
-      return;
-    }
-  } else {
-    if (negative) {
-      fractionalPart = -numberValue.asDouble();
-    } else {
-      fractionalPart = numberValue.asDouble();
-    }
-  }
-  if (i != 'e' && i != 'E') {
-    unconsume();
-    // use conventional atof() conversion here, to avoid precision loss
-    // when interpreting and multiplying the single digits of the input stream
-    // _builderPtr->addDouble(fractionalPart);
-    _builderPtr->addDouble(atof(reinterpret_cast<char const*>(_start) + startPos));
-    return;
-  }
-  i = getOneOrThrow("Incomplete number");
-  negative = false;
-  if (i == '+' || i == '-') {
-    negative = (i == '-');
-    i = getOneOrThrow("Incomplete number");
-  }
-  if (i < '0' || i > '9') {
-    throw Exception(Exception::ParseError, "Incomplete number");
-  }
-  unconsume();
-  ParsedNumber exponent;
-  scanDigits(exponent);
-  if (negative) {
-    fractionalPart *= pow(10, -exponent.asDouble());
-  } else {
-    fractionalPart *= pow(10, exponent.asDouble());
-  }
-  if (std::isnan(fractionalPart) || !std::isfinite(fractionalPart)) {
-    throw Exception(Exception::NumberOutOfRange);
-  }
-  // use conventional atof() conversion here, to avoid precision loss
-  // when interpreting and multiplying the single digits of the input stream
-  // _builderPtr->addDouble(fractionalPart);
-  _builderPtr->addDouble(atof(reinterpret_cast<char const*>(_start) + startPos));
+  addNumber(*_builderPtr, numberValue, negative, integer,
+            reinterpret_cast<char const*>(_start) + startPos, _pos - startPos);
 }
 
 void Parser::parseString() {
@@ -479,24 +526,7 @@ void Parser::parseObject() {
     _builderPtr->reportAdd();
     auto const lastPos = _builderPtr->_pos;
     parseString();
-
-    if (options->attributeTranslator != nullptr) {
-      // check if a translation for the attribute name exists
-      Slice key(_builderPtr->_start + lastPos);
-
-      if (key.isString()) {
-        uint8_t const* translated =
-            options->attributeTranslator->translate(key.stringView());
-
-        if (translated != nullptr) {
-          // found translation... now reset position to old key position
-          // and simply overwrite the existing key with the numeric translation
-          // id
-          _builderPtr->resetTo(lastPos);
-          _builderPtr->addUInt(Slice(translated).getUInt());
-        }
-      }
-    }
+    translateAttributeName(lastPos);
 
     i = skipWhiteSpace("Expecting ':'");
     // always expecting the ':' here
@@ -530,6 +560,26 @@ void Parser::parseObject() {
   VELOCYPACK_ASSERT(false);
 }
 
+void Parser::translateAttributeName(ValueLength keyPos) {
+  if (options->attributeTranslator != nullptr) {
+    // check if a translation for the attribute name exists
+    Slice key(_builderPtr->_start + keyPos);
+
+    if (key.isString()) {
+      uint8_t const* translated =
+          options->attributeTranslator->translate(key.stringView());
+
+      if (translated != nullptr) {
+        // found translation... now reset position to old key position
+        // and simply overwrite the existing key with the numeric translation
+        // id
+        _builderPtr->resetTo(keyPos);
+        _builderPtr->addUInt(Slice(translated).getUInt());
+      }
+    }
+  }
+}
+
 void Parser::parseJson() {
   skipWhiteSpace("Expecting item"); // return value intentionally not checked
 
@@ -566,3 +616,237 @@ void Parser::parseJson() {
     }
   }
 }
+
+// The following functions implement the second stage of the two-stage
+// parse. The first stage (JSONStructuralIndex) has recorded the positions
+// of all structural characters, quotes and starts of other scalar values,
+// so whitespace does not need to be looked at again, and the length of
+// strings without escape sequences is known before they are copied.
+// Scalar values are handed to the regular parse functions. Everything
+// produces the same results and errors as the regular parse.
+
+bool Parser::buildStructuralIndex() {
+  if (_size >= JSONStructuralNeedsSlowPath) {
+    // positions, which are absolute, and the sentinel do not fit into
+    // the index. use the regular parse
+    return false;
+  }
+  std::size_t const remaining = _size - _pos;
+  // the index is only grown and kept until releaseStructuralIndex() is
+  // called, so that subsequent parses do not need to allocate it again.
+  // it is not initialized, as it is filled up to the sentinel
+  if (_structuralsCapacity < remaining + 1) {
+    _structurals.reset();
+    _structuralsCapacity = 0;
+    _structurals.reset(new uint32_t[remaining + 1]);
+    _structuralsCapacity = remaining + 1;
+  }
+  std::size_t n = JSONStructuralIndex(_start + _pos, remaining,
+                                      _structurals.get(),
+                                      static_cast<uint32_t>(_pos),
+                                      options->validateUtf8Strings);
+  // sentinel
+  _structurals[n] = static_cast<uint32_t>(_size);
+  _structuralPos = 0;
+  return true;
+}
+
+// moves to the next structural token and returns its character, or -1
+// at the end of input. the bytes in front of the next token can only be
+// whitespace, or the remainder of a malformed scalar value directly
+// following a scalar value. in the latter case, the byte is returned and
+// the position is left on it
+int Parser::nextStructural() {
+  std::size_t const next =
+      _structurals[_structuralPos] & ~JSONStructuralNeedsSlowPath;
+  VELOCYPACK_ASSERT(_pos <= next);
+  if (_pos < next) {
+    if (VELOCYPACK_UNLIKELY(!isWhiteSpace(_start[_pos]))) {
+      return static_cast<int>(_start[_pos]);
+    }
+    // any non-whitespace byte after whitespace would have been a token
+    _pos = next;
+  }
+  if (next >= _size) {
+    return -1;
+  }
+  return static_cast<int>(_start[next]);
+}
+
+void Parser::parseStringIndexed(uint32_t token) {
+  // we are positioned behind the opening quote. the next token is the
+  // closing quote
+  if ((token & JSONStructuralNeedsSlowPath) != 0) {
+    // escape sequences, control characters, UTF-8 to validate or
+    // unterminated
+    parseString();
+    VELOCYPACK_ASSERT(_pos == _structurals[_structuralPos] + 1);
+    ++_structuralPos;
+    return;
+  }
+
+  std::size_t const end = _structurals[_structuralPos];
+  ValueLength const len = end - _pos;
+  if (len <= 126) {
+    _builderPtr->reserve(1 + len);
+    _builderPtr->appendByteUnchecked(0x40 + static_cast<uint8_t>(len));
+  } else {
+    _builderPtr->reserve(9 + len);
+    _builderPtr->appendByteUnchecked(0xbf);
+    _builderPtr->appendLengthUnchecked<8>(len);
+  }
+  memcpy(_builderPtr->_start + _builderPtr->_pos, _start + _pos, checkOverflow(len));
+  _builderPtr->advance(len);
+  _pos = end;
+  consumeStructural();  // the closing '"'
+}
+
+void Parser::parseArrayIndexed() {
+  _builderPtr->addArray();
+
+  int i = nextStructural();
+  if (i == ']') {
+    // empty array
+    consumeStructural();  // the closing ']'
+    _builderPtr->close();
+    return;
+  }
+  if (VELOCYPACK_UNLIKELY(i < 0)) {
+    throw Exception(Exception::ParseError, "Expecting item or ']'");
+  }
+
+  increaseNesting();
+
+  while (true) {
+    // parse array element itself
+    _builderPtr->reportAdd();
+    parseJsonIndexed();
+    i = nextStructural();
+    if (i == ']') {
+      // end of array
+      consumeStructural();  // the closing ']'
+      _builderPtr->close();
+      decreaseNesting();
+      return;
+    }
+    if (VELOCYPACK_UNLIKELY(i != ',')) {
+      throw Exception(Exception::ParseError, "Expecting ',' or ']'");
+    }
+    consumeStructural();  // the ','
+  }
+
+  // should never get here
+  VELOCYPACK_ASSERT(false);
+}
+
+void Parser::parseObjectIndexed() {
+  _builderPtr->addObject();
+
+  int i = nextStructural();
+  if (i == '}') {
+    // empty object
+    consumeStructural();  // the closing '}'
+
+    if (_nesting != 0 || !options->keepTopLevelOpen) {
+      // only close if we've not been asked to keep top level open
+      _builderPtr->close();
+    }
+    return;
+  }
+  if (VELOCYPACK_UNLIKELY(i < 0)) {
+    throw Exception(Exception::ParseError, "Expecting item or '}'");
+  }
+
+  increaseNesting();
+
+  while (true) {
+    // always expecting a string attribute name here
+    if (VELOCYPACK_UNLIKELY(i != '"')) {
+      throw Exception(Exception::ParseError, "Expecting '\"' or '}'");
+    }
+    uint32_t const token = _structurals[_structuralPos];
+    consumeStructural();  // the initial '"'
+
+    _builderPtr->reportAdd();
+    auto const lastPos = _builderPtr->_pos;
+    parseStringIndexed(token);
+    translateAttributeName(lastPos);
+
+    i = nextStructural();
+    // always expecting the ':' here
+    if (VELOCYPACK_UNLIKELY(i != ':')) {
+      throw Exception(Exception::ParseError, "Expecting ':'");
+    }
+    consumeStructural();  // the colon
+
+    parseJsonIndexed();
+
+    i = nextStructural();
+    if (i == '}') {
+      // end of object
+      consumeStructural();  // the closing '}'
+      if (_nesting != 1 || !options->keepTopLevelOpen) {
+        // only close if we've not been asked to keep top level open
+        _builderPtr->close();
+      }
+      decreaseNesting();
+      return;
+    }
+    if (VELOCYPACK_UNLIKELY(i != ',')) {
+      throw Exception(Exception::ParseError, "Expecting ',' or '}'");
+    }
+    consumeStructural();  // the ','
+    i = nextStructural();
+    if (VELOCYPACK_UNLIKELY(i < 0)) {
+      throw Exception(Exception::ParseError, "Expecting '\"' or '}'");
+    }
+  }
+
+  // should never get here
+  VELOCYPACK_ASSERT(false);
+}
+
+void Parser::parseJsonIndexed() {
+  int i = nextStructural();
+  if (VELOCYPACK_UNLIKELY(i < 0)) {
+    throw Exception(Exception::ParseError, "Expecting item");
+  }
+
+  uint32_t const token = _structurals[_structuralPos];
+  if (VELOCYPACK_LIKELY(_pos == (token & ~JSONStructuralNeedsSlowPath))) {
+    ++_structuralPos;
+  } else {
+    // a byte directly following a scalar value (only possible when parsing
+    // multiple values). it cannot be a structural character or a quote,
+    // so it is handled by one of the scalar cases below, as in parseJson()
+    VELOCYPACK_ASSERT(i != '{' && i != '[' && i != '"');
+  }
+  ++_pos;
+
+  switch (i) {
+    case '{':
+      parseObjectIndexed();  // this consumes the closing '}' or throws
+      break;
+    case '[':
+      parseArrayIndexed();  // this consumes the closing ']' or throws
+      break;
+    case 't':
+      parseTrue();  // this consumes "rue" or throws
+      break;
+    case 'f':
+      parseFalse();  // this consumes "alse" or throws
+      break;
+    case 'n':
+      parseNull();  // this consumes "ull" or throws
+      break;
+    case '"':
+      parseStringIndexed(token);
+      break;
+    default: {
+      // everything else must be a number or is invalid
+      unconsume();
+      parseNumber();  // this consumes the number or throws
+      break;
+    }
+  }
+}
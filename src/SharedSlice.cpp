@@ -47,8 +47,9 @@ std::shared_ptr<uint8_t const> SharedSlice::copyBuffer(Buffer<uint8_t> const& bu
 }
 
 std::shared_ptr<uint8_t const> SharedSlice::stealBuffer(Buffer<uint8_t>&& buffer) {
-  // If the buffer doesn't use memory on the heap, we have to copy it.
-  if (buffer.usesLocalMemory()) {
+  // If the buffer doesn't use memory on the heap, or its memory belongs
+  // to a memory resource, we have to copy it.
+  if (buffer.usesLocalMemory() || buffer.memoryResource() != nullptr) {
     return copyBuffer(buffer);
   }
   // Buffer uses velocypack_malloc/velocypack_free for memory management
@@ -25,15 +25,19 @@
 #include <ostream>
 
 #include "velocypack/velocypack-common.h"
+#include "velocypack/AttributeSet.h"
 #include "velocypack/AttributeTranslator.h"
 #include "velocypack/Builder.h"
+#include "velocypack/CompiledPath.h"
 #include "velocypack/Dumper.h"
 #include "velocypack/HexDump.h"
 #include "velocypack/Iterator.h"
 #include "velocypack/Parser.h"
 #include "velocypack/Sink.h"
 #include "velocypack/Slice.h"
+#include "velocypack/SmallVector.h"
 #include "velocypack/ValueType.h"
+#include "hash-index.h"
 
 using namespace arangodb::velocypack;
 
@@ -126,15 +130,12 @@ std::string Slice::toHex() const {
 
 std::string Slice::toJson(Options const* options) const {
   std::string buffer;
-  StringSink sink(&buffer);
-  toJson(&sink, options);
+  toJson(buffer, options);
   return buffer;
 }
 
 std::string& Slice::toJson(std::string& out, Options const* options) const {
-  StringSink sink(&out);
-  toJson(&sink, options);
-  return out;
+  return Dumper::dumpAppend(out, *this, options);
 }
 
 void Slice::toJson(Sink* sink, Options const* options) const {
@@ -151,10 +152,7 @@ std::string Slice::toString(Options const* options) const {
   Options prettyOptions = *options;
   prettyOptions.prettyPrint = true;
 
-  std::string buffer;
-  StringSink sink(&buffer);
-  Dumper::dump(this, &sink, &prettyOptions);
-  return buffer;
+  return Dumper::toString(this, &prettyOptions);
 }
 
 std::string Slice::hexType() const { return HexDump::toHex(head()); }
@@ -163,8 +161,12 @@ uint64_t Slice::normalizedHash(uint64_t seed) const {
   uint64_t value;
 
   if (isNumber()) {
-    // upcast integer values to double
+    // upcast integer values to double. -0.0 is equal to 0.0, so it
+    // must have the same hash
     double v = getNumericValue<double>();
+    if (v == 0.0) {
+      v = 0.0;
+    }
     value = VELOCYPACK_HASH(&v, sizeof(v), seed);
   } else if (isArray()) {
     // normalize arrays by hashing array length and iterating
@@ -202,8 +204,12 @@ uint32_t Slice::normalizedHash32(uint32_t seed) const {
   uint32_t value;
 
   if (isNumber()) {
-    // upcast integer values to double
+    // upcast integer values to double. -0.0 is equal to 0.0, so it
+    // must have the same hash
     double v = getNumericValue<double>();
+    if (v == 0.0) {
+      v = 0.0;
+    }
     value = VELOCYPACK_HASH32(&v, sizeof(v), seed);
   } else if (isArray()) {
     // normalize arrays by hashing array length and iterating
@@ -270,6 +276,12 @@ Slice Slice::get(std::string_view attribute) const {
     ieBase = end - n * offsetSize - offsetSize;
   }
 
+  if (h == 0x15) {
+    // Object with hash table
+    return searchObjectKeyHashed(attribute, hashIndexKey(attribute.data(), attribute.size()),
+                                 ieBase, n);
+  }
+
   if (n == 1) {
     // Just one attribute, there is no index table!
     Slice key(start() + findDataOffset(h));
@@ -314,6 +326,12 @@ Slice Slice::get(std::string_view attribute) const {
   return searchObjectKeyLinear(attribute, ieBase, offsetSize, n);
 }
 
+// look for the specified precompiled attribute path inside an Object
+// returns a Slice(ValueType::None) if not found
+Slice Slice::get(CompiledPath const& path, bool resolveExternals) const {
+  return path.get(*this, resolveExternals);
+}
+
 // return the value for an Int object
 int64_t Slice::getIntUnchecked() const noexcept {
   uint8_t const h = head();
@@ -483,6 +501,24 @@ Slice Slice::getFromCompactObject(std::string_view attribute) const {
   return Slice();
 }
 
+// get the total byte size for the types that Slice::byteSize() cannot
+// look up from its tables
+ValueLength Slice::byteSizeDynamic(uint8_t const* start) const {
+  uint8_t const h = *start;
+
+  if (h == 0x13 || h == 0x14) {
+    // compact Array or Object
+    return readVariableValueLength<false>(start + 1);
+  }
+
+  if (type(h) == ValueType::Tagged) {
+    uint8_t offset = tagsOffset(start);
+    return byteSize(start + offset) + offset;
+  }
+
+  throw Exception(Exception::InternalError, "Invalid type for byteSize()");
+}
+
 // get the offset for the nth member from an Array or Object type
 ValueLength Slice::getNthOffset(ValueLength index) const {
   VELOCYPACK_ASSERT(isArray() || isObject());
@@ -684,6 +720,299 @@ Slice Slice::searchObjectKeyBinary(std::string_view attribute,
   return Slice();
 }
 
+// look up an attribute in the hash table of an Object of type 0x15,
+// which sits right in front of the index table at ieBase. all keys of
+// such Objects are strings
+Slice Slice::searchObjectKeyHashed(std::string_view attribute,
+                                   uint64_t hash,
+                                   ValueLength ieBase,
+                                   ValueLength n) const {
+  ValueLength const position = findObjectKeyHashed(attribute, hash, ieBase, n);
+  if (position >= n) {
+    return Slice();
+  }
+  Slice key(start() + readIntegerFixed<ValueLength, 4>(start() + ieBase + position * 4));
+  return Slice(key.start() + key.byteSize());
+}
+
+// returns the position of an attribute in the index table of an Object
+// of type 0x15, or n if the Object does not contain the attribute
+ValueLength Slice::findObjectKeyHashed(std::string_view attribute,
+                                       uint64_t hash,
+                                       ValueLength ieBase,
+                                       ValueLength n) const {
+  VELOCYPACK_ASSERT(head() == 0x15);
+  VELOCYPACK_ASSERT(n > 0);
+
+  ValueLength const slots = hashIndexSlots(n);
+  uint8_t const* table = start() + ieBase - slots * 4;
+  uint32_t const fingerprint = hashIndexFingerprint(hash);
+  ValueLength slot = hash & (slots - 1);
+
+  // there is always at least one empty slot, but don't trust the data
+  for (ValueLength i = 0; i < slots; ++i) {
+    uint32_t const entry = readIntegerFixed<uint32_t, 4>(table + slot * 4);
+    if (entry == 0) {
+      // empty slot: attribute not present
+      break;
+    }
+    ValueLength const position = (entry & 0xffffffU) - 1;
+    if ((entry >> 24) == fingerprint && position < n) {
+      Slice key(start() + readIntegerFixed<ValueLength, 4>(start() + ieBase + position * 4));
+      if (key.isString() && key.isEqualStringUnchecked(attribute)) {
+        return position;
+      }
+    }
+    slot = (slot + 1) & (slots - 1);
+  }
+
+  return n;
+}
+
+namespace {
+
+// attribute names of an AttributeSet, already sorted and hashed
+struct PreparedKeys {
+  std::string const* keys;
+  uint64_t const* hashes;
+  std::size_t const* targets;
+  std::size_t count;
+
+  std::size_t size() const noexcept { return count; }
+  std::string_view key(std::size_t i) const noexcept { return keys[i]; }
+  uint64_t hash(std::size_t i) const noexcept { return hashes[i]; }
+  std::size_t target(std::size_t i) const noexcept { return targets[i]; }
+};
+
+// attribute names passed to getMany() directly, in sorted order of their
+// positions
+struct UnpreparedKeys {
+  std::string_view const* keys;
+  std::size_t const* positions;
+  std::size_t count;
+
+  std::size_t size() const noexcept { return count; }
+  std::string_view key(std::size_t i) const noexcept { return keys[positions[i]]; }
+  uint64_t hash(std::size_t i) const noexcept {
+    return hashIndexKey(key(i).data(), key(i).size());
+  }
+  std::size_t target(std::size_t i) const noexcept { return positions[i]; }
+};
+
+}  // namespace
+
+void Slice::getMany(std::string_view const* keys, std::size_t count, Slice* out) const {
+  constexpr std::size_t arenaSize = 32 * sizeof(std::size_t);
+
+  // sort positions by attribute name. duplicates stay in their original
+  // order, so that the first occurrence of each name comes first
+  SmallVector<std::size_t, arenaSize>::allocator_type::arena_type orderArena;
+  SmallVector<std::size_t, arenaSize> order{orderArena};
+  order.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    order.push_back(i);
+  }
+  std::sort(order.begin(), order.end(), [keys](std::size_t a, std::size_t b) {
+    int res = keys[a].compare(keys[b]);
+    return res < 0 || (res == 0 && a < b);
+  });
+
+  SmallVector<std::size_t, arenaSize>::allocator_type::arena_type uniqueArena;
+  SmallVector<std::size_t, arenaSize> unique{uniqueArena};
+  unique.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i == 0 || keys[order[i]] != keys[order[i - 1]]) {
+      unique.push_back(order[i]);
+    }
+  }
+
+  getManySorted(UnpreparedKeys{keys, unique.data(), unique.size()}, out);
+
+  // duplicates get the value of the first occurrence
+  for (std::size_t i = 1; i < count; ++i) {
+    if (keys[order[i]] == keys[order[i - 1]]) {
+      out[order[i]] = out[order[i - 1]];
+    }
+  }
+}
+
+void Slice::getMany(AttributeSet const& keys, Slice* out) const {
+  getManySorted(PreparedKeys{keys._keys.data(), keys._hashes.data(),
+                             keys._targets.data(), keys._keys.size()},
+                out);
+
+  // duplicates get the value of the first occurrence
+  for (auto const& it : keys._duplicates) {
+    out[it.first] = out[it.second];
+  }
+}
+
+template<ValueLength offsetSize, typename Keys>
+void Slice::searchObjectKeysMerge(Keys const& keys, Slice* out,
+                                  ValueLength ieBase, ValueLength n) const {
+  // the index table is sorted by attribute name, and so are the attribute
+  // names we look for. so we can walk through both in parallel, and skip
+  // over parts of the index table by searching exponentially followed by
+  // a binary search
+  bool const useTranslator = (Options::Defaults.attributeTranslator != nullptr);
+
+  auto compareAt = [&](ValueLength index, std::string_view attribute) {
+    Slice key(start() + readIntegerFixed<ValueLength, offsetSize>(
+                            start() + ieBase + index * offsetSize));
+    if (key.isString()) {
+      return key.compareStringUnchecked(attribute);
+    }
+    VELOCYPACK_ASSERT(key.isSmallInt() || key.isUInt());
+    if (VELOCYPACK_UNLIKELY(!useTranslator)) {
+      throw Exception(Exception::NeedAttributeTranslator);
+    }
+    return key.translateUnchecked().compareString(attribute);
+  };
+
+  ValueLength low = 0;
+  for (std::size_t i = 0; i < keys.size() && low < n; ++i) {
+    std::string_view const attribute = keys.key(i);
+
+    // find a high bound with a name not less than the attribute
+    ValueLength high = low;
+    ValueLength step = 1;
+    int res = -1;
+    while (high < n && (res = compareAt(high, attribute)) < 0) {
+      low = high + 1;
+      high = low + step;
+      step *= 2;
+    }
+    if (high >= n) {
+      high = n;
+      res = -1;
+    }
+    if (res == 0) {
+      // exact match at the high bound, nothing in front of it can match
+      low = high;
+    } else {
+      // find the first name not less than the attribute
+      while (low < high) {
+        ValueLength mid = low + (high - low) / 2;
+        if (compareAt(mid, attribute) < 0) {
+          low = mid + 1;
+        } else {
+          high = mid;
+        }
+      }
+      if (low >= n || compareAt(low, attribute) != 0) {
+        // not found
+        continue;
+      }
+    }
+
+    Slice key(start() + readIntegerFixed<ValueLength, offsetSize>(
+                            start() + ieBase + low * offsetSize));
+    out[keys.target(i)] = Slice(key.start() + key.byteSize());
+    ++low;
+  }
+}
+
+template<typename Keys>
+void Slice::getManySorted(Keys const& keys, Slice* out) const {
+  if (VELOCYPACK_UNLIKELY(!isObject())) {
+    throw Exception(Exception::InvalidValueType, "Expecting Object");
+  }
+
+  std::size_t const m = keys.size();
+  for (std::size_t i = 0; i < m; ++i) {
+    out[keys.target(i)] = Slice();
+  }
+
+  auto const h = head();
+  if (h == 0x0a || m == 0) {
+    // empty object or nothing to look up
+    return;
+  }
+
+  // returns the name of an attribute, translating integer keys
+  auto name = [](Slice key) -> std::string_view {
+    if (key.isString()) {
+      return key.stringView();
+    }
+    VELOCYPACK_ASSERT(key.isSmallInt() || key.isUInt());
+    if (VELOCYPACK_UNLIKELY(Options::Defaults.attributeTranslator == nullptr)) {
+      throw Exception(Exception::NeedAttributeTranslator);
+    }
+    return key.translateUnchecked().stringView();
+  };
+
+  if (h == 0x15) {
+    // Object with hash table
+    ValueLength const end = readIntegerFixed<ValueLength, 4>(start() + 1);
+    ValueLength const n = readIntegerFixed<ValueLength, 4>(start() + 1 + 4);
+    ValueLength const ieBase = end - n * 4;
+    for (std::size_t i = 0; i < m; ++i) {
+      out[keys.target(i)] = searchObjectKeyHashed(keys.key(i), keys.hash(i), ieBase, n);
+    }
+    return;
+  }
+
+  if (h >= 0x0b && h <= 0x0e) {
+    ValueLength const offsetSize = indexEntrySize(h);
+    ValueLength const end = readIntegerNonEmpty<ValueLength>(start() + 1, offsetSize);
+    ValueLength n;
+    ValueLength ieBase;
+    if (offsetSize < 8) {
+      n = readIntegerNonEmpty<ValueLength>(start() + 1 + offsetSize, offsetSize);
+      ieBase = end - n * offsetSize;
+    } else {
+      n = readIntegerNonEmpty<ValueLength>(start() + end - offsetSize, offsetSize);
+      ieBase = end - n * offsetSize - offsetSize;
+    }
+
+    if (n > 1) {
+      switch (offsetSize) {
+        case 1:
+          return searchObjectKeysMerge<1>(keys, out, ieBase, n);
+        case 2:
+          return searchObjectKeysMerge<2>(keys, out, ieBase, n);
+        case 4:
+          return searchObjectKeysMerge<4>(keys, out, ieBase, n);
+        case 8:
+          return searchObjectKeysMerge<8>(keys, out, ieBase, n);
+        default: {}
+      }
+    }
+  }
+
+  // no index table we can use, so scan over all members once and look
+  // up each attribute name in the sorted list
+  ValueLength const n = objectLength();
+  uint8_t const* p = start() + (h == 0x14 ? getStartOffsetFromCompact() : findDataOffset(h));
+  std::size_t found = 0;
+  for (ValueLength i = 0; i < n && found < m; ++i) {
+    Slice key(p);
+    Slice value(p + key.byteSize());
+    std::string_view const attribute = name(key);
+
+    std::size_t low = 0;
+    std::size_t high = m;
+    while (low < high) {
+      std::size_t mid = low + (high - low) / 2;
+      if (keys.key(mid).compare(attribute) < 0) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    if (low < m && keys.key(low) == attribute) {
+      Slice& result = out[keys.target(low)];
+      if (result.isNone()) {
+        // the first occurrence wins, as with get()
+        result = value;
+        ++found;
+      }
+    }
+
+    p = value.start() + value.byteSize();
+  }
+}
+
 // template instanciations for searchObjectKeyBinary
 template Slice Slice::searchObjectKeyBinary<1>(std::string_view attribute, ValueLength ieBase, ValueLength n) const;
 template Slice Slice::searchObjectKeyBinary<2>(std::string_view attribute, ValueLength ieBase, ValueLength n) const;
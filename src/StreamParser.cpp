@@ -0,0 +1,787 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "velocypack/velocypack-common.h"
+#include "velocypack/StreamParser.h"
+#include "velocypack/Parser.h"
+#include "velocypack/AttributeTranslator.h"
+#include "velocypack/Slice.h"
+#include "asm-functions.h"
+#include "fast-float.h"
+
+using namespace arangodb::velocypack;
+
+namespace {
+
+constexpr std::size_t noErrorPos = std::numeric_limits<std::size_t>::max();
+
+uint8_t const bom[] = {0xef, 0xbb, 0xbf};
+
+inline bool isDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+}  // namespace
+
+StreamParser::StreamParser(Options const* options, bool multi)
+    : options(options) {
+  if (VELOCYPACK_UNLIKELY(options == nullptr)) {
+    throw Exception(Exception::InternalError, "Options cannot be a nullptr");
+  }
+  _builder = std::make_shared<Builder>();
+  _builderPtr = _builder.get();
+  _builderPtr->options = options;
+  reset(multi);
+}
+
+StreamParser::StreamParser(std::shared_ptr<Builder> const& builder,
+                           Options const* options, bool multi)
+    : _builder(builder),
+      _builderPtr(_builder.get()),
+      options(options) {
+  if (VELOCYPACK_UNLIKELY(options == nullptr)) {
+    throw Exception(Exception::InternalError, "Options cannot be a nullptr");
+  }
+  reset(multi);
+}
+
+StreamParser::StreamParser(Builder& builder, Options const* options,
+                           bool multi)
+    : options(options) {
+  if (VELOCYPACK_UNLIKELY(options == nullptr)) {
+    throw Exception(Exception::InternalError, "Options cannot be a nullptr");
+  }
+  _builder.reset(&builder, BuilderNonDeleter());
+  _builderPtr = _builder.get();
+  reset(multi);
+}
+
+void StreamParser::reset(bool multi) {
+  _nesting.clear();
+  _offset = 0;
+  _errorPos = 0;
+  _count = 0;
+  _state = State::Value;
+  _multi = multi;
+  _started = false;
+  _bomPos = 0;
+  _haveReported = false;
+  _isKey = false;
+  _large = false;
+  _pendingCount = 0;
+  _stringBase = 0;
+  _highSurrogate = 0;
+  _unicodeValue = 0;
+  _tokenStart = 0;
+  _numberState = NumberState::Sign;
+  _literal = nullptr;
+  _token.clear();
+}
+
+void StreamParser::start() {
+  if (VELOCYPACK_UNLIKELY(_builderPtr == nullptr)) {
+    throw Exception(Exception::InternalError, "StreamParser has no Builder");
+  }
+  if (!_started) {
+    _started = true;
+    if (options->clearBuilderBeforeParse) {
+      _builderPtr->clear();
+    }
+  }
+}
+
+void StreamParser::feed(uint8_t const* data, std::size_t size) {
+  start();
+
+  std::size_t pos = 0;
+  _errorPos = noErrorPos;
+  try {
+    parseChunk(data, size, pos);
+  } catch (...) {
+    if (_errorPos == noErrorPos) {
+      _errorPos = _offset + (pos > 0 ? pos - 1 : 0);
+    }
+    if (_haveReported) {
+      _builderPtr->cleanupAdd();
+      _haveReported = false;
+    }
+    throw;
+  }
+  _offset += size;
+}
+
+ValueLength StreamParser::finish() {
+  start();
+
+  _errorPos = noErrorPos;
+  try {
+    if (_state == State::Number) {
+      // the end of input terminates the number
+      finishNumber();
+    }
+    if (_state != State::Done) {
+      throwUnfinished();
+    }
+  } catch (...) {
+    if (_errorPos == noErrorPos) {
+      _errorPos = _offset > 0 ? _offset - 1 : 0;
+    }
+    if (_haveReported) {
+      _builderPtr->cleanupAdd();
+      _haveReported = false;
+    }
+    throw;
+  }
+  return _count;
+}
+
+void StreamParser::throwUnfinished() {
+  switch (_state) {
+    case State::Value:
+    case State::ArrayValue:
+      throw Exception(Exception::ParseError, "Expecting item");
+    case State::ArrayStart:
+      throw Exception(Exception::ParseError, "Expecting item or ']'");
+    case State::ArrayNext:
+      throw Exception(Exception::ParseError, "Expecting ',' or ']'");
+    case State::ObjectStart:
+      throw Exception(Exception::ParseError, "Expecting item or '}'");
+    case State::ObjectKey:
+      throw Exception(Exception::ParseError, "Expecting '\"' or '}'");
+    case State::ObjectColon:
+      throw Exception(Exception::ParseError, "Expecting ':'");
+    case State::ObjectNext:
+      throw Exception(Exception::ParseError, "Expecting ',' or '}'");
+    case State::String:
+      throw Exception(Exception::ParseError, "Unfinished string");
+    case State::StringEscape:
+      throw Exception(Exception::ParseError, "Invalid escape sequence");
+    case State::StringUnicode:
+      throw Exception(Exception::ParseError,
+                      "Unfinished \\uXXXX escape sequence");
+    case State::StringUtf8:
+      throw Exception(Exception::ParseError,
+                      "scanString: truncated UTF-8 sequence");
+    case State::Literal:
+      continueLiteral(0);  // throws
+      break;
+    case State::Number:
+    case State::Done:
+      break;
+  }
+  throw Exception(Exception::InternalError, "invalid StreamParser state");
+}
+
+void StreamParser::parseChunk(uint8_t const* data, std::size_t size,
+                              std::size_t& pos) {
+  while (pos < size) {
+    switch (_state) {
+      case State::String:
+        continueString(data, size, pos);
+        continue;
+      case State::StringEscape:
+        continueEscape(data[pos++]);
+        continue;
+      case State::StringUnicode:
+        continueUnicode(data[pos++]);
+        continue;
+      case State::StringUtf8:
+        continueUtf8(data[pos++]);
+        continue;
+      case State::Number:
+        continueNumber(data, size, pos);
+        continue;
+      case State::Literal:
+        continueLiteral(data[pos++]);
+        continue;
+      default:
+        break;
+    }
+
+    // all remaining states skip over whitespace
+    uint8_t c = data[pos++];
+    if (isWhiteSpace(c)) {
+      continue;
+    }
+
+    switch (_state) {
+      case State::Value:
+        if (_nesting.empty()) {
+          if (_count == 0 && _bomPos < sizeof(bom) &&
+              _offset + pos - 1 == _bomPos) {
+            // skip over an optional BOM at the very beginning
+            if (c == bom[_bomPos]) {
+              ++_bomPos;
+              continue;
+            }
+            if (_bomPos > 0) {
+              throw Exception(Exception::ParseError, "Expecting item");
+            }
+            _bomPos = sizeof(bom);
+          }
+          beginTopLevel();
+        }
+        beginValue(c, _offset + pos - 1);
+        break;
+      case State::ArrayStart:
+        if (c == ']') {
+          closeArray();
+          break;
+        }
+        _builderPtr->reportAdd();
+        beginValue(c, _offset + pos - 1);
+        break;
+      case State::ArrayValue:
+        _builderPtr->reportAdd();
+        beginValue(c, _offset + pos - 1);
+        break;
+      case State::ArrayNext:
+        if (c == ',') {
+          _state = State::ArrayValue;
+        } else if (c == ']') {
+          closeArray();
+        } else {
+          throw Exception(Exception::ParseError, "Expecting ',' or ']'");
+        }
+        break;
+      case State::ObjectStart:
+        if (c == '}') {
+          closeObject();
+          break;
+        }
+        [[fallthrough]];
+      case State::ObjectKey:
+        if (VELOCYPACK_UNLIKELY(c != '"')) {
+          throw Exception(Exception::ParseError, "Expecting '\"' or '}'");
+        }
+        _builderPtr->reportAdd();
+        beginString(true);
+        break;
+      case State::ObjectColon:
+        if (VELOCYPACK_UNLIKELY(c != ':')) {
+          throw Exception(Exception::ParseError, "Expecting ':'");
+        }
+        _state = State::Value;
+        break;
+      case State::ObjectNext:
+        if (c == ',') {
+          _state = State::ObjectKey;
+        } else if (c == '}') {
+          closeObject();
+        } else {
+          throw Exception(Exception::ParseError, "Expecting ',' or '}'");
+        }
+        break;
+      case State::Done:
+        if (!_multi) {
+          throw Exception(Exception::ParseError, "Expecting EOF");
+        }
+        // start of the next top-level value
+        beginTopLevel();
+        beginValue(c, _offset + pos - 1);
+        break;
+      default:
+        VELOCYPACK_ASSERT(false);
+        break;
+    }
+  }
+}
+
+void StreamParser::beginTopLevel() {
+  // same handling of an already open compound value in the Builder as
+  // in Parser::parseInternal
+  _haveReported = false;
+  if (!_builderPtr->_stack.empty()) {
+    ValueLength const tos = _builderPtr->_stack.back().startPos;
+    if (_builderPtr->_start[tos] == 0x0b || _builderPtr->_start[tos] == 0x14) {
+      if (!_builderPtr->_keyWritten) {
+        throw Exception(Exception::BuilderKeyMustBeString);
+      } else {
+        _builderPtr->_keyWritten = false;
+      }
+    } else {
+      _builderPtr->reportAdd();
+      _haveReported = true;
+    }
+  }
+}
+
+void StreamParser::beginValue(uint8_t c, std::size_t position) {
+  switch (c) {
+    case '{':
+      _builderPtr->addObject();
+      _nesting.push_back(true);
+      _state = State::ObjectStart;
+      break;
+    case '[':
+      _builderPtr->addArray();
+      _nesting.push_back(false);
+      _state = State::ArrayStart;
+      break;
+    case '"':
+      beginString(false);
+      break;
+    case 't':
+      _literal = "true";
+      _pendingCount = 1;
+      _state = State::Literal;
+      break;
+    case 'f':
+      _literal = "false";
+      _pendingCount = 1;
+      _state = State::Literal;
+      break;
+    case 'n':
+      _literal = "null";
+      _pendingCount = 1;
+      _state = State::Literal;
+      break;
+    default:
+      if (c != '-' && (c < '0' || c > '9')) {
+        throw Exception(Exception::ParseError, "Expecting digit");
+      }
+      // the number is collected and converted once it is complete
+      _tokenStart = position;
+      _numberState = (c == '-') ? NumberState::Sign
+                     : (c == '0') ? NumberState::Zero
+                                  : NumberState::Integer;
+      _token.clear();
+      _token.push_back(static_cast<char>(c));
+      _state = State::Number;
+      break;
+  }
+}
+
+void StreamParser::valueDone() {
+  if (_nesting.empty()) {
+    ++_count;
+    _haveReported = false;
+    _state = State::Done;
+  } else if (_nesting.back()) {
+    _state = State::ObjectNext;
+  } else {
+    _state = State::ArrayNext;
+  }
+}
+
+void StreamParser::closeArray() {
+  _builderPtr->close();
+  _nesting.pop_back();
+  valueDone();
+}
+
+void StreamParser::closeObject() {
+  if (_nesting.size() != 1 || !options->keepTopLevelOpen) {
+    // only close if we've not been asked to keep top level open
+    _builderPtr->close();
+  }
+  _nesting.pop_back();
+  valueDone();
+}
+
+void StreamParser::beginString(bool isKey) {
+  // the string is copied into the Builder as it arrives. as in
+  // Parser::parseString, we assume that the string is short and insert
+  // 8 bytes for the length as soon as we reach 127 bytes
+  _isKey = isKey;
+  _large = false;
+  _highSurrogate = 0;
+  _stringBase = _builderPtr->_pos;
+  _builderPtr->appendByte(0x40);  // correct this later
+  _state = State::String;
+}
+
+void StreamParser::continueString(uint8_t const* data, std::size_t size,
+                                  std::size_t& pos) {
+  while (pos < size) {
+    std::size_t remainder = size - pos;
+    if (remainder >= 16) {
+      _builderPtr->reserve(remainder);
+      std::size_t count;
+      // the SSE4.2 accelerated string copying functions might peek up
+      // to 15 bytes over the given end, see Parser::parseString
+      if (options->validateUtf8Strings) {
+        count = JSONStringCopyCheckUtf8(_builderPtr->_start + _builderPtr->_pos,
+                                        data + pos, remainder - 15);
+      } else {
+        count = JSONStringCopy(_builderPtr->_start + _builderPtr->_pos,
+                               data + pos, remainder - 15);
+      }
+      pos += count;
+      _builderPtr->advance(count);
+      if (count > 0) {
+        _highSurrogate = 0;
+      }
+    }
+    if (!_large && _builderPtr->_pos - (_stringBase + 1) > 126) {
+      _large = true;
+      _builderPtr->reserve(8);
+      ValueLength len = _builderPtr->_pos - (_stringBase + 1);
+      memmove(_builderPtr->_start + _stringBase + 9,
+              _builderPtr->_start + _stringBase + 1, checkOverflow(len));
+      _builderPtr->advance(8);
+    }
+
+    uint8_t c = data[pos++];
+    switch (c) {
+      case '"':
+        finishString();
+        return;
+      case '\\':
+        _state = State::StringEscape;
+        return;
+      default:
+        if ((c & 0x80) == 0) {
+          // non-UTF-8 sequence
+          if (VELOCYPACK_UNLIKELY(c < 0x20)) {
+            // control character
+            throw Exception(Exception::UnexpectedControlCharacter);
+          }
+          _highSurrogate = 0;
+          _builderPtr->appendByte(c);
+        } else if (!options->validateUtf8Strings) {
+          _highSurrogate = 0;
+          _builderPtr->appendByte(c);
+        } else {
+          // multi-byte UTF-8 sequence!
+          if ((c & 0xe0) == 0x80) {
+            throw Exception(Exception::InvalidUtf8Sequence);
+          } else if ((c & 0xe0) == 0xc0) {
+            // two-byte sequence
+            _pendingCount = 1;
+          } else if ((c & 0xf0) == 0xe0) {
+            // three-byte sequence
+            _pendingCount = 2;
+          } else if ((c & 0xf8) == 0xf0) {
+            // four-byte sequence
+            _pendingCount = 3;
+          } else {
+            throw Exception(Exception::InvalidUtf8Sequence);
+          }
+          _builderPtr->appendByte(c);
+          _state = State::StringUtf8;
+          return;
+        }
+        break;
+    }
+  }
+}
+
+void StreamParser::continueEscape(uint8_t c) {
+  _state = State::String;
+  switch (c) {
+    case '"':
+    case '/':
+    case '\\':
+      _builderPtr->appendByte(c);
+      break;
+    case 'b':
+      _builderPtr->appendByte('\b');
+      break;
+    case 'f':
+      _builderPtr->appendByte('\f');
+      break;
+    case 'n':
+      _builderPtr->appendByte('\n');
+      break;
+    case 'r':
+      _builderPtr->appendByte('\r');
+      break;
+    case 't':
+      _builderPtr->appendByte('\t');
+      break;
+    case 'u':
+      _pendingCount = 0;
+      _unicodeValue = 0;
+      _state = State::StringUnicode;
+      return;
+    default:
+      throw Exception(Exception::ParseError, "Invalid escape sequence");
+  }
+  _highSurrogate = 0;
+}
+
+void StreamParser::continueUnicode(uint8_t c) {
+  uint32_t v = _unicodeValue;
+  if (c >= '0' && c <= '9') {
+    v = (v << 4) + c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    v = (v << 4) + c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'F') {
+    v = (v << 4) + c - 'A' + 10;
+  } else {
+    throw Exception(Exception::ParseError, "Illegal \\uXXXX escape sequence");
+  }
+  _unicodeValue = v;
+  if (++_pendingCount < 4) {
+    return;
+  }
+
+  _state = State::String;
+  if (v < 0x80) {
+    _builderPtr->appendByte(static_cast<uint8_t>(v));
+    _highSurrogate = 0;
+  } else if (v < 0x800) {
+    _builderPtr->reserve(2);
+    _builderPtr->appendByteUnchecked(0xc0 + (v >> 6));
+    _builderPtr->appendByteUnchecked(0x80 + (v & 0x3f));
+    _highSurrogate = 0;
+  } else if (v >= 0xdc00 && v < 0xe000 && _highSurrogate != 0) {
+    // Low surrogate, put the two together:
+    v = 0x10000 + ((_highSurrogate - 0xd800) << 10) + v - 0xdc00;
+    _builderPtr->rollback(3);
+    _builderPtr->reserve(4);
+    _builderPtr->appendByteUnchecked(0xf0 + (v >> 18));
+    _builderPtr->appendByteUnchecked(0x80 + ((v >> 12) & 0x3f));
+    _builderPtr->appendByteUnchecked(0x80 + ((v >> 6) & 0x3f));
+    _builderPtr->appendByteUnchecked(0x80 + (v & 0x3f));
+    _highSurrogate = 0;
+  } else {
+    if (v >= 0xd800 && v < 0xdc00) {
+      // High surrogate:
+      _highSurrogate = v;
+    } else {
+      _highSurrogate = 0;
+    }
+    _builderPtr->reserve(3);
+    _builderPtr->appendByteUnchecked(0xe0 + (v >> 12));
+    _builderPtr->appendByteUnchecked(0x80 + ((v >> 6) & 0x3f));
+    _builderPtr->appendByteUnchecked(0x80 + (v & 0x3f));
+  }
+}
+
+void StreamParser::continueUtf8(uint8_t c) {
+  if ((c & 0xc0) != 0x80) {
+    throw Exception(Exception::InvalidUtf8Sequence);
+  }
+  _builderPtr->appendByte(c);
+  if (--_pendingCount == 0) {
+    _highSurrogate = 0;
+    _state = State::String;
+  }
+}
+
+void StreamParser::finishString() {
+  ValueLength len;
+  if (!_large && _builderPtr->_pos - (_stringBase + 1) > 126) {
+    // escape sequences at the end of the string may have pushed it over
+    // the limit
+    _large = true;
+    _builderPtr->reserve(8);
+    len = _builderPtr->_pos - (_stringBase + 1);
+    memmove(_builderPtr->_start + _stringBase + 9,
+            _builderPtr->_start + _stringBase + 1, checkOverflow(len));
+    _builderPtr->advance(8);
+  }
+  if (!_large) {
+    len = _builderPtr->_pos - (_stringBase + 1);
+    _builderPtr->_start[_stringBase] = 0x40 + static_cast<uint8_t>(len);
+  } else {
+    len = _builderPtr->_pos - (_stringBase + 9);
+    _builderPtr->_start[_stringBase] = 0xbf;
+    for (ValueLength i = 1; i <= 8; i++) {
+      _builderPtr->_start[_stringBase + i] = len & 0xff;
+      len >>= 8;
+    }
+  }
+
+  if (!_isKey) {
+    valueDone();
+    return;
+  }
+
+  if (options->attributeTranslator != nullptr) {
+    // check if a translation for the attribute name exists
+    Slice key(_builderPtr->_start + _stringBase);
+    uint8_t const* translated =
+        options->attributeTranslator->translate(key.stringView());
+
+    if (translated != nullptr) {
+      // found translation... now reset position to old key position
+      // and simply overwrite the existing key with the numeric translation
+      // id
+      _builderPtr->resetTo(_stringBase);
+      _builderPtr->addUInt(Slice(translated).getUInt());
+    }
+  }
+  _state = State::ObjectColon;
+}
+
+void StreamParser::continueNumber(uint8_t const* data, std::size_t size,
+                                  std::size_t& pos) {
+  std::size_t const begin = pos;
+  bool complete = false;
+  while (pos < size && !complete) {
+    uint8_t c = data[pos];
+    bool const digit = (c >= '0' && c <= '9');
+    switch (_numberState) {
+      case NumberState::Sign:
+        // a digit must follow. anything else is made part of the number,
+        // so that converting it reports the error at the right position
+        _numberState = (c == '0') ? NumberState::Zero : NumberState::Integer;
+        complete = !digit;
+        ++pos;
+        continue;
+      case NumberState::Dot:
+        _numberState = NumberState::Fraction;
+        complete = !digit;
+        ++pos;
+        continue;
+      case NumberState::Exponent:
+        if (c == '+' || c == '-') {
+          _numberState = NumberState::ExponentSign;
+          ++pos;
+          continue;
+        }
+        [[fallthrough]];
+      case NumberState::ExponentSign:
+        _numberState = NumberState::ExponentDigits;
+        complete = !digit;
+        ++pos;
+        continue;
+      case NumberState::Integer:
+      case NumberState::Zero:
+      case NumberState::Fraction:
+        if (digit && _numberState != NumberState::Zero) {
+          ++pos;
+        } else if (c == '.' && _numberState != NumberState::Fraction) {
+          _numberState = NumberState::Dot;
+          ++pos;
+        } else if (c == 'e' || c == 'E') {
+          _numberState = NumberState::Exponent;
+          ++pos;
+        } else {
+          complete = true;
+        }
+        continue;
+      case NumberState::ExponentDigits:
+        if (digit) {
+          ++pos;
+          continue;
+        }
+        complete = true;
+        continue;
+    }
+  }
+  _token.append(reinterpret_cast<char const*>(data) + begin, pos - begin);
+  if (complete) {
+    // the byte following a valid number is not consumed here, but by
+    // the next state
+    finishNumber();
+  }
+}
+
+void StreamParser::finishNumber() {
+  // converts the token exactly like Parser::parseNumber does. an invalid
+  // token ends with the offending byte, or with the end of input
+  char const* p = _token.data();
+  std::size_t const size = _token.size();
+  std::size_t i = 0;
+  auto fail = [&](char const* msg) {
+    _errorPos = _tokenStart + (i < size ? i : size - 1);
+    throw Exception(Exception::ParseError, msg);
+  };
+
+  ParsedNumber number;
+  bool const negative = (p[0] == '-');
+  if (negative && ++i == size) {
+    fail("Incomplete number");
+  }
+  if (!isDigit(p[i])) {
+    fail("Expecting digit");
+  }
+  // start of the number, without the sign
+  std::size_t const startPos = i;
+
+  if (p[i] != '0') {
+    for (; i < size && isDigit(p[i]); ++i) {
+      number.addDigit(static_cast<unsigned int>(p[i] - '0'), false);
+    }
+  } else {
+    ++i;
+  }
+  bool integer = true;
+  if (i < size && p[i] == '.') {
+    integer = false;
+    if (++i == size || !isDigit(p[i])) {
+      fail("Incomplete number");
+    }
+    for (; i < size && isDigit(p[i]); ++i) {
+      number.addDigit(static_cast<unsigned int>(p[i] - '0'), true);
+    }
+  }
+  if (i < size && (p[i] == 'e' || p[i] == 'E')) {
+    integer = false;
+    if (++i < size && (p[i] == '+' || p[i] == '-')) {
+      ++i;
+    }
+    if (i == size || !isDigit(p[i])) {
+      fail("Incomplete number");
+    }
+    bool const negativeExponent = (p[i - 1] == '-');
+    int64_t exponent = 0;
+    for (; i < size && isDigit(p[i]); ++i) {
+      exponent = ParsedNumber::addExponentDigit(
+          exponent, static_cast<unsigned int>(p[i] - '0'));
+    }
+    number.exponent += negativeExponent ? -exponent : exponent;
+  }
+
+  // an out-of-range number is reported at its last byte
+  _errorPos = _tokenStart + i - 1;
+  Parser::addNumber(*_builderPtr, number, negative, integer, p + startPos,
+                    i - startPos);
+  _errorPos = noErrorPos;
+  valueDone();
+}
+
+void StreamParser::continueLiteral(uint8_t c) {
+  if (c != static_cast<uint8_t>(_literal[_pendingCount])) {
+    switch (_literal[0]) {
+      case 't':
+        throw Exception(Exception::ParseError, "Expecting 'true'");
+      case 'f':
+        throw Exception(Exception::ParseError, "Expecting 'false'");
+      default:
+        throw Exception(Exception::ParseError, "Expecting 'null'");
+    }
+  }
+  if (_literal[++_pendingCount] != '\0') {
+    return;
+  }
+  switch (_literal[0]) {
+    case 't':
+      _builderPtr->addTrue();
+      break;
+    case 'f':
+      _builderPtr->addFalse();
+      break;
+    default:
+      _builderPtr->addNull();
+      break;
+  }
+  valueDone();
+}
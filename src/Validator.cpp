@@ -22,8 +22,10 @@
 /// @author Jan Steemann
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <unordered_set>
 #include <memory>
+#include <vector>
 
 #include "velocypack/velocypack-common.h"
 #include "velocypack/Validator.h"
@@ -32,6 +34,8 @@
 #include "velocypack/ValueType.h"
 
 #include "asm-functions.h"
+#include "hash-index.h"
+#include "parallel.h"
 
 using namespace arangodb::velocypack;
 
@@ -57,12 +61,77 @@ static ValueLength ReadVariableLengthValue(uint8_t const*& p, uint8_t const* end
   }
   return value;
 }
-  
-Validator::Validator(Options const* options)
-      : options(options), _level(0) {
+
+// returns the byte size of the value at ptr as announced in its first
+// few bytes, or 0 if this cannot be determined cheaply
+static ValueLength AnnouncedByteSize(uint8_t const* ptr, std::size_t length) {
+  uint8_t const head = *ptr;
+  if (SliceStaticData::FixedTypeLengths[head] != 0) {
+    return SliceStaticData::FixedTypeLengths[head];
+  }
+  if ((head >= 0x02U && head <= 0x12U) || head == 0x15U) {
+    ValueLength const width = SliceStaticData::WidthMap[head];
+    if (length > width) {
+      return readIntegerNonEmpty<ValueLength>(ptr + 1, width);
+    }
+  } else if (head == 0xbfU && length > 8) {
+    ValueLength const len = readIntegerFixed<ValueLength, 8>(ptr + 1);
+    if (len < length) {
+      return 1 + 8 + len;
+    }
+  }
+  return 0;
+}
+
+namespace {
+struct LevelGuard {
+  explicit LevelGuard(int& level) noexcept : level(level) { ++level; }
+  ~LevelGuard() { --level; }
+  int& level;
+};
+}  // namespace
+
+Validator::Validator(Options const* options, std::size_t concurrency)
+      : options(options), _level(0), _concurrency(concurrency) {
   if (options == nullptr) {
     throw Exception(Exception::InternalError, "Options cannot be a nullptr");
   }
+  _concurrency = resolveConcurrency(_concurrency);
+}
+
+std::size_t Validator::validateMany(uint8_t const* ptr, std::size_t length) {
+  std::size_t count = 0;
+  uint8_t const* p = ptr;
+  uint8_t const* end = ptr + length;
+
+  if (_concurrency <= 1) {
+    while (p < end) {
+      validate(p, end - p, true);
+      p += Slice(p).byteSize();
+      ++count;
+    }
+    return count;
+  }
+
+  // find the bounds of all values from their headers and validate them
+  // in parallel afterwards
+  std::vector<Task> tasks;
+  while (p < end) {
+    std::size_t const remaining = static_cast<std::size_t>(end - p);
+    ValueLength size = AnnouncedByteSize(p, remaining);
+    if (size == 0) {
+      validate(p, remaining, true);
+      size = Slice(p).byteSize();
+    } else if (size > remaining) {
+      throw Exception(Exception::ValidatorInvalidLength, "Value length is out of bounds");
+    } else {
+      tasks.push_back(Task{p, static_cast<std::size_t>(size), TaskKind::Value});
+    }
+    p += size;
+    ++count;
+  }
+  validateTasks(tasks);
+  return count;
 }
 
 bool Validator::validate(uint8_t const* ptr, std::size_t length, bool isSubPart) {
@@ -121,16 +190,22 @@ bool Validator::validate(uint8_t const* ptr, std::size_t length, bool isSubPart)
     }
 
     case ValueType::Array: {
-      ++_level;
+      LevelGuard guard(_level);
+      if (options->maxValidationDepth != 0 &&
+          static_cast<uint32_t>(_level) > options->maxValidationDepth) {
+        throw Exception(Exception::ValidatorNestingTooDeep);
+      }
       validateArray(ptr, length);
-      --_level;
       break;
     }
 
     case ValueType::Object: {
-      ++_level;
+      LevelGuard guard(_level);
+      if (options->maxValidationDepth != 0 &&
+          static_cast<uint32_t>(_level) > options->maxValidationDepth) {
+        throw Exception(Exception::ValidatorNestingTooDeep);
+      }
       validateObject(ptr, length);
-      --_level;
       break;
     }
 
@@ -316,6 +391,21 @@ void Validator::validateUnindexedArray(uint8_t const* ptr, std::size_t length) {
   e = ptr + length;
   --nrItems;
 
+  if (_concurrency > 1 && byteSize >= minParallelSize && nrItems > 1) {
+    // all members have the same size, so their bounds are known
+    if (itemSize * nrItems > static_cast<ValueLength>(e - p)) {
+      throw Exception(Exception::ValidatorInvalidLength, "Array value is out of bounds");
+    }
+    std::vector<Task> tasks;
+    tasks.reserve(checkOverflow(nrItems));
+    for (ValueLength i = 0; i < nrItems; ++i) {
+      tasks.push_back(Task{p + i * itemSize, static_cast<std::size_t>(itemSize),
+                           TaskKind::Value});
+    }
+    validateTasks(tasks);
+    return;
+  }
+
   while (nrItems > 0) {
     if (p >= e) {
       throw Exception(Exception::ValidatorInvalidLength, "Array value is out of bounds");
@@ -393,6 +483,18 @@ void Validator::validateIndexedArray(uint8_t const* ptr, std::size_t length) {
   }
    
   VELOCYPACK_ASSERT(nrItems > 0); 
+
+  if (_concurrency > 1 && byteSize >= minParallelSize && nrItems > 1) {
+    // the index table contains the start of every member in order
+    std::vector<ValueLength> offsets;
+    offsets.reserve(checkOverflow(nrItems));
+    for (ValueLength pos = 0; pos < nrItems; ++pos) {
+      offsets.push_back(readIntegerNonEmpty<ValueLength>(
+          indexTable + pos * byteSizeLength, byteSizeLength));
+    }
+    validateMembers(ptr, offsets, firstMember - ptr, indexTable - ptr, TaskKind::Value);
+    return;
+  }
   
   ValueLength actualNrItems = 0;
   uint8_t const* member = firstMember;
@@ -422,6 +524,9 @@ void Validator::validateObject(uint8_t const* ptr, std::size_t length) {
   } else if (head >= 0x0bU && head <= 0x12U) {
     // regular object
     validateIndexedObject(ptr, length);
+  } else if (head == 0x15U) {
+    // object with hash table
+    validateHashIndexedObject(ptr, length);
   } else if (head == 0x0aU) {
     // empty object. always valid
   }
@@ -542,6 +647,20 @@ void Validator::validateIndexedObject(uint8_t const* ptr, std::size_t length) {
   }
 
   VELOCYPACK_ASSERT(nrItems > 0);
+
+  if (_concurrency > 1 && byteSize >= minParallelSize && nrItems > 1) {
+    // the index table contains the start of every member, sorted by key
+    std::vector<ValueLength> offsets;
+    offsets.reserve(checkOverflow(nrItems));
+    for (ValueLength pos = 0; pos < nrItems; ++pos) {
+      offsets.push_back(readIntegerNonEmpty<ValueLength>(
+          indexTable + pos * byteSizeLength, byteSizeLength));
+    }
+    std::sort(offsets.begin(), offsets.end());
+    validateMembers(ptr, offsets, firstMember - ptr, indexTable - ptr,
+                    TaskKind::ObjectMember);
+    return;
+  }
   
   ValueLength tableBuf[16];    // Fixed space to save offsets found sequentially
   ValueLength* table = tableBuf;
@@ -637,6 +756,214 @@ void Validator::validateIndexedObject(uint8_t const* ptr, std::size_t length) {
   }
 }
 
+void Validator::validateHashIndexedObject(uint8_t const* ptr, std::size_t length) {
+  // Object with 4-byte index table and a hash table in front of it
+  validateBufferLength(1 + 4 + 4 + 1, length, true);
+  ValueLength const byteSize = readIntegerFixed<ValueLength, 4>(ptr + 1);
+  ValueLength const nrItems = readIntegerFixed<ValueLength, 4>(ptr + 1 + 4);
+
+  if (byteSize > length) {
+    throw Exception(Exception::ValidatorInvalidLength, "Object length is out of bounds");
+  }
+  if (nrItems == 0 || nrItems > hashIndexMaxMembers) {
+    throw Exception(Exception::ValidatorInvalidLength, "Object has invalid number of items");
+  }
+
+  ValueLength const slots = hashIndexSlots(nrItems);
+  if (byteSize < 1 + 4 + 4 + 4 * slots + 4 * nrItems) {
+    throw Exception(Exception::ValidatorInvalidLength, "Object hash table is out of bounds");
+  }
+  uint8_t const* indexTable = ptr + byteSize - 4 * nrItems;
+  uint8_t const* hashTable = indexTable - 4 * slots;
+
+  // offsets of all members, in ascending order
+  std::vector<ValueLength> offsets;
+  offsets.reserve(checkOverflow(nrItems));
+
+  if (_concurrency > 1 && byteSize >= minParallelSize && nrItems > 1) {
+    // the index table contains the start of every member, sorted by key
+    for (ValueLength pos = 0; pos < nrItems; ++pos) {
+      offsets.push_back(readIntegerFixed<ValueLength, 4>(indexTable + 4 * pos));
+    }
+    std::sort(offsets.begin(), offsets.end());
+    validateMembers(ptr, offsets, 1 + 4 + 4, hashTable - ptr,
+                    TaskKind::StringKeyObjectMember);
+  } else {
+    uint8_t const* member = ptr + 1 + 4 + 4;
+    while (member < hashTable) {
+      validate(member, hashTable - member, true);
+
+      Slice key(member);
+      if (!key.isString()) {
+        throw Exception(Exception::ValidatorInvalidLength, "Invalid object key type");
+      }
+
+      uint8_t const* value = member + key.byteSize();
+      if (value >= hashTable) {
+        throw Exception(Exception::ValidatorInvalidLength, "Object value leaking into hash table");
+      }
+      validate(value, hashTable - value, true);
+
+      offsets.push_back(static_cast<ValueLength>(member - ptr));
+      if (offsets.size() > nrItems) {
+        throw Exception(Exception::ValidatorInvalidLength, "Object value has more key/value pairs than announced");
+      }
+      member = value + Slice(value).byteSize();
+    }
+  }
+
+  if (offsets.size() < nrItems) {
+    throw Exception(Exception::ValidatorInvalidLength, "Object has fewer items than in index");
+  }
+
+  // each index table entry must point to a different member
+  std::vector<bool> seen(checkOverflow(nrItems), false);
+  for (ValueLength pos = 0; pos < nrItems; ++pos) {
+    ValueLength offset = readIntegerFixed<ValueLength, 4>(indexTable + 4 * pos);
+    auto it = std::lower_bound(offsets.begin(), offsets.end(), offset);
+    if (it == offsets.end() || *it != offset || seen[it - offsets.begin()]) {
+      throw Exception(Exception::ValidatorInvalidLength, "Object has invalid index offset");
+    }
+    seen[it - offsets.begin()] = true;
+  }
+
+  // each index table entry must be in the hash table exactly once, and
+  // must be found by probing from its home slot. a slot is reachable from
+  // its home slot if no empty slot lies in between, so we walk the table
+  // once starting after an empty slot and remember where the current run
+  // of occupied slots started
+  ValueLength const mask = slots - 1;
+  auto entryAt = [&](ValueLength slot) {
+    return readIntegerFixed<uint32_t, 4>(hashTable + 4 * slot);
+  };
+  ValueLength empty = 0;
+  while (empty < slots && entryAt(empty) != 0) {
+    ++empty;
+  }
+  if (empty == slots) {
+    throw Exception(Exception::ValidatorInvalidLength, "Object hash table is full");
+  }
+
+  std::fill(seen.begin(), seen.end(), false);
+  ValueLength found = 0;
+  ValueLength runStart = (empty + 1) & mask;
+  for (ValueLength i = 1; i <= slots; ++i) {
+    ValueLength const slot = (empty + i) & mask;
+    uint32_t const entry = entryAt(slot);
+    if (entry == 0) {
+      runStart = (slot + 1) & mask;
+      continue;
+    }
+    ValueLength const position = (entry & 0xffffffU) - 1;
+    if (position >= nrItems || seen[position]) {
+      throw Exception(Exception::ValidatorInvalidLength, "Object hash table entry is invalid");
+    }
+    seen[position] = true;
+    ++found;
+
+    ValueLength len;
+    char const* p = Slice(ptr + readIntegerFixed<ValueLength, 4>(indexTable + 4 * position)).getStringUnchecked(len);
+    uint64_t const hash = hashIndexKey(p, len);
+    if ((entry >> 24) != hashIndexFingerprint(hash) ||
+        ((slot - (hash & mask)) & mask) > ((slot - runStart) & mask)) {
+      throw Exception(Exception::ValidatorInvalidLength, "Object hash table entry is invalid");
+    }
+  }
+
+  if (found != nrItems) {
+    throw Exception(Exception::ValidatorInvalidLength, "Object hash table has missing entries");
+  }
+}
+
+void Validator::validateObjectMember(uint8_t const* ptr, std::size_t length,
+                                     bool stringKeysOnly) {
+  validate(ptr, length, true);
+
+  Slice key(ptr);
+  if (!key.isString()) {
+    bool const isSmallInt = key.isSmallInt();
+    if (stringKeysOnly || (!isSmallInt && !key.isUInt()) ||
+        (isSmallInt && key.getSmallInt() <= 0)) {
+      throw Exception(Exception::ValidatorInvalidLength, "Invalid object key type");
+    }
+  }
+
+  ValueLength const keySize = key.byteSize();
+  if (keySize >= length) {
+    throw Exception(Exception::ValidatorInvalidLength, "Object value leaking into index table");
+  }
+  validate(ptr + keySize, length - keySize, false);
+}
+
+void Validator::validateMembers(uint8_t const* ptr, std::vector<ValueLength> const& offsets,
+                                ValueLength begin, ValueLength end, TaskKind kind) {
+  // the members must be back to back, from begin to end. offsets must be
+  // sorted, so each member ends where the next one starts
+  if (offsets.empty() || offsets.front() != begin) {
+    throw Exception(Exception::ValidatorInvalidLength, "Index table does not match members");
+  }
+  std::vector<Task> tasks;
+  tasks.reserve(offsets.size());
+  for (std::size_t i = 0; i < offsets.size(); ++i) {
+    ValueLength const next = (i + 1 < offsets.size()) ? offsets[i + 1] : end;
+    if (next <= offsets[i] || next > end) {
+      throw Exception(Exception::ValidatorInvalidLength, "Index table does not match members");
+    }
+    tasks.push_back(Task{ptr + offsets[i], static_cast<std::size_t>(next - offsets[i]), kind});
+  }
+  validateTasks(tasks);
+}
+
+void Validator::validateTask(Task const& task) {
+  if (task.kind == TaskKind::Value) {
+    validate(task.ptr, task.length, false);
+  } else {
+    validateObjectMember(task.ptr, task.length,
+                         task.kind == TaskKind::StringKeyObjectMember);
+  }
+}
+
+void Validator::validateTasks(std::vector<Task> const& tasks) {
+  std::size_t total = 0;
+  std::size_t largest = 0;
+  for (auto const& task : tasks) {
+    total += task.length;
+    largest = (std::max)(largest, task.length);
+  }
+
+  if (_concurrency <= 1 || tasks.size() < 2 || largest > total / 2) {
+    // if one task dominates, splitting does not help. it is validated on
+    // this thread then, so that it can be split up itself
+    for (auto const& task : tasks) {
+      validateTask(task);
+    }
+    return;
+  }
+
+  // split the tasks into at most _concurrency chunks of about the same size
+  std::size_t const chunkSize = total / _concurrency + 1;
+  std::vector<std::size_t> bounds{0};
+  std::size_t size = 0;
+  for (std::size_t i = 0; i + 1 < tasks.size(); ++i) {
+    size += tasks[i].length;
+    if (size >= chunkSize) {
+      bounds.push_back(i + 1);
+      size = 0;
+    }
+  }
+  bounds.push_back(tasks.size());
+
+  std::size_t const chunks = bounds.size() - 1;
+  // runParallel() reports the first error in the input
+  runParallel(chunks, [&](std::size_t chunk) {
+    Validator validator(options, 1);
+    validator._level = _level;
+    for (std::size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+      validator.validateTask(tasks[i]);
+    }
+  });
+}
+
 void Validator::validateBufferLength(std::size_t expected, std::size_t actual, bool isSubPart) {
   if ((expected > actual) ||
       (expected != actual && !isSubPart)) {
@@ -74,6 +74,209 @@ inline std::size_t JSONSkipWhiteSpaceC(uint8_t const* src, std::size_t limit) {
 inline bool ValidateUtf8StringC(uint8_t const* src, std::size_t limit) {
   return Utf8Helper::isValidUtf8(src, static_cast<ValueLength>(limit));
 }
+
+inline std::size_t JSONEscapeScanC(uint8_t const* src, std::size_t size,
+                                   bool escapeSlash, bool stopAtHighBit,
+                                   bool& highBit) {
+  // Scan up to size uint8_t from src as long as they can be copied into
+  // JSON output verbatim. Stop at the first control character, backslash
+  // or double quote, at a forward slash if escapeSlash is set, and at a
+  // byte with the high bit set if stopAtHighBit is set.
+  // Report the number of bytes scanned, and whether a byte with the high
+  // bit set was among them.
+  uint8_t const* end = src + size;
+  uint8_t const* p = src;
+  uint8_t high = 0;
+  while (p < end) {
+    uint8_t c = *p;
+    if (c < 32 || c == '"' || c == '\\' || (c == '/' && escapeSlash) ||
+        (c >= 0x80 && stopAtHighBit)) {
+      break;
+    }
+    high |= c;
+    ++p;
+  }
+  highBit = (high & 0x80) != 0;
+  return p - src;
+}
+
+// bitmasks for a block of 64 input bytes, as used by the structural
+// index. bit i of each mask refers to byte i of the block
+struct JSONBlockMasks {
+  uint64_t quote;
+  uint64_t backslash;
+  uint64_t op;
+  uint64_t whitespace;
+  uint64_t control;
+  uint64_t high;
+};
+
+inline unsigned countTrailingZeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+  unsigned n = 0;
+  while ((x & 1) == 0) {
+    x >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+inline uint64_t lowBitsMask(unsigned n) {
+  return n >= 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+}
+
+// all bits from the lowest set bit of x up to (but excluding) the next
+// set bit are toggled, i.e. this computes which bytes are inside
+// quotes when x is the mask of unescaped quotes
+inline uint64_t prefixXor(uint64_t x) {
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+}
+
+inline void JSONClassifyBlockC(uint8_t const* src, JSONBlockMasks& m) {
+  m = JSONBlockMasks{0, 0, 0, 0, 0, 0};
+  for (unsigned i = 0; i < 64; ++i) {
+    uint64_t const bit = uint64_t(1) << i;
+    uint8_t const c = src[i];
+    switch (c) {
+      case '"':
+        m.quote |= bit;
+        break;
+      case '\\':
+        m.backslash |= bit;
+        break;
+      case '{':
+      case '}':
+      case '[':
+      case ']':
+      case ':':
+      case ',':
+        m.op |= bit;
+        break;
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+        m.whitespace |= bit;
+        break;
+      default:
+        break;
+    }
+    if (c < 0x20) {
+      m.control |= bit;
+    } else if (c >= 0x80) {
+      m.high |= bit;
+    }
+  }
+}
+
+// Builds the structural index from 64 byte blocks, which are classified
+// by the Classify function. Everything after classification is plain
+// bit manipulation, shared by all implementations.
+template <void (*Classify)(uint8_t const*, JSONBlockMasks&)>
+std::size_t JSONStructuralIndexImpl(uint8_t const* src, std::size_t size,
+                                    uint32_t* out, uint32_t offset,
+                                    bool checkUtf8) {
+  uint64_t constexpr evenBits = 0x5555555555555555ULL;
+  uint64_t constexpr oddBits = ~evenBits;
+
+  uint64_t prevEndsOddBackslash = 0;
+  uint64_t prevInString = 0;
+  uint64_t prevScalar = 0;
+  std::size_t openQuote = 0;
+  bool inString = false;
+  bool dirty = false;
+  std::size_t n = 0;
+
+  alignas(64) uint8_t tail[64];
+  JSONBlockMasks m;
+
+  for (std::size_t blockStart = 0; blockStart < size; blockStart += 64) {
+    if (size - blockStart >= 64) {
+      Classify(src + blockStart, m);
+    } else {
+      // pad the last block with whitespace
+      memset(&tail[0], ' ', sizeof(tail));
+      memcpy(&tail[0], src + blockStart, size - blockStart);
+      Classify(&tail[0], m);
+    }
+
+    // find all characters that are escaped by an odd-length sequence
+    // of backslashes
+    uint64_t const startEdges = m.backslash & ~(m.backslash << 1);
+    uint64_t const evenStartMask = evenBits ^ prevEndsOddBackslash;
+    uint64_t const evenStarts = startEdges & evenStartMask;
+    uint64_t const oddStarts = startEdges & ~evenStartMask;
+    uint64_t const evenCarries = m.backslash + evenStarts;
+    uint64_t oddCarries = m.backslash + oddStarts;
+    bool const endsOddBackslash = oddCarries < m.backslash;
+    oddCarries |= prevEndsOddBackslash;
+    prevEndsOddBackslash = endsOddBackslash ? 1 : 0;
+    uint64_t const escaped = ((evenCarries & ~m.backslash) & oddBits) |
+                             ((oddCarries & ~m.backslash) & evenBits);
+
+    uint64_t const quote = m.quote & ~escaped;
+    uint64_t const inStringMask = prefixXor(quote) ^ prevInString;
+    prevInString = static_cast<uint64_t>(static_cast<int64_t>(inStringMask) >> 63);
+
+    uint64_t const special =
+        (m.backslash | m.control | (checkUtf8 ? m.high : 0)) & inStringMask;
+    uint64_t const scalar =
+        ~(m.whitespace | m.op | quote | inStringMask);
+    uint64_t const scalarStart = scalar & ~((scalar << 1) | prevScalar);
+    prevScalar = scalar >> 63;
+
+    uint64_t tokens = (m.op & ~inStringMask) | quote | scalarStart;
+    if (blockStart + 64 > size) {
+      // ignore the padding
+      tokens &= lowBitsMask(static_cast<unsigned>(size - blockStart));
+    }
+
+    unsigned segmentStart = 0;
+    while (tokens != 0) {
+      unsigned const bit = countTrailingZeros(tokens);
+      if ((quote >> bit) & 1) {
+        if (!inString) {
+          openQuote = n;
+          dirty = false;
+          inString = true;
+        } else {
+          dirty |= (special & lowBitsMask(bit) & ~lowBitsMask(segmentStart)) != 0;
+          if (dirty) {
+            out[openQuote] |= JSONStructuralNeedsSlowPath;
+          }
+          inString = false;
+        }
+        segmentStart = bit + 1;
+      }
+      out[n++] = offset + static_cast<uint32_t>(blockStart + bit);
+      tokens &= tokens - 1;
+    }
+    if (inString) {
+      dirty |= (special & ~lowBitsMask(segmentStart)) != 0;
+    }
+  }
+
+  if (inString) {
+    // unterminated string. let the slow path report the error
+    out[openQuote] |= JSONStructuralNeedsSlowPath;
+  }
+  return n;
+}
+
+inline std::size_t JSONStructuralIndexC(uint8_t const* src, std::size_t size,
+                                        uint32_t* out, uint32_t offset,
+                                        bool checkUtf8) {
+  return JSONStructuralIndexImpl<JSONClassifyBlockC>(src, size, out, offset, checkUtf8);
+}
   
 } // namespace
 
@@ -273,6 +476,184 @@ bool doInitValidateUtf8String(uint8_t const* src, std::size_t limit) {
   }
   return (*ValidateUtf8String)(src, limit);
 }
+std::size_t JSONEscapeScanSSE42(uint8_t const* src, std::size_t size,
+                                bool escapeSlash, bool stopAtHighBit,
+                                bool& highBit) {
+  __m128i const quote = _mm_set1_epi8('"');
+  __m128i const backslash = _mm_set1_epi8('\\');
+  __m128i const slash = _mm_set1_epi8(escapeSlash ? '/' : '"');
+  __m128i const maxControl = _mm_set1_epi8(0x1f);
+  uint32_t const stopHigh = stopAtHighBit ? 0xffffU : 0;
+
+  std::size_t count = 0;
+  uint32_t high = 0;
+  while (size - count >= 16) {
+    __m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + count));
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(s, quote), _mm_cmpeq_epi8(s, backslash));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(s, slash));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(s, maxControl), s));
+    uint32_t const h = static_cast<uint32_t>(_mm_movemask_epi8(s));
+    uint32_t const stop = static_cast<uint32_t>(_mm_movemask_epi8(m)) | (h & stopHigh);
+    if (stop != 0) {
+      unsigned const n = countTrailingZeros(stop);
+      highBit = (high | (h & static_cast<uint32_t>(lowBitsMask(n)))) != 0;
+      return count + n;
+    }
+    high |= h;
+    count += 16;
+  }
+  // the remaining bytes are not read with a vector load, so that we do
+  // not read beyond the end of the string
+  bool tailHigh;
+  count += JSONEscapeScanC(src + count, size - count, escapeSlash, stopAtHighBit, tailHigh);
+  highBit = high != 0 || tailHigh;
+  return count;
+}
+
+#ifdef __AVX2__
+std::size_t JSONEscapeScanAVX2(uint8_t const* src, std::size_t size,
+                               bool escapeSlash, bool stopAtHighBit,
+                               bool& highBit) {
+  __m256i const quote = _mm256_set1_epi8('"');
+  __m256i const backslash = _mm256_set1_epi8('\\');
+  __m256i const slash = _mm256_set1_epi8(escapeSlash ? '/' : '"');
+  __m256i const maxControl = _mm256_set1_epi8(0x1f);
+  uint32_t const stopHigh = stopAtHighBit ? 0xffffffffU : 0;
+
+  std::size_t count = 0;
+  uint32_t high = 0;
+  while (size - count >= 32) {
+    __m256i const s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + count));
+    __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(s, quote), _mm256_cmpeq_epi8(s, backslash));
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi8(s, slash));
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_min_epu8(s, maxControl), s));
+    uint32_t const h = static_cast<uint32_t>(_mm256_movemask_epi8(s));
+    uint32_t const stop = static_cast<uint32_t>(_mm256_movemask_epi8(m)) | (h & stopHigh);
+    if (stop != 0) {
+      unsigned const n = countTrailingZeros(stop);
+      highBit = (high | (h & static_cast<uint32_t>(lowBitsMask(n)))) != 0;
+      return count + n;
+    }
+    high |= h;
+    count += 32;
+  }
+  bool tailHigh;
+  count += JSONEscapeScanSSE42(src + count, size - count, escapeSlash, stopAtHighBit, tailHigh);
+  highBit = high != 0 || tailHigh;
+  return count;
+}
+#endif
+
+std::size_t doInitEscapeScan(uint8_t const* src, std::size_t size,
+                             bool escapeSlash, bool stopAtHighBit,
+                             bool& highBit) {
+#ifdef __AVX2__
+  if (assemblerFunctionsEnabled() && ::hasAVX2()) {
+    JSONEscapeScan = ::JSONEscapeScanAVX2;
+    return JSONEscapeScanAVX2(src, size, escapeSlash, stopAtHighBit, highBit);
+  }
+#endif
+  if (assemblerFunctionsEnabled() && ::hasSSE42()) {
+    JSONEscapeScan = ::JSONEscapeScanSSE42;
+  } else {
+    JSONEscapeScan = ::JSONEscapeScanC;
+  }
+  return (*JSONEscapeScan)(src, size, escapeSlash, stopAtHighBit, highBit);
+}
+
+// whitespace and structural characters are classified with a table
+// lookup on the low nibble of each byte (pshufb). the lookup result
+// equals the input byte only for the characters we are looking for.
+// '[' and ']' only differ from '{' and '}' in bit 0x20, so they are folded
+// into them. this also folds a few control characters into ',' and ':',
+// which are removed again using the control character mask
+alignas(16) uint8_t const JSONWhiteSpaceTable[16] = {
+    ' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100};
+alignas(16) uint8_t const JSONOperatorTable[16] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0};
+
+inline void JSONClassifyBlockSSE42(uint8_t const* src, JSONBlockMasks& m) {
+  __m128i const wsTable = _mm_load_si128(reinterpret_cast<__m128i const*>(JSONWhiteSpaceTable));
+  __m128i const opTable = _mm_load_si128(reinterpret_cast<__m128i const*>(JSONOperatorTable));
+  __m128i const quote = _mm_set1_epi8('"');
+  __m128i const backslash = _mm_set1_epi8('\\');
+  __m128i const caseBit = _mm_set1_epi8(0x20);
+  __m128i const maxControl = _mm_set1_epi8(0x1f);
+
+  m = JSONBlockMasks{0, 0, 0, 0, 0, 0};
+  for (unsigned i = 0; i < 64; i += 16) {
+    __m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+    __m128i const ws = _mm_cmpeq_epi8(_mm_shuffle_epi8(wsTable, s), s);
+    __m128i const control = _mm_cmpeq_epi8(_mm_min_epu8(s, maxControl), s);
+    __m128i const op = _mm_andnot_si128(
+        control, _mm_cmpeq_epi8(_mm_shuffle_epi8(opTable, s), _mm_or_si128(s, caseBit)));
+
+    m.quote |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(s, quote)))) << i;
+    m.backslash |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(s, backslash)))) << i;
+    m.op |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(op))) << i;
+    m.whitespace |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(ws))) << i;
+    m.control |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(control))) << i;
+    m.high |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(s))) << i;
+  }
+}
+
+std::size_t JSONStructuralIndexSSE42(uint8_t const* src, std::size_t size,
+                                     uint32_t* out, uint32_t offset,
+                                     bool checkUtf8) {
+  return JSONStructuralIndexImpl<JSONClassifyBlockSSE42>(src, size, out, offset, checkUtf8);
+}
+
+#ifdef __AVX2__
+inline void JSONClassifyBlockAVX2(uint8_t const* src, JSONBlockMasks& m) {
+  __m256i const wsTable = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<__m128i const*>(JSONWhiteSpaceTable)));
+  __m256i const opTable = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<__m128i const*>(JSONOperatorTable)));
+  __m256i const quote = _mm256_set1_epi8('"');
+  __m256i const backslash = _mm256_set1_epi8('\\');
+  __m256i const caseBit = _mm256_set1_epi8(0x20);
+  __m256i const maxControl = _mm256_set1_epi8(0x1f);
+
+  m = JSONBlockMasks{0, 0, 0, 0, 0, 0};
+  for (unsigned i = 0; i < 64; i += 32) {
+    __m256i const s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+    __m256i const ws = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(wsTable, s), s);
+    __m256i const control = _mm256_cmpeq_epi8(_mm256_min_epu8(s, maxControl), s);
+    __m256i const op = _mm256_andnot_si256(
+        control, _mm256_cmpeq_epi8(_mm256_shuffle_epi8(opTable, s), _mm256_or_si256(s, caseBit)));
+
+    m.quote |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(s, quote)))) << i;
+    m.backslash |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(s, backslash)))) << i;
+    m.op |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(op))) << i;
+    m.whitespace |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(ws))) << i;
+    m.control |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(control))) << i;
+    m.high |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(s))) << i;
+  }
+}
+
+std::size_t JSONStructuralIndexAVX2(uint8_t const* src, std::size_t size,
+                                    uint32_t* out, uint32_t offset,
+                                    bool checkUtf8) {
+  return JSONStructuralIndexImpl<JSONClassifyBlockAVX2>(src, size, out, offset, checkUtf8);
+}
+#endif
+
+std::size_t doInitStructuralIndex(uint8_t const* src, std::size_t size,
+                                  uint32_t* out, uint32_t offset,
+                                  bool checkUtf8) {
+#ifdef __AVX2__
+  if (assemblerFunctionsEnabled() && ::hasAVX2()) {
+    JSONStructuralIndex = ::JSONStructuralIndexAVX2;
+    return JSONStructuralIndexAVX2(src, size, out, offset, checkUtf8);
+  }
+#endif
+  if (assemblerFunctionsEnabled() && ::hasSSE42()) {
+    JSONStructuralIndex = ::JSONStructuralIndexSSE42;
+  } else {
+    JSONStructuralIndex = ::JSONStructuralIndexC;
+  }
+  return (*JSONStructuralIndex)(src, size, out, offset, checkUtf8);
+}
 } // namespace
 
 #else
@@ -299,6 +680,20 @@ bool doInitValidateUtf8String(uint8_t const* src, std::size_t limit) {
   return ValidateUtf8StringC(src, limit);
 }
 
+std::size_t doInitEscapeScan(uint8_t const* src, std::size_t size,
+                             bool escapeSlash, bool stopAtHighBit,
+                             bool& highBit) {
+  JSONEscapeScan = ::JSONEscapeScanC;
+  return JSONEscapeScanC(src, size, escapeSlash, stopAtHighBit, highBit);
+}
+
+std::size_t doInitStructuralIndex(uint8_t const* src, std::size_t size,
+                                  uint32_t* out, uint32_t offset,
+                                  bool checkUtf8) {
+  JSONStructuralIndex = ::JSONStructuralIndexC;
+  return JSONStructuralIndexC(src, size, out, offset, checkUtf8);
+}
+
 } // namespace
 
 #endif
@@ -307,17 +702,23 @@ std::size_t (*JSONStringCopy)(uint8_t*, uint8_t const*, std::size_t) = ::doInitC
 std::size_t (*JSONStringCopyCheckUtf8)(uint8_t*, uint8_t const*, std::size_t) = ::doInitCopyCheckUtf8;
 std::size_t (*JSONSkipWhiteSpace)(uint8_t const*, std::size_t) = ::doInitSkip;
 bool (*ValidateUtf8String)(uint8_t const*, std::size_t) = ::doInitValidateUtf8String;
+std::size_t (*JSONStructuralIndex)(uint8_t const*, std::size_t, uint32_t*, uint32_t, bool) = ::doInitStructuralIndex;
+std::size_t (*JSONEscapeScan)(uint8_t const*, std::size_t, bool, bool, bool&) = ::doInitEscapeScan;
 
 void arangodb::velocypack::enableNativeStringFunctions() {
   JSONStringCopy = ::doInitCopy;
   JSONStringCopyCheckUtf8 = ::doInitCopyCheckUtf8;
   JSONSkipWhiteSpace = ::doInitSkip;
+  JSONStructuralIndex = ::doInitStructuralIndex;
+  JSONEscapeScan = ::doInitEscapeScan;
 }
 
 void arangodb::velocypack::enableBuiltinStringFunctions() {
   JSONStringCopy = ::JSONStringCopyC;
   JSONStringCopyCheckUtf8 = ::JSONStringCopyCheckUtf8C;
   JSONSkipWhiteSpace = ::JSONSkipWhiteSpaceC;
+  JSONStructuralIndex = ::JSONStructuralIndexC;
+  JSONEscapeScan = ::JSONEscapeScanC;
 }
 
 
@@ -531,6 +932,62 @@ void TestSkipWhiteSpaceCorrectness(uint8_t* src, std::size_t size) {
             << " seconds." << std::endl;
 }
 
+void TestEscapeScanCorrectness(uint8_t* src, std::size_t size) {
+  std::size_t scanned;
+  bool highBit;
+
+  std::cout << "Performing correctness tests for escape scanning..."
+            << std::endl;
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  static uint8_t const stoppers[] = {'"', '\\', '/', 0x00, 0x1f, 0x80, 0xff};
+
+  for (int salign = 0; salign < 16; salign++) {
+    src += salign;
+    for (int i = 0; i < static_cast<int>(sizeof(testPositions) / sizeof(int));
+         i++) {
+      int off = testPositions[i];
+      std::size_t pos;
+      if (off >= 0) {
+        pos = off;
+      } else {
+        pos = size - static_cast<std::size_t>(-off);
+      }
+      if (pos >= size) {
+        continue;
+      }
+
+      // Test all characters that stop the scan:
+      for (uint8_t c : stoppers) {
+        uint8_t merk = src[pos];
+        src[pos] = c;
+        for (int flags = 0; flags < 4; flags++) {
+          bool escapeSlash = (flags & 1) != 0;
+          bool stopAtHighBit = (flags & 2) != 0;
+          bool expectedHighBit;
+          std::size_t expected = JSONEscapeScanC(src, size, escapeSlash,
+                                                 stopAtHighBit, expectedHighBit);
+          scanned = JSONEscapeScan(src, size, escapeSlash, stopAtHighBit, highBit);
+          if (scanned != expected || highBit != expectedHighBit) {
+            std::cout << "Error: " << salign << " " << i << " " << pos << " "
+                      << int(c) << " " << flags << " " << scanned << " "
+                      << expected << std::endl;
+          }
+        }
+        src[pos] = merk;
+      }
+    }
+    src -= salign;
+  }
+
+  auto now = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> totalTime =
+      std::chrono::duration_cast<std::chrono::duration<double>>(now - start);
+  std::cout << "Escape scan tests took altogether " << totalTime.count()
+            << " seconds." << std::endl;
+}
+
 void RaceStringCopy(uint8_t* dst, uint8_t* src, std::size_t size, int repeat,
                     uint64_t& akku) {
   std::size_t copied;
@@ -701,6 +1158,52 @@ void RaceSkipWhiteSpace(uint8_t* src, std::size_t size, int repeat, uint64_t& ak
             << (double)size * (double)repeat / totalTime.count() << std::endl;
 }
 
+void RaceEscapeScan(uint8_t* src, std::size_t size, int repeat, uint64_t& akku) {
+  std::size_t scanned;
+  bool highBit;
+
+  std::cout << "\nNow racing for the repeated full string...\n" << std::endl;
+
+  auto start = std::chrono::high_resolution_clock::now();
+  akku = 0;
+  for (int j = 0; j < repeat; j++) {
+    scanned = JSONEscapeScan(src, size, true, false, highBit);
+    akku = akku * 13 + scanned + highBit;
+  }
+  auto now = std::chrono::high_resolution_clock::now();
+
+  auto totalTime =
+      std::chrono::duration_cast<std::chrono::duration<double>>(now - start);
+
+  std::cout << "Race took altogether " << totalTime.count() << " seconds."
+            << std::endl;
+  std::cout << "Time to scan string of length " << size
+            << " on average is: " << totalTime.count() / repeat << "."
+            << std::endl;
+  std::cout << "Bytes scanned per second: "
+            << (double)size * (double)repeat / totalTime.count() << std::endl;
+
+  std::cout << "\nNow comparing with the scalar scan...\n" << std::endl;
+
+  start = std::chrono::high_resolution_clock::now();
+  for (int j = 0; j < repeat; j++) {
+    scanned = JSONEscapeScanC(src, size, true, false, highBit);
+    akku = akku * 13 + scanned + highBit;
+  }
+  now = std::chrono::high_resolution_clock::now();
+
+  totalTime =
+      std::chrono::duration_cast<std::chrono::duration<double>>(now - start);
+
+  std::cout << "Race took altogether " << totalTime.count() << " seconds."
+            << std::endl;
+  std::cout << "Time to scan string of length " << size
+            << " on average is: " << totalTime.count() / repeat << "."
+            << std::endl;
+  std::cout << "Bytes scanned per second: "
+            << (double)size * (double)repeat / totalTime.count() << std::endl;
+}
+
 int main(int argc, char* argv[]) {
   if (argc < 4) {
     std::cout << "Usage: " << argv[0] << " SIZE REPEAT CORRECTNESS"
@@ -751,6 +1254,21 @@ int main(int argc, char* argv[]) {
 
   RaceSkipWhiteSpace(src, size, repeat, akku);
 
+  std::cout << "\n\n\nNOW ESCAPE SCANNING\n" << std::endl;
+
+  // Now do the escape scanning tests/measurements, on text without
+  // any characters that need escaping:
+  for (std::size_t i = 0; i < size + 16; i++) {
+    src[i] = 'a' + (i % 26);
+  }
+  src[size + 16] = 0;
+
+  if (docorrectness > 0) {
+    TestEscapeScanCorrectness(src, size);
+  }
+
+  RaceEscapeScan(src, size, repeat, akku);
+
   std::cout << "\n\n\nAkku (please ignore):" << akku << std::endl;
   std::cout << "\n\n\nGuck (please ignore): " << dst[100] << std::endl;
 
@@ -37,6 +37,31 @@ extern std::size_t (*JSONSkipWhiteSpace)(uint8_t const*, std::size_t);
 // check string for invalid utf-8 sequences
 extern bool (*ValidateUtf8String)(uint8_t const*, std::size_t);
 
+// Structural index for the two-stage JSON parser. Writes the positions
+// (plus offset) of all structural characters outside of strings, of all
+// unescaped double quotes and of the first byte of every other scalar
+// token into the output array, and returns the number of positions
+// written. The output array must have room for at least size + 1 entries.
+// The position of an opening double quote is or'ed with
+// JSONStructuralNeedsSlowPath if the string contains a backslash, a
+// control character or (if checkUtf8 is set) a byte with the high bit
+// set, or if it is not terminated.
+extern std::size_t (*JSONStructuralIndex)(uint8_t const* src, std::size_t size,
+                                          uint32_t* out, uint32_t offset,
+                                          bool checkUtf8);
+
+constexpr uint32_t JSONStructuralNeedsSlowPath = 0x80000000U;
+
+// Scan for the end of a run of bytes that can be written into JSON
+// output verbatim. The run ends at the first double quote, backslash or
+// control character, at a forward slash if escapeSlash is set, and at a
+// byte with the high bit set if stopAtHighBit is set. Returns the length
+// of the run and sets highBit if it contains a byte with the high bit
+// set. Does not read beyond src + size.
+extern std::size_t (*JSONEscapeScan)(uint8_t const* src, std::size_t size,
+                                     bool escapeSlash, bool stopAtHighBit,
+                                     bool& highBit);
+
 namespace arangodb::velocypack {
 
 void enableNativeStringFunctions();
@@ -0,0 +1,505 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <cstring>
+
+#include "dtoa.h"
+#include "dtoa-tables.h"
+
+using namespace arangodb::velocypack;
+
+// The shortest representation is computed with Ryu, as described in
+// Ulf Adams, "Ryu: fast float-to-string conversion", PLDI 2018. The
+// implementation follows the reference implementation of d2s.c.
+
+namespace {
+
+// layout of an IEEE 754 double
+constexpr int mantissaBits = 52;
+constexpr int exponentBits = 11;
+constexpr int exponentBias = 1023;
+
+constexpr int pow5InvBitCount = 125;
+constexpr int pow5BitCount = 125;
+
+// returns ceil(log2(5^e)), or 1 for e == 0. valid for e in [0, 3528]
+inline int32_t pow5Bits(int32_t e) noexcept {
+  return static_cast<int32_t>((static_cast<uint32_t>(e) * 1217359) >> 19) + 1;
+}
+
+// returns floor(log10(2^e)). valid for e in [0, 1650]
+inline uint32_t log10Pow2(int32_t e) noexcept {
+  return (static_cast<uint32_t>(e) * 78913) >> 18;
+}
+
+// returns floor(log10(5^e)). valid for e in [0, 2620]
+inline uint32_t log10Pow5(int32_t e) noexcept {
+  return (static_cast<uint32_t>(e) * 732923) >> 20;
+}
+
+inline uint32_t pow5Factor(uint64_t value) noexcept {
+  uint32_t count = 0;
+  while (value % 5 == 0) {
+    value /= 5;
+    ++count;
+  }
+  return count;
+}
+
+inline bool multipleOfPowerOf5(uint64_t value, uint32_t p) noexcept {
+  return pow5Factor(value) >= p;
+}
+
+inline bool multipleOfPowerOf2(uint64_t value, uint32_t p) noexcept {
+  return (value & ((1ULL << p) - 1)) == 0;
+}
+
+// returns (m * mul) >> j, for j >= 64
+inline uint64_t mulShift64(uint64_t m, uint64_t const* mul, int32_t j) noexcept {
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 b0 = static_cast<unsigned __int128>(m) * mul[0];
+  unsigned __int128 b2 = static_cast<unsigned __int128>(m) * mul[1];
+  return static_cast<uint64_t>(((b0 >> 64) + b2) >> (j - 64));
+#else
+  // split into 32-bit halves
+  auto mul64 = [](uint64_t a, uint64_t b, uint64_t& high) -> uint64_t {
+    uint64_t const aLow = a & 0xffffffffULL;
+    uint64_t const aHigh = a >> 32;
+    uint64_t const bLow = b & 0xffffffffULL;
+    uint64_t const bHigh = b >> 32;
+    uint64_t const ll = aLow * bLow;
+    uint64_t const lh = aLow * bHigh;
+    uint64_t const hl = aHigh * bLow;
+    uint64_t const hh = aHigh * bHigh;
+    uint64_t const middle =
+        (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+    high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+    return (middle << 32) | (ll & 0xffffffffULL);
+  };
+  uint64_t high1;
+  uint64_t const low1 = mul64(m, mul[1], high1);
+  uint64_t high0;
+  mul64(m, mul[0], high0);
+  uint64_t const sum = high0 + low1;
+  if (sum < high0) {
+    ++high1;
+  }
+  int32_t const shift = j - 64;
+  if (shift == 0) {
+    return sum;
+  }
+  return (high1 << (64 - shift)) | (sum >> shift);
+#endif
+}
+
+inline uint32_t decimalLength(uint64_t v) noexcept {
+  uint32_t length = 1;
+  while (v >= 10) {
+    v /= 10;
+    ++length;
+  }
+  return length;
+}
+
+constexpr uint64_t powersOfTen[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL};
+
+// a double as mantissa * 10^exponent
+struct DecimalDouble {
+  uint64_t mantissa;
+  int32_t exponent;
+};
+
+// the shortest decimal representation of the double with the given
+// IEEE mantissa and exponent bits, which must be finite and non-zero.
+// if exact is not a nullptr, it also returns the leading digits of the
+// double, at least as many as the result has, and in exactIsExact
+// whether only zeros follow them
+DecimalDouble shortestDecimal(uint64_t ieeeMantissa, uint32_t ieeeExponent,
+                              DecimalDouble* exact, bool* exactIsExact) noexcept {
+  int32_t e2;
+  uint64_t m2;
+  if (ieeeExponent == 0) {
+    // subtract 2 so that the bounds computation has 2 additional bits
+    e2 = 1 - exponentBias - mantissaBits - 2;
+    m2 = ieeeMantissa;
+  } else {
+    e2 = static_cast<int32_t>(ieeeExponent) - exponentBias - mantissaBits - 2;
+    m2 = (1ULL << mantissaBits) | ieeeMantissa;
+  }
+  bool const acceptBounds = (m2 & 1) == 0;
+
+  // determine the interval of valid decimal representations
+  uint64_t const mv = 4 * m2;
+  uint32_t const mmShift = (ieeeMantissa != 0 || ieeeExponent <= 1) ? 1 : 0;
+
+  // convert to a decimal power base
+  uint64_t vr;
+  uint64_t vp;
+  uint64_t vm;
+  int32_t e10;
+  bool vmIsTrailingZeros = false;
+  bool vrIsTrailingZeros = false;
+  if (e2 >= 0) {
+    uint32_t const q = log10Pow2(e2) - (e2 > 3 ? 1 : 0);
+    e10 = static_cast<int32_t>(q);
+    int32_t const k = pow5InvBitCount + pow5Bits(static_cast<int32_t>(q)) - 1;
+    int32_t const i = -e2 + static_cast<int32_t>(q) + k;
+    vr = mulShift64(4 * m2, pow5InvSplit[q], i);
+    vp = mulShift64(4 * m2 + 2, pow5InvSplit[q], i);
+    vm = mulShift64(4 * m2 - 1 - mmShift, pow5InvSplit[q], i);
+    if (q <= 21) {
+      // only one of mp, mv, and mm can be a multiple of 5, if any
+      if (mv % 5 == 0) {
+        vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+      } else if (acceptBounds) {
+        vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+      } else {
+        vp -= multipleOfPowerOf5(mv + 2, q) ? 1 : 0;
+      }
+    }
+    if (exactIsExact != nullptr) {
+      // 5^24 > 4 * 2^53, so mv cannot be a multiple of larger powers
+      *exactIsExact = (q <= 23 && multipleOfPowerOf5(mv, q));
+    }
+  } else {
+    uint32_t const q = log10Pow5(-e2) - (-e2 > 1 ? 1 : 0);
+    e10 = static_cast<int32_t>(q) + e2;
+    int32_t const i = -e2 - static_cast<int32_t>(q);
+    int32_t const k = pow5Bits(i) - pow5BitCount;
+    int32_t const j = static_cast<int32_t>(q) - k;
+    vr = mulShift64(4 * m2, pow5Split[i], j);
+    vp = mulShift64(4 * m2 + 2, pow5Split[i], j);
+    vm = mulShift64(4 * m2 - 1 - mmShift, pow5Split[i], j);
+    if (q <= 1) {
+      // mv = 4 * m2, so it always has at least two trailing 0 bits
+      vrIsTrailingZeros = true;
+      if (acceptBounds) {
+        // mm = mv - 1 - mmShift, so it has 1 trailing 0 bit iff mmShift == 1
+        vmIsTrailingZeros = (mmShift == 1);
+      } else {
+        // mp = mv + 2, so it always has at least one trailing 0 bit
+        --vp;
+      }
+    } else if (q < 63) {
+      vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+    }
+    if (exactIsExact != nullptr) {
+      *exactIsExact = vrIsTrailingZeros;
+    }
+  }
+
+  if (exact != nullptr) {
+    exact->mantissa = vr;
+    exact->exponent = e10;
+  }
+
+  // find the shortest decimal representation in the interval of valid
+  // representations
+  int32_t removed = 0;
+  uint64_t output;
+  if (vmIsTrailingZeros || vrIsTrailingZeros) {
+    // general case, which happens rarely
+    uint32_t lastRemovedDigit = 0;
+    while (vp / 10 > vm / 10) {
+      vmIsTrailingZeros &= (vm % 10 == 0);
+      vrIsTrailingZeros &= (lastRemovedDigit == 0);
+      lastRemovedDigit = static_cast<uint32_t>(vr % 10);
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    if (vmIsTrailingZeros) {
+      while (vm % 10 == 0) {
+        vrIsTrailingZeros &= (lastRemovedDigit == 0);
+        lastRemovedDigit = static_cast<uint32_t>(vr % 10);
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        ++removed;
+      }
+    }
+    if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+      // round to even if the exact number is .....50..0
+      lastRemovedDigit = 4;
+    }
+    // take vr + 1 if vr is outside the bounds or we need to round up
+    output = vr + (((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) ||
+                    lastRemovedDigit >= 5) ? 1 : 0);
+  } else {
+    // common case
+    bool roundUp = false;
+    if (vp / 100 > vm / 100) {
+      // remove two digits at a time
+      roundUp = (vr % 100) >= 50;
+      vr /= 100;
+      vp /= 100;
+      vm /= 100;
+      removed += 2;
+    }
+    while (vp / 10 > vm / 10) {
+      roundUp = (vr % 10) >= 5;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    // take vr + 1 if vr is outside the bounds or we need to round up
+    output = vr + ((vr == vm || roundUp) ? 1 : 0);
+  }
+
+  return DecimalDouble{output, e10 + removed};
+}
+
+// rounds the exact digits of a double to the given number of digits,
+// with ties rounded to even
+DecimalDouble roundDecimal(DecimalDouble value, bool isExact,
+                           uint32_t digits) noexcept {
+  uint32_t const length = decimalLength(value.mantissa);
+  if (length <= digits) {
+    return value;
+  }
+  // remove all but the last surplus digit in one go, then the last one
+  uint32_t const removed = length - digits;
+  uint64_t const divisor = powersOfTen[removed - 1];
+  bool const restIsZero = isExact && (value.mantissa % divisor) == 0;
+  value.mantissa /= divisor;
+  uint32_t const lastRemovedDigit = static_cast<uint32_t>(value.mantissa % 10);
+  value.mantissa /= 10;
+  value.exponent += static_cast<int32_t>(removed);
+  if (lastRemovedDigit > 5 ||
+      (lastRemovedDigit == 5 && (!restIsZero || (value.mantissa & 1) != 0))) {
+    ++value.mantissa;
+    if (value.mantissa == powersOfTen[digits]) {
+      value.mantissa /= 10;
+      ++value.exponent;
+    }
+  }
+  return value;
+}
+
+// writes the decimal digits of value, which has length digits
+inline void writeDigits(uint64_t value, uint32_t length, char* dest) noexcept {
+  static constexpr char digitPairs[] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+  char* p = dest + length;
+  while (value >= 100) {
+    uint32_t const pair = static_cast<uint32_t>(value % 100) * 2;
+    value /= 100;
+    p -= 2;
+    memcpy(p, &digitPairs[pair], 2);
+  }
+  if (value >= 10) {
+    uint32_t const pair = static_cast<uint32_t>(value) * 2;
+    p -= 2;
+    memcpy(p, &digitPairs[pair], 2);
+  } else {
+    *--p = static_cast<char>('0' + value);
+  }
+}
+
+// writes the number digits * 10^K, using the same layout as fpconv_dtoa()
+std::size_t emitDigits(char const* digits, int ndigits, char* dest, int K) noexcept {
+  int exp = K + ndigits - 1;
+  if (exp < 0) {
+    exp = -exp;
+  }
+
+  // write plain integer
+  if (K >= 0 && exp < ndigits + 7) {
+    memcpy(dest, digits, ndigits);
+    memset(dest + ndigits, '0', K);
+    return static_cast<std::size_t>(ndigits + K);
+  }
+
+  // write decimal without scientific notation
+  if (K < 0 && (K > -7 || exp < 4)) {
+    int offset = ndigits + K;
+    if (offset <= 0) {
+      // value < 1.0, write leading zero
+      offset = -offset;
+      dest[0] = '0';
+      dest[1] = '.';
+      memset(dest + 2, '0', offset);
+      memcpy(dest + offset + 2, digits, ndigits);
+      return static_cast<std::size_t>(ndigits + 2 + offset);
+    }
+    memcpy(dest, digits, offset);
+    dest[offset] = '.';
+    memcpy(dest + offset + 1, digits + offset, ndigits - offset);
+    return static_cast<std::size_t>(ndigits + 1);
+  }
+
+  // write decimal with scientific notation
+  std::size_t idx = 0;
+  dest[idx++] = digits[0];
+  if (ndigits > 1) {
+    dest[idx++] = '.';
+    memcpy(dest + idx, digits + 1, ndigits - 1);
+    idx += ndigits - 1;
+  }
+  dest[idx++] = 'e';
+  dest[idx++] = (K + ndigits - 1 < 0) ? '-' : '+';
+  if (exp >= 100) {
+    dest[idx++] = static_cast<char>('0' + exp / 100);
+    exp %= 100;
+    dest[idx++] = static_cast<char>('0' + exp / 10);
+  } else if (exp >= 10) {
+    dest[idx++] = static_cast<char>('0' + exp / 10);
+  }
+  dest[idx++] = static_cast<char>('0' + exp % 10);
+  return idx;
+}
+
+// returns the number of characters emitDigits() writes for ndigits
+// digits and the exponent K
+std::size_t emittedLength(int ndigits, int K) noexcept {
+  int exp = K + ndigits - 1;
+  if (exp < 0) {
+    exp = -exp;
+  }
+  if (K >= 0 && exp < ndigits + 7) {
+    return static_cast<std::size_t>(ndigits + K);
+  }
+  if (K < 0 && (K > -7 || exp < 4)) {
+    int offset = ndigits + K;
+    if (offset <= 0) {
+      return static_cast<std::size_t>(ndigits + 2 - offset);
+    }
+    return static_cast<std::size_t>(ndigits + 1);
+  }
+  std::size_t length = (ndigits > 1) ? ndigits + 1 : 1;
+  // "e", sign and exponent digits
+  return length + 2 + (exp >= 100 ? 3 : (exp >= 10 ? 2 : 1));
+}
+
+inline bool isNegative(uint64_t bits) noexcept {
+  return (bits >> (mantissaBits + exponentBits)) != 0;
+}
+
+// returns the digits of a finite, non-zero double without trailing zeros,
+// either the shortest ones or rounded to significantDigits digits
+DecimalDouble toDecimal(uint64_t ieeeMantissa, uint32_t ieeeExponent,
+                        int significantDigits) noexcept {
+  bool const rounded = (significantDigits > 0 && significantDigits < 17);
+  DecimalDouble exact;
+  bool exactIsExact = false;
+  DecimalDouble value =
+      shortestDecimal(ieeeMantissa, ieeeExponent, rounded ? &exact : nullptr,
+                      rounded ? &exactIsExact : nullptr);
+
+  // remove trailing zeros
+  while (value.mantissa % 10 == 0) {
+    value.mantissa /= 10;
+    ++value.exponent;
+  }
+
+  if (rounded && decimalLength(value.mantissa) >
+                     static_cast<uint32_t>(significantDigits)) {
+    // the exact digits have at least as many digits as the shortest
+    // representation, so they suffice for rounding
+    value = roundDecimal(exact, exactIsExact,
+                         static_cast<uint32_t>(significantDigits));
+    while (value.mantissa % 10 == 0) {
+      value.mantissa /= 10;
+      ++value.exponent;
+    }
+  }
+  return value;
+}
+
+}  // namespace
+
+std::size_t arangodb::velocypack::doubleToString(double v, char* dest,
+                                                 int significantDigits) noexcept {
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+
+  std::size_t length = 0;
+  if (isNegative(bits)) {
+    dest[length++] = '-';
+  }
+  uint64_t const ieeeMantissa = bits & ((1ULL << mantissaBits) - 1);
+  uint32_t const ieeeExponent = static_cast<uint32_t>(
+      (bits >> mantissaBits) & ((1U << exponentBits) - 1));
+  if (ieeeExponent == ((1U << exponentBits) - 1)) {
+    memcpy(dest + length, (ieeeMantissa != 0) ? "NaN" : "inf", 3);
+    return length + 3;
+  }
+  if (ieeeExponent == 0 && ieeeMantissa == 0) {
+    dest[length++] = '0';
+    return length;
+  }
+
+  DecimalDouble const value =
+      toDecimal(ieeeMantissa, ieeeExponent, significantDigits);
+  uint32_t const ndigits = decimalLength(value.mantissa);
+  char digits[20];
+  writeDigits(value.mantissa, ndigits, &digits[0]);
+  return length + emitDigits(&digits[0], static_cast<int>(ndigits),
+                             dest + length, value.exponent);
+}
+
+std::size_t arangodb::velocypack::doubleStringLength(
+    double v, int significantDigits) noexcept {
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+
+  std::size_t length = isNegative(bits) ? 1 : 0;
+  uint64_t const ieeeMantissa = bits & ((1ULL << mantissaBits) - 1);
+  uint32_t const ieeeExponent = static_cast<uint32_t>(
+      (bits >> mantissaBits) & ((1U << exponentBits) - 1));
+  if (ieeeExponent == ((1U << exponentBits) - 1)) {
+    return length + 3;
+  }
+  if (ieeeExponent == 0 && ieeeMantissa == 0) {
+    return length + 1;
+  }
+
+  DecimalDouble const value =
+      toDecimal(ieeeMantissa, ieeeExponent, significantDigits);
+  return length + emittedLength(static_cast<int>(decimalLength(value.mantissa)),
+                                value.exponent);
+}
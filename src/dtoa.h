@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+namespace arangodb::velocypack {
+
+// maximum number of characters written by doubleToString()
+constexpr std::size_t maxDoubleStringLength = 25;
+
+// writes v into dest and returns the number of characters written. the
+// digits are the shortest sequence that parses back into v, using the
+// Ryu algorithm by Ulf Adams. if significantDigits is between 1 and 17
+// and the shortest sequence is longer than that, v is instead correctly
+// rounded to significantDigits digits. 0 means shortest round-trip
+// output. the layout is the same as the one of fpconv_dtoa(): plain
+// for numbers of moderate magnitude and scientific otherwise (e.g. "1.5",
+// "100", "1e+100", "1.2e-7"). NaN is written as "NaN" and infinity as
+// "inf", both preceded by "-" if the sign bit is set
+std::size_t doubleToString(double v, char* dest, int significantDigits = 0) noexcept;
+
+// returns the number of characters doubleToString() writes for v, without
+// writing any digits
+std::size_t doubleStringLength(double v, int significantDigits = 0) noexcept;
+
+}  // namespace arangodb::velocypack
@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+#include "velocypack/velocypack-common.h"
+#include "fast-float.h"
+#include "powers-of-five.h"
+
+using namespace arangodb::velocypack;
+
+namespace {
+
+struct UInt128 {
+  uint64_t low;
+  uint64_t high;
+};
+
+inline UInt128 fullMultiplication(uint64_t a, uint64_t b) noexcept {
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+  return UInt128{static_cast<uint64_t>(r), static_cast<uint64_t>(r >> 64)};
+#else
+  uint64_t const aLow = a & 0xffffffffULL;
+  uint64_t const aHigh = a >> 32;
+  uint64_t const bLow = b & 0xffffffffULL;
+  uint64_t const bHigh = b >> 32;
+  uint64_t const ll = aLow * bLow;
+  uint64_t const lh = aLow * bHigh;
+  uint64_t const hl = aHigh * bLow;
+  uint64_t const hh = aHigh * bHigh;
+  uint64_t const middle = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+  return UInt128{(middle << 32) | (ll & 0xffffffffULL),
+                 hh + (lh >> 32) + (hl >> 32) + (middle >> 32)};
+#endif
+}
+
+inline int leadingZeroes(uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clzll(value);
+#else
+  int count = 0;
+  while ((value & 0x8000000000000000ULL) == 0) {
+    value <<= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+// layout of an IEEE 754 double
+constexpr int mantissaBits = 52;
+constexpr int minimumExponent = -1023;
+constexpr int infinitePower = 0x7ff;
+
+// range of decimal exponents for which ties can occur, i.e. for which
+// the exact value can be half-way between two doubles
+constexpr int minExponentRoundToEven = -4;
+constexpr int maxExponentRoundToEven = 23;
+
+// Clinger's fast path requires that double arithmetic is done in double
+// precision, and not in x87 extended precision
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+constexpr bool useClingerFastPath = true;
+#else
+constexpr bool useClingerFastPath = false;
+#endif
+
+// powers of ten that can be represented exactly as doubles
+constexpr double exactPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// returns floor(log2(10^q)) + 63, valid for q in [-1233, 1233]
+inline int32_t binaryExponent(int32_t q) noexcept {
+  return (((152170 + 65536) * q) >> 16) + 63;
+}
+
+// computes the upper 128 bits of w * 5^q, where w is normalized so that
+// its most significant bit is set. only as many bits are computed as are
+// needed to determine a double mantissa with 2 extra bits
+inline UInt128 productApproximation(int64_t q, uint64_t w) noexcept {
+  int const index = 2 * static_cast<int>(q - smallestPowerOfFive);
+  constexpr uint64_t precisionMask = 0xFFFFFFFFFFFFFFFFULL >> (mantissaBits + 3);
+  UInt128 first = fullMultiplication(w, powersOfFive128[index]);
+  if ((first.high & precisionMask) == precisionMask) {
+    // the lower bits are inconclusive. also take the lower half of the
+    // power of five into account
+    UInt128 second = fullMultiplication(w, powersOfFive128[index + 1]);
+    first.low += second.high;
+    if (second.high > first.low) {
+      first.high++;
+    }
+  }
+  return first;
+}
+
+inline double assemble(uint64_t mantissa, int32_t power2) noexcept {
+  uint64_t bits = mantissa | (static_cast<uint64_t>(power2) << mantissaBits);
+  double result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+}  // namespace
+
+double arangodb::velocypack::decimalToDouble(uint64_t w, int64_t q) noexcept {
+  if (useClingerFastPath && q >= -22 && q <= 22 && w <= (1ULL << 53)) {
+    // both w and 10^|q| are exact doubles, so a single multiplication or
+    // division gives the correctly rounded result
+    double const value = static_cast<double>(w);
+    if (q < 0) {
+      return value / exactPowersOfTen[-q];
+    }
+    return value * exactPowersOfTen[q];
+  }
+
+  if (w == 0 || q < smallestPowerOfFive) {
+    return 0.0;
+  }
+  if (q > largestPowerOfFive) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  // Eisel-Lemire: multiply the normalized mantissa with the 128-bit
+  // approximation of 5^q. the error of the approximation is small enough
+  // to always determine the correctly rounded result
+  int const lz = leadingZeroes(w);
+  w <<= lz;
+
+  UInt128 const product = productApproximation(q, w);
+  int const upperBit = static_cast<int>(product.high >> 63);
+  int const shift = upperBit + 64 - mantissaBits - 3;
+
+  uint64_t mantissa = product.high >> shift;
+  int32_t power2 = binaryExponent(static_cast<int32_t>(q)) + upperBit - lz -
+                   minimumExponent;
+
+  if (power2 <= 0) {
+    // subnormal number
+    if (-power2 + 1 >= 64) {
+      return 0.0;
+    }
+    mantissa >>= -power2 + 1;
+    // round up. ties cannot occur for subnormal numbers
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+    // rounding up may have produced the smallest normal number
+    power2 = (mantissa < (1ULL << mantissaBits)) ? 0 : 1;
+    return assemble(mantissa & ~(1ULL << mantissaBits), power2);
+  }
+
+  // we usually round up, but if the value is exactly half-way between
+  // two doubles and the lower one is even, we must round down
+  if (product.low <= 1 && q >= minExponentRoundToEven &&
+      q <= maxExponentRoundToEven && (mantissa & 3) == 1) {
+    if ((mantissa << shift) == product.high) {
+      // only zeros were shifted out, so we are half-way
+      mantissa &= ~1ULL;
+    }
+  }
+
+  mantissa += (mantissa & 1);
+  mantissa >>= 1;
+  if (mantissa >= (2ULL << mantissaBits)) {
+    // rounding overflowed into the next power of two
+    mantissa = (1ULL << mantissaBits);
+    power2++;
+  }
+  mantissa &= ~(1ULL << mantissaBits);
+
+  if (power2 >= infinitePower) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return assemble(mantissa, power2);
+}
+
+double arangodb::velocypack::decimalToDoubleSlow(char const* text,
+                                                 std::size_t length,
+                                                 double estimate) noexcept {
+#if defined(__cpp_lib_to_chars)
+  // std::from_chars is exact and does not depend on the current locale
+  double value = 0.0;
+  auto result = std::from_chars(text, text + length, value);
+  if (result.ec == std::errc::result_out_of_range) {
+    // the estimate tells whether this was an overflow or an underflow
+    return (estimate > 1.0) ? std::numeric_limits<double>::infinity() : 0.0;
+  }
+  return value;
+#else
+  // strtod() expects a null-terminated string
+  std::string copy(text, length);
+  return strtod(copy.c_str(), nullptr);
+#endif
+}
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arangodb::velocypack {
+
+// a decimal number as read from JSON input, with the value
+// mantissa * 10^exponent. digits that do not fit into the 64-bit
+// mantissa anymore are dropped and only counted in the exponent
+struct ParsedNumber {
+  uint64_t mantissa = 0;
+  int64_t exponent = 0;
+  // set when the first digit was dropped. all following digits are
+  // dropped as well
+  bool full = false;
+  // set when a non-zero digit was dropped, i.e. when the mantissa
+  // is not exact
+  bool truncated = false;
+
+  // appends a digit (0-9) of the integral part (fractional == false) or
+  // of the fractional part (fractional == true) to the mantissa
+  void addDigit(unsigned int d, bool fractional) noexcept {
+    if (!full) {
+      // check if adding another digit to the mantissa will make it overflow
+      if (mantissa < 1844674407370955161ULL ||
+          (mantissa == 1844674407370955161ULL && d <= 5)) {
+        mantissa = mantissa * 10 + d;
+        if (fractional) {
+          --exponent;
+        }
+        return;
+      }
+      full = true;
+    }
+    truncated |= (d != 0);
+    if (!fractional) {
+      ++exponent;
+    }
+  }
+
+  // appends a digit (0-9) to the explicit exponent value. very large
+  // exponents are capped, as they will produce an overflow or underflow
+  // anyway
+  static int64_t addExponentDigit(int64_t value, unsigned int d) noexcept {
+    return value < 100000000 ? value * 10 + d : value;
+  }
+};
+
+// returns the double nearest to mantissa * 10^exponent, with ties rounded
+// to even. returns infinity if the value is too large for a double.
+// uses the algorithm by Clinger for small exponents and the one by Eisel
+// and Lemire otherwise, both of which are exact
+double decimalToDouble(uint64_t mantissa, int64_t exponent) noexcept;
+
+// converts the decimal number in text (without a sign) to the nearest
+// double. this is much slower than decimalToDouble(), and only needed
+// when the number has more significant digits than fit into a uint64_t
+// and the rounding cannot be decided from the first 19 or 20 of them.
+// estimate must be the result of decimalToDouble() for these digits.
+// returns infinity if the value is too large for a double
+double decimalToDoubleSlow(char const* text, std::size_t length,
+                           double estimate) noexcept;
+
+}  // namespace arangodb::velocypack
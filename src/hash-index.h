@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+#include "velocypack/velocypack-common.h"
+
+// Helpers for the hash table of hash-indexed Objects (type 0x15). The
+// table has hashIndexSlots(n) slots of 4 bytes each, stored in little
+// endian right in front of the index table. An empty slot is 0, all other
+// slots contain the top 8 bits of the key hash in the upper byte and the
+// position of the member in the sorted index table plus 1 in the lower
+// 3 bytes. Collisions are resolved with linear probing.
+// All of this is part of the storage format and must never change.
+
+namespace arangodb::velocypack {
+
+// Objects with more members than this cannot be hash-indexed
+static constexpr ValueLength hashIndexMaxMembers = 0xffffffULL - 1;
+
+// number of hash table slots for an Object with n members. this is a power
+// of two, and there is always at least one empty slot, so that lookups of
+// non-existing keys terminate
+constexpr ValueLength hashIndexSlots(ValueLength n) noexcept {
+  ValueLength slots = 4;
+  while (slots < n + (n >> 1) + 1) {
+    slots <<= 1;
+  }
+  return slots;
+}
+
+inline uint64_t hashIndexKey(char const* key, ValueLength length) noexcept {
+  return VELOCYPACK_HASH_WYHASH(key, static_cast<std::size_t>(length), 0);
+}
+
+constexpr uint32_t hashIndexFingerprint(uint64_t hash) noexcept {
+  return static_cast<uint32_t>(hash >> 56);
+}
+
+constexpr uint32_t hashIndexEntry(uint64_t hash, ValueLength position) noexcept {
+  return (hashIndexFingerprint(hash) << 24) | static_cast<uint32_t>(position + 1);
+}
+
+}  // namespace arangodb::velocypack
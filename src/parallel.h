@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// Fan-out of independent pieces of work to threads, used by BulkParser,
+// the multi-threaded Validator and Collection::sort.
+
+namespace arangodb::velocypack {
+
+// the number of threads to use for a requested concurrency, where 0
+// means one thread per hardware thread
+inline std::size_t resolveConcurrency(std::size_t concurrency) noexcept {
+  if (concurrency == 0) {
+    concurrency = std::thread::hardware_concurrency();
+    if (concurrency == 0) {
+      concurrency = 1;
+    }
+  }
+  return concurrency;
+}
+
+// runs func(0) to func(count - 1), each on its own thread. the calling
+// thread runs func(0) itself, and also takes over all functions for which
+// no thread could be started. once all functions have returned, the
+// exception thrown by the function with the lowest index, if any, is
+// rethrown
+template<typename F>
+void runParallel(std::size_t count, F const& func) {
+  if (count == 0) {
+    return;
+  }
+
+  std::vector<std::exception_ptr> errors(count);
+  auto run = [&](std::size_t i) {
+    try {
+      func(i);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(count - 1);
+  try {
+    for (std::size_t i = 1; i < count; ++i) {
+      threads.emplace_back(run, i);
+    }
+  } catch (...) {
+    for (std::size_t i = threads.size() + 1; i < count; ++i) {
+      run(i);
+    }
+  }
+  run(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto const& error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+}  // namespace arangodb::velocypack
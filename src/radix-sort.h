@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2014-2020 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Radix sort on 64-bit keys, used for sorting the index tables of Objects
+// in Builder and for Collection::sort.
+
+namespace arangodb::velocypack {
+
+// the first 8 bytes of a string as a big-endian number, padded with zero
+// bytes. strings with different prefixes compare like their prefixes
+inline uint64_t radixPrefixKey(uint8_t const* data, std::size_t size) noexcept {
+  uint64_t key = 0;
+  std::size_t const n = (std::min)(size, sizeof(key));
+  for (std::size_t i = 0; i < n; ++i) {
+    key |= uint64_t(data[i]) << (56 - 8 * i);
+  }
+  return key;
+}
+
+// least significant digit radix sort of the n items by key(item), one
+// byte per pass, using buffer as scratch space for n items. passes in
+// which all keys have the same byte are skipped
+template<typename T, typename Key>
+void radixSort(T* items, T* buffer, std::size_t n, Key key) {
+  if (n < 2) {
+    return;
+  }
+  std::array<std::array<std::size_t, 256>, 8> counts{};
+  for (std::size_t i = 0; i < n; i++) {
+    uint64_t const k = key(items[i]);
+    for (std::size_t pass = 0; pass < 8; ++pass) {
+      ++counts[pass][(k >> (8 * pass)) & 0xff];
+    }
+  }
+
+  T* from = items;
+  T* to = buffer;
+  for (std::size_t pass = 0; pass < 8; ++pass) {
+    auto& count = counts[pass];
+    std::size_t const shift = 8 * pass;
+    if (count[(key(from[0]) >> shift) & 0xff] == n) {
+      continue;
+    }
+    std::size_t offset = 0;
+    for (auto& c : count) {
+      std::size_t const next = offset + c;
+      c = offset;
+      offset = next;
+    }
+    for (std::size_t i = 0; i < n; i++) {
+      to[count[(key(from[i]) >> shift) & 0xff]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != items) {
+    std::copy(from, from + n, items);
+  }
+}
+
+// as above, but keys only decide the order of items with different keys,
+// e.g. prefix keys. afterwards, items with equal keys are sorted with less
+template<typename T, typename Key, typename Less>
+void radixSort(T* items, T* buffer, std::size_t n, Key key, Less less) {
+  radixSort(items, buffer, n, key);
+
+  std::size_t runStart = 0;
+  for (std::size_t i = 1; i <= n; ++i) {
+    if (i < n && key(items[i]) == key(items[runStart])) {
+      continue;
+    }
+    if (i - runStart > 1) {
+      std::sort(items + runStart, items + i, less);
+    }
+    runStart = i;
+  }
+}
+
+}  // namespace arangodb::velocypack
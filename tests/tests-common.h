@@ -1,21 +1,28 @@
 
 #include "velocypack/velocypack-common.h"
+#include "velocypack/AttributeSet.h"
 #include "velocypack/AttributeTranslator.h"
 #include "velocypack/Basics.h"
 #include "velocypack/Buffer.h"
 #include "velocypack/Builder.h"
+#include "velocypack/BulkParser.h"
 #include "velocypack/Collection.h"
+#include "velocypack/CompiledPath.h"
 #include "velocypack/Compare.h"
 #include "velocypack/Dumper.h"
 #include "velocypack/Exception.h"
 #include "velocypack/HashedStringRef.h"
 #include "velocypack/HexDump.h"
 #include "velocypack/Iterator.h"
+#include "velocypack/MappedFile.h"
+#include "velocypack/ObjectShape.h"
 #include "velocypack/Options.h"
 #include "velocypack/Parser.h"
+#include "velocypack/Serializer.h"
 #include "velocypack/Sink.h"
 #include "velocypack/Slice.h"
 #include "velocypack/SliceContainer.h"
+#include "velocypack/StreamParser.h"
 #include "velocypack/StringRef.h"
 #include "velocypack/Validator.h"
 #include "velocypack/Value.h"
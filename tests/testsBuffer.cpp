@@ -27,6 +27,7 @@
 #include <ostream>
 #include <string>
 #include <iostream>
+#include <memory_resource>
 
 #include "tests-common.h"
 
@@ -536,6 +537,86 @@ TEST(BufferTest, BufferNonDeleterTest) {
   ASSERT_EQ(2308, buffer.size());
 }
 
+// memory resource that keeps track of its outstanding allocations
+struct CountingResource : public std::pmr::memory_resource {
+  std::size_t allocations = 0;
+  std::size_t outstanding = 0;
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+TEST(BufferTest, MemoryResource) {
+  CountingResource resource;
+  {
+    Buffer<uint8_t> buffer(&resource);
+    ASSERT_EQ(&resource, buffer.memoryResource());
+    ASSERT_EQ(0U, resource.allocations);
+
+    for (std::size_t i = 0; i < 4096; ++i) {
+      buffer.push_back(static_cast<char>('a' + (i % 26)));
+    }
+    ASSERT_FALSE(buffer.usesLocalMemory());
+    ASSERT_TRUE(resource.allocations > 0);
+    ASSERT_EQ(buffer.capacity(), resource.outstanding);
+    for (std::size_t i = 0; i < 4096; ++i) {
+      ASSERT_EQ('a' + (i % 26), buffer[i]);
+    }
+
+    // copies do not use the resource
+    std::size_t const allocations = resource.allocations;
+    Buffer<uint8_t> copy(buffer);
+    ASSERT_EQ(nullptr, copy.memoryResource());
+    ASSERT_EQ(allocations, resource.allocations);
+    ASSERT_EQ(buffer.toString(), copy.toString());
+
+    // copy assignment keeps the target's resource
+    Buffer<uint8_t> other(&resource);
+    other = copy;
+    ASSERT_EQ(&resource, other.memoryResource());
+    ASSERT_EQ(buffer.toString(), other.toString());
+
+    // moves take the resource along
+    Buffer<uint8_t> moved(std::move(buffer));
+    ASSERT_EQ(&resource, moved.memoryResource());
+    ASSERT_EQ(copy.toString(), moved.toString());
+
+    copy = std::move(moved);
+    ASSERT_EQ(&resource, copy.memoryResource());
+    ASSERT_EQ(other.toString(), copy.toString());
+
+    copy.clear();
+    ASSERT_TRUE(copy.usesLocalMemory());
+    ASSERT_EQ(other.capacity(), resource.outstanding);
+  }
+  ASSERT_EQ(0U, resource.outstanding);
+}
+
+TEST(BufferTest, MonotonicMemoryResource) {
+  alignas(16) char memory[8192];
+  std::pmr::monotonic_buffer_resource resource(memory, sizeof(memory),
+                                               std::pmr::null_memory_resource());
+  Buffer<uint8_t> buffer(&resource);
+  for (std::size_t i = 0; i < 2048; ++i) {
+    buffer.push_back('x');
+  }
+  ASSERT_EQ(2048U, buffer.size());
+  ASSERT_TRUE(reinterpret_cast<char*>(buffer.data()) >= memory);
+  ASSERT_TRUE(reinterpret_cast<char*>(buffer.data()) < memory + sizeof(memory));
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -24,11 +24,16 @@
 /// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <array>
 #include <iostream>
+#include <memory_resource>
 #include <ostream>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "tests-common.h"
 
@@ -1292,6 +1297,49 @@ TEST(BuilderTest, ObjectSorted) {
   ASSERT_EQ(0, memcmp(result, correctResult, len));
 }
 
+TEST(BuilderTest, ObjectSortedIndexWide) {
+  // covers the insertion sort, comparison sort and radix sort paths,
+  // with names sharing long prefixes and names that are prefixes of
+  // other names
+  for (std::size_t n : {5, 20, 33, 100, 255, 256, 1000}) {
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i < n; ++i) {
+      std::string key;
+      switch (i % 4) {
+        case 0: key = "attribute-" + std::to_string(i); break;
+        case 1: key = std::string(i % 11, 'x'); break;
+        case 2: key = std::string("a\0b", 3) + std::to_string(i); break;
+        default: key = std::to_string(i * 7919); break;
+      }
+      keys.push_back(std::move(key));
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::vector<std::string> shuffled = keys;
+    std::reverse(shuffled.begin(), shuffled.end());
+    for (std::size_t i = 0; i < shuffled.size(); i += 3) {
+      std::swap(shuffled[i], shuffled[(i * 17) % shuffled.size()]);
+    }
+
+    for (auto const* input : {&keys, &shuffled}) {
+      Builder b;
+      b.openObject();
+      for (auto const& key : *input) {
+        b.add(key, Value(key.size()));
+      }
+      b.close();
+
+      Slice s = b.slice();
+      ASSERT_EQ(keys.size(), s.length());
+      for (std::size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_EQ(keys[i], s.keyAt(i).stringView());
+        ASSERT_EQ(keys[i].size(), s.valueAt(i).getUInt());
+      }
+    }
+  }
+}
+
 TEST(BuilderTest, ObjectCompact) {
   double value = 2.3;
   Builder b;
@@ -3702,6 +3750,553 @@ TEST(BuilderTest, stealSharedSlice) {
   check(largeBuilder, false);
 }
 
+TEST(BuilderTest, MemoryResource) {
+  auto build = [](Builder& b) {
+    b.openObject();
+    for (std::size_t i = 0; i < 200; ++i) {
+      b.add("key" + std::to_string(i), Value(ValueType::Array));
+      b.add(Value(i));
+      b.add(Value(std::string(i % 40, 'x')));
+      b.close();
+    }
+    b.close();
+  };
+
+  Builder expected;
+  build(expected);
+
+  // everything must fit into the arena, the upstream resource
+  // throws on any allocation
+  std::vector<char> memory(256 * 1024);
+  std::pmr::monotonic_buffer_resource resource(memory.data(), memory.size(),
+                                               std::pmr::null_memory_resource());
+  Builder b(&resource, &Options::Defaults);
+  ASSERT_EQ(&resource, b.bufferRef().memoryResource());
+  build(b);
+  ASSERT_TRUE(b.data() >= reinterpret_cast<uint8_t const*>(memory.data()));
+  ASSERT_TRUE(b.data() < reinterpret_cast<uint8_t const*>(memory.data() + memory.size()));
+  ASSERT_EQ(expected.size(), b.size());
+  ASSERT_EQ(0, memcmp(expected.data(), b.data(), b.size()));
+
+  // reuse the Builder
+  b.clear();
+  build(b);
+  ASSERT_EQ(0, memcmp(expected.data(), b.data(), b.size()));
+
+  // copies and shared slices do not refer to the arena
+  Builder copy(b);
+  ASSERT_EQ(nullptr, copy.bufferRef().memoryResource());
+  ASSERT_EQ(0, memcmp(expected.data(), copy.data(), copy.size()));
+
+  SharedSlice shared = std::move(b).sharedSlice();
+  ASSERT_TRUE(shared.start().get() < reinterpret_cast<uint8_t const*>(memory.data()) ||
+              shared.start().get() >= reinterpret_cast<uint8_t const*>(memory.data() + memory.size()));
+  ASSERT_EQ(0, memcmp(expected.data(), shared.start().get(), expected.size()));
+}
+
+TEST(BuilderTest, MemoryResourceMoveAssign) {
+  auto fill = [](Builder& b) {
+    b.openObject();
+    for (std::size_t i = 0; i < 1000; ++i) {
+      b.add("test" + std::to_string(i), Value(i));
+    }
+  };
+
+  // the index tables of the open Object are copied into the arena
+  std::vector<char> memory(256 * 1024);
+  std::pmr::monotonic_buffer_resource resource(memory.data(), memory.size(),
+                                               std::pmr::null_memory_resource());
+  Builder b(&resource, &Options::Defaults);
+  Builder heap;
+  fill(heap);
+  b = std::move(heap);
+  b.close();
+  ASSERT_EQ(1000U, b.slice().length());
+  ASSERT_EQ(999U, b.slice().get("test999").getUInt());
+
+  // the arena is too small for the index tables, which is reported
+  // instead of terminating
+  std::vector<char> small(1024);
+  std::pmr::monotonic_buffer_resource smallResource(small.data(), small.size(),
+                                                    std::pmr::null_memory_resource());
+  Builder tiny(&smallResource, &Options::Defaults);
+  Builder other;
+  fill(other);
+  ASSERT_THROW(tiny = std::move(other), std::bad_alloc);
+  // neither Builder was modified
+  ASSERT_TRUE(tiny.isEmpty());
+  other.close();
+  ASSERT_EQ(1000U, other.slice().length());
+}
+
+TEST(BuilderTest, MemoryResourceNullptr) {
+  std::pmr::memory_resource* resource = nullptr;
+  ASSERT_VELOCYPACK_EXCEPTION(new Builder(resource, &Options::Defaults),
+                              Exception::InternalError);
+  ASSERT_VELOCYPACK_EXCEPTION(new Builder(std::pmr::new_delete_resource(), nullptr),
+                              Exception::InternalError);
+}
+
+TEST(BuilderTest, HashIndexedObjectThreshold) {
+  Options options;
+  options.buildHashIndexedObjectsThreshold = 3;
+
+  auto build = [&options](std::size_t n) {
+    Builder b(&options);
+    b.openObject();
+    for (std::size_t i = 0; i < n; ++i) {
+      b.add("test" + std::to_string(i), Value(i));
+    }
+    b.close();
+    return b;
+  };
+
+  ASSERT_EQ(0x0b, build(2).slice().head());
+  ASSERT_EQ(0x15, build(3).slice().head());
+
+  options.buildHashIndexedObjectsThreshold = 0;
+  ASSERT_EQ(0x0b, build(3).slice().head());
+}
+
+TEST(BuilderTest, HashIndexedObjectLayout) {
+  Options options;
+  options.buildHashIndexedObjectsThreshold = 1;
+
+  Builder b(&options);
+  b.openObject();
+  b.add("b", Value(1));
+  b.add("a", Value(2));
+  b.close();
+
+  Slice s = b.slice();
+  uint8_t const* data = s.start();
+  // head, 4 byte length, 4 byte number of members, members, 4 hash table
+  // slots with 4 bytes each and the index table with 4 bytes per member
+  ValueLength const size = 1 + 4 + 4 + 2 * 3 + 4 * 4 + 2 * 4;
+  ASSERT_EQ(size, b.size());
+  ASSERT_EQ(size, s.byteSize());
+  ASSERT_EQ(0x15, data[0]);
+  ASSERT_EQ(size, data[1]);
+  ASSERT_EQ(0, data[2]);
+  ASSERT_EQ(0, data[3]);
+  ASSERT_EQ(0, data[4]);
+  ASSERT_EQ(2, data[5]);
+  ASSERT_EQ(0, data[6]);
+  ASSERT_EQ(0, data[7]);
+  ASSERT_EQ(0, data[8]);
+  ASSERT_EQ(0x41, data[9]);
+  ASSERT_EQ('b', data[10]);
+  ASSERT_EQ(0x31, data[11]);
+  ASSERT_EQ(0x41, data[12]);
+  ASSERT_EQ('a', data[13]);
+  ASSERT_EQ(0x32, data[14]);
+  // index table is sorted by attribute name
+  ASSERT_EQ(12, data[size - 8]);
+  ASSERT_EQ(9, data[size - 4]);
+
+  // two of the hash table slots are occupied
+  int occupied = 0;
+  for (std::size_t i = 0; i < 4; ++i) {
+    uint8_t const* slot = data + 15 + 4 * i;
+    if (slot[0] != 0 || slot[1] != 0 || slot[2] != 0 || slot[3] != 0) {
+      ASSERT_TRUE(slot[0] == 1 || slot[0] == 2);
+      ++occupied;
+    }
+  }
+  ASSERT_EQ(2, occupied);
+
+  ASSERT_TRUE(s.isObject());
+  ASSERT_TRUE(s.isSorted());
+  ASSERT_EQ(2U, s.length());
+  ASSERT_EQ("a", s.keyAt(0).copyString());
+  ASSERT_EQ("b", s.keyAt(1).copyString());
+  ASSERT_EQ(2, s.valueAt(0).getInt());
+  ASSERT_EQ(1, s.valueAt(1).getInt());
+  ASSERT_EQ(1, s.get("b").getInt());
+  ASSERT_EQ(2, s.get("a").getInt());
+  ASSERT_TRUE(s.get("c").isNone());
+}
+
+TEST(BuilderTest, HashIndexedObjectNested) {
+  Options options;
+  options.buildHashIndexedObjectsThreshold = 2;
+
+  Builder b(&options);
+  b.openObject();
+  b.add("foo", Value(ValueType::Object));
+  b.add("bar", Value(1));
+  b.add("baz", Value(2));
+  b.close();
+  b.add("qux", Value(ValueType::Array));
+  b.add(Value(3));
+  b.close();
+  b.add("one", Value(ValueType::Object));
+  b.add("only", Value(4));
+  b.close();
+  b.close();
+
+  Slice s = b.slice();
+  ASSERT_EQ(0x15, s.head());
+  ASSERT_EQ(0x15, s.get("foo").head());
+  ASSERT_EQ(0x14, s.get("one").head());
+  ASSERT_EQ(2, s.get(std::vector<std::string>({"foo", "baz"})).getInt());
+  ASSERT_EQ(3, s.get("qux").at(0).getInt());
+  ASSERT_EQ(4, s.get(std::vector<std::string>({"one", "only"})).getInt());
+}
+
+TEST(BuilderTest, HashIndexedObjectUnindexed) {
+  Options options;
+  options.buildHashIndexedObjectsThreshold = 1;
+  options.buildUnindexedObjects = true;
+
+  Builder b(&options);
+  b.openObject();
+  b.add("foo", Value(1));
+  b.add("bar", Value(2));
+  b.close();
+
+  ASSERT_EQ(0x14, b.slice().head());
+}
+
+TEST(BuilderTest, HashIndexedObjectAttributeUniqueness) {
+  Options options;
+  options.buildHashIndexedObjectsThreshold = 1;
+  options.checkAttributeUniqueness = true;
+
+  Builder b(&options);
+  b.openObject();
+  b.add("foo", Value(1));
+  b.add("bar", Value(2));
+  b.add("foo", Value(3));
+  ASSERT_VELOCYPACK_EXCEPTION(b.close(), Exception::DuplicateAttributeName);
+}
+
+TEST(BuilderTest, HashIndexedObjectIntegerKeys) {
+  std::unique_ptr<AttributeTranslator> translator(new AttributeTranslator);
+
+  translator->add("foo", 1);
+  translator->add("bar", 2);
+  translator->seal();
+
+  AttributeTranslatorScope scope(translator.get());
+
+  Options options;
+  options.attributeTranslator = translator.get();
+  options.buildHashIndexedObjectsThreshold = 1;
+
+  Builder b(&options);
+  b.openObject();
+  b.add("foo", Value(1));
+  b.add("baz", Value(2));
+  b.close();
+
+  // translated keys cannot be hashed, so the Object gets no hash table
+  Slice s = b.slice();
+  ASSERT_EQ(0x0b, s.head());
+  ASSERT_EQ(1, s.get("foo").getInt());
+  ASSERT_EQ(2, s.get("baz").getInt());
+}
+
+TEST(BuilderTest, ObjectShape) {
+  ObjectShape shape({"time", "level", "message", "a", "z", "host"});
+  ASSERT_EQ(6, shape.size());
+  ASSERT_EQ("message", shape[2]);
+
+  auto check = [&shape](Options const* options) {
+    Builder expected(options);
+    expected.openObject();
+    expected.add("time", Value(1234567));
+    expected.add("level", Value("info"));
+    expected.add("message", Value(std::string(300, 'x')));
+    expected.add("a", Value(ValueType::Null));
+    expected.add("z", Value(ValueType::Array));
+    expected.add(Value(1));
+    expected.add(Value(2));
+    expected.close();
+    expected.add("host", Value("localhost"));
+    expected.close();
+
+    Builder b(options);
+    b.openObject(shape);
+    ASSERT_TRUE(b.isOpenObject());
+    ASSERT_FALSE(b.isOpenArray());
+    b.add(Value(1234567));
+    b.add(Value("info"));
+    b.add(Value(std::string(300, 'x')));
+    b.add(Value(ValueType::Null));
+    b.openArray();
+    b.add(Value(1));
+    b.add(Value(2));
+    b.close();
+    b.add(Value("localhost"));
+    ASSERT_EQ("info", b.getKey("level").copyString());
+    b.close();
+
+    ASSERT_EQ(expected.size(), b.size());
+    ASSERT_EQ(0, memcmp(expected.start(), b.start(), b.size()));
+  };
+
+  Options options;
+  check(&options);
+  options.paddingBehavior = Options::PaddingBehavior::NoPadding;
+  check(&options);
+  options.paddingBehavior = Options::PaddingBehavior::UsePadding;
+  check(&options);
+  options.paddingBehavior = Options::PaddingBehavior::Flexible;
+  options.buildUnindexedObjects = true;
+  check(&options);
+  options.buildUnindexedObjects = false;
+  options.buildHashIndexedObjectsThreshold = 3;
+  check(&options);
+  options.buildHashIndexedObjectsThreshold = 0;
+  options.checkAttributeUniqueness = true;
+  check(&options);
+}
+
+TEST(BuilderTest, ObjectShapeNested) {
+  ObjectShape outer({"b", "a"});
+  ObjectShape inner({"y", "x"});
+
+  Builder b;
+  b.openArray();
+  for (int i = 0; i < 3; ++i) {
+    b.openObject(outer);
+    b.openObject(inner);
+    b.add(Value(i));
+    b.add(Value(-i));
+    b.close();
+    b.openObject();
+    b.add("c", Value(true));
+    b.close();
+    b.close();
+  }
+  b.close();
+
+  ASSERT_EQ(
+      "[{\"a\":{\"c\":true},\"b\":{\"x\":0,\"y\":0}},"
+      "{\"a\":{\"c\":true},\"b\":{\"x\":-1,\"y\":1}},"
+      "{\"a\":{\"c\":true},\"b\":{\"x\":-2,\"y\":2}}]",
+      b.toJson());
+  Slice s = b.slice().at(1);
+  ASSERT_TRUE(s.isSorted());
+  ASSERT_EQ(-1, s.get(std::vector<std::string>({"b", "x"})).getInt());
+}
+
+TEST(BuilderTest, ObjectShapeEmpty) {
+  ObjectShape shape(std::vector<std::string>{});
+  Builder b;
+  b.openObject(shape);
+  ASSERT_VELOCYPACK_EXCEPTION(b.add(Value(1)), Exception::BuilderShapeMismatch);
+  b.close();
+  ASSERT_EQ("{}", b.toJson());
+}
+
+TEST(BuilderTest, ObjectShapeMismatch) {
+  ObjectShape shape({"a", "b"});
+
+  Builder b;
+  b.openObject(shape);
+  b.add(Value(1));
+  ASSERT_VELOCYPACK_EXCEPTION(b.close(), Exception::BuilderShapeMismatch);
+  ASSERT_VELOCYPACK_EXCEPTION(b.add("b", Value(2)), Exception::BuilderNeedOpenObject);
+  b.add(Value(2));
+  ASSERT_VELOCYPACK_EXCEPTION(b.add(Value(3)), Exception::BuilderShapeMismatch);
+  ASSERT_VELOCYPACK_EXCEPTION(b.openArray(), Exception::BuilderShapeMismatch);
+  b.close();
+  ASSERT_EQ("{\"a\":1,\"b\":2}", b.toJson());
+}
+
+TEST(BuilderTest, ObjectShapeFailedAdd) {
+  ObjectShape shape({"a", "b"});
+  Options options;
+  options.disallowTags = true;
+
+  Builder b(&options);
+  b.openObject(shape);
+  b.add(Value(1));
+  ASSERT_VELOCYPACK_EXCEPTION(b.addTagged(42, Value(2)), Exception::BuilderTagsDisallowed);
+  b.add(Value(2));
+  b.close();
+  ASSERT_EQ("{\"a\":1,\"b\":2}", b.toJson());
+}
+
+TEST(BuilderTest, ObjectShapeDuplicateNames) {
+  ASSERT_VELOCYPACK_EXCEPTION(ObjectShape({"a", "b", "a"}),
+                              Exception::DuplicateAttributeName);
+}
+
+template<typename T, typename = void>
+struct canOpenObjectWith : std::false_type {};
+
+template<typename T>
+struct canOpenObjectWith<
+    T, std::void_t<decltype(std::declval<Builder&>().openObject(
+           std::declval<T>()))>> : std::true_type {};
+
+TEST(BuilderTest, ObjectShapeNoTemporaries) {
+  // openObject() keeps a pointer to the shape, so it must not accept
+  // temporaries, including ones created implicitly from a list of names
+  static_assert(canOpenObjectWith<ObjectShape&>::value);
+  static_assert(canOpenObjectWith<ObjectShape const&>::value);
+  static_assert(!canOpenObjectWith<ObjectShape>::value);
+  static_assert(!canOpenObjectWith<std::initializer_list<std::string_view>>::value);
+  static_assert(!std::is_convertible_v<std::initializer_list<std::string_view>,
+                                       ObjectShape>);
+  static_assert(!std::is_convertible_v<std::vector<std::string>, ObjectShape>);
+}
+
+TEST(BuilderTest, ObjectShapeAttributeTranslations) {
+  std::unique_ptr<AttributeTranslator> translator(new AttributeTranslator);
+  translator->add("foo", 1);
+  translator->add("bar", 2);
+  translator->seal();
+
+  AttributeTranslatorScope scope(translator.get());
+
+  Options options;
+  options.attributeTranslator = translator.get();
+  ObjectShape shape({"foo", "baz", "bar"}, &options);
+
+  Builder expected(&options);
+  expected.openObject();
+  expected.add("foo", Value(1));
+  expected.add("baz", Value(2));
+  expected.add("bar", Value(3));
+  expected.close();
+
+  Builder b(&options);
+  b.openObject(shape);
+  b.add(Value(1));
+  b.add(Value(2));
+  b.add(Value(3));
+  b.close();
+
+  ASSERT_EQ(expected.size(), b.size());
+  ASSERT_EQ(0, memcmp(expected.start(), b.start(), b.size()));
+  ASSERT_EQ(3, b.slice().get("bar").getInt());
+
+  // the keys could not be resolved by Builders with another translator
+  ASSERT_EQ(translator.get(), shape.attributeTranslator());
+  Options plainOptions;
+  plainOptions.attributeTranslator = nullptr;
+  Builder untranslated(&plainOptions);
+  ASSERT_VELOCYPACK_EXCEPTION(untranslated.openObject(shape),
+                              Exception::BuilderShapeMismatch);
+  ASSERT_TRUE(untranslated.isEmpty());
+
+  std::unique_ptr<AttributeTranslator> other(new AttributeTranslator);
+  other->seal();
+  Options otherOptions;
+  otherOptions.attributeTranslator = other.get();
+  Builder otherBuilder(&otherOptions);
+  ASSERT_VELOCYPACK_EXCEPTION(otherBuilder.openObject(shape),
+                              Exception::BuilderShapeMismatch);
+
+  ObjectShape plain({"foo"}, &plainOptions);
+  ASSERT_EQ(nullptr, plain.attributeTranslator());
+  ASSERT_VELOCYPACK_EXCEPTION(b.openObject(plain),
+                              Exception::BuilderShapeMismatch);
+}
+
+static void checkNormalizedHashes(Builder const& b, Slice s) {
+  ASSERT_EQ(s.normalizedHash(), b.normalizedHash(s));
+  if (s.isArray()) {
+    for (auto it : ArrayIterator(s)) {
+      checkNormalizedHashes(b, it);
+    }
+  } else if (s.isObject()) {
+    for (auto it : ObjectIterator(s)) {
+      checkNormalizedHashes(b, it.value);
+    }
+  }
+}
+
+TEST(BuilderTest, NormalizedHashCache) {
+  std::string const value(
+      "{\"foo\":[1,2.5,{\"a\":[true,null],\"b\":\"x\"}],\"bar\":{\"baz\":[[],[-1]],"
+      "\"qux\":{}},\"z\":[1,[2,[3,[4]]]]}");
+
+  Options options;
+  options.normalizedHashCacheThreshold = 1;
+
+  Parser parser(&options);
+  parser.parse(value);
+  std::shared_ptr<Builder> b = parser.steal();
+  checkNormalizedHashes(*b, b->slice());
+
+  options.buildUnindexedArrays = true;
+  options.buildUnindexedObjects = true;
+  options.buildHashIndexedObjectsThreshold = 2;
+  Parser parser2(&options);
+  parser2.parse(value);
+  b = parser2.steal();
+  checkNormalizedHashes(*b, b->slice());
+}
+
+TEST(BuilderTest, NormalizedHashCacheIsUsed) {
+  Options options;
+  options.normalizedHashCacheThreshold = 8;
+
+  Builder b(&options);
+  b.openArray();
+  b.add(Value(1));
+  b.openArray();
+  b.add(Value(2));
+  b.close();
+  b.add(Value("a long enough string"));
+  b.close();
+
+  Slice s = b.slice();
+  uint64_t const top = s.normalizedHash();
+  uint64_t const small = s.at(1).normalizedHash();
+
+  // change the values behind the Builder's back. only the hash of the
+  // small inner Array is computed again
+  const_cast<uint8_t*>(s.at(0).start())[0] = 0x33;
+  const_cast<uint8_t*>(s.at(1).at(0).start())[0] = 0x34;
+  ASSERT_NE(top, s.normalizedHash());
+  ASSERT_EQ(top, b.normalizedHash(s));
+  ASSERT_NE(small, s.at(1).normalizedHash());
+  ASSERT_EQ(s.at(1).normalizedHash(), b.normalizedHash(s.at(1)));
+
+  // copies keep the cache
+  Builder copy(b);
+  ASSERT_EQ(top, copy.normalizedHash(copy.slice()));
+
+  // slices from elsewhere are hashed as usual
+  Builder other;
+  other.add(s);
+  ASSERT_EQ(other.slice().normalizedHash(), b.normalizedHash(other.slice()));
+
+  b.clear();
+  b.openArray();
+  b.add(Value(1));
+  b.add(Value(2));
+  b.add(Value(3));
+  b.add(Value(4));
+  b.close();
+  ASSERT_EQ(b.slice().normalizedHash(), b.normalizedHash(b.slice()));
+}
+
+TEST(BuilderTest, NormalizedHashCacheTopLevelValues) {
+  Options options;
+  options.normalizedHashCacheThreshold = 1;
+
+  Builder b(&options);
+  b.openObject();
+  b.add("a", Value(1));
+  b.close();
+  ValueLength const size = b.size();
+  b.openArray();
+  b.add(Value(2));
+  b.close();
+
+  Slice first(b.start());
+  Slice second(b.start() + size);
+  ASSERT_EQ(first.normalizedHash(), b.normalizedHash(first));
+  ASSERT_EQ(second.normalizedHash(), b.normalizedHash(second));
+}
+
 TEST(BuilderTest, syntacticSugar) {
   Builder b;
 
@@ -0,0 +1,215 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Library to build up VPack documents.
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ostream>
+#include <string>
+
+#include "tests-common.h"
+
+// builds JSON Lines input of at least the given size
+static std::string buildLines(std::size_t size) {
+  std::string lines;
+  std::size_t i = 0;
+  while (lines.size() < size) {
+    lines.append("{\"_key\":\"test" + std::to_string(i) + "\",\"value\":" +
+                 std::to_string(i) + ",\"list\":[1,2,3],\"nested\":{\"a\":" +
+                 (i % 2 == 0 ? "true" : "null") + "}}\n");
+    if (i % 1000 == 0) {
+      // some empty lines and other whitespace in between
+      lines.append("\n  \r\n");
+    }
+    ++i;
+  }
+  return lines;
+}
+
+// compares the result of the bulk parser with the regular parser
+static void checkBulk(BulkParser const& parser, std::string const& lines) {
+  Parser regular;
+  ValueLength n = regular.parse(lines, true);
+  ASSERT_EQ(n, parser.size());
+
+  uint8_t const* p = regular.builder().data();
+  for (ValueLength i = 0; i < n; ++i) {
+    Slice expected(p);
+    Slice actual(parser.at(i));
+    ASSERT_EQ(expected.byteSize(), actual.byteSize());
+    ASSERT_EQ(0, memcmp(expected.start(), actual.start(), expected.byteSize()));
+    p += expected.byteSize();
+  }
+}
+
+TEST(BulkParserTest, CreateWithoutOptions) {
+  ASSERT_VELOCYPACK_EXCEPTION(new BulkParser(nullptr), Exception::InternalError);
+}
+
+TEST(BulkParserTest, Empty) {
+  BulkParser parser;
+  ASSERT_EQ(0U, parser.parse(std::string_view()));
+  ASSERT_EQ(0U, parser.size());
+  ASSERT_EQ(0U, parser.parse(std::string_view("\n\n  \n")));
+  ASSERT_EQ(0U, parser.size());
+  ASSERT_VELOCYPACK_EXCEPTION(parser.at(0), Exception::IndexOutOfBounds);
+}
+
+TEST(BulkParserTest, Small) {
+  std::string const lines("{\"a\":1}\n[1,2]\n\n\"foo\"\n17\r\nnull");
+  BulkParser parser;
+  ASSERT_EQ(5U, parser.parse(lines));
+  ASSERT_EQ(1U, parser.shards());
+  checkBulk(parser, lines);
+
+  ASSERT_EQ(1U, parser[0].get("a").getUInt());
+  ASSERT_EQ(2U, parser[1].length());
+  ASSERT_EQ("foo", parser[2].copyString());
+  ASSERT_EQ(17U, parser[3].getUInt());
+  ASSERT_TRUE(parser[4].isNull());
+}
+
+TEST(BulkParserTest, Sharded) {
+  std::string const lines = buildLines(4 * BulkParser::minShardSize + 1000);
+
+  for (std::size_t concurrency : {1, 2, 3, 4, 7}) {
+    BulkParser parser(&Options::Defaults, concurrency);
+    parser.parse(lines);
+    ASSERT_EQ((std::min)(concurrency, std::size_t(4)), parser.shards());
+    checkBulk(parser, lines);
+  }
+}
+
+TEST(BulkParserTest, LongLines) {
+  // lines longer than a shard, so that some shards remain empty
+  std::string lines;
+  for (std::size_t i = 0; i < 3; ++i) {
+    lines.append("[\"" + std::string(BulkParser::minShardSize, 'x') + "\"]\n");
+  }
+  lines.append("1\n2\n");
+
+  BulkParser parser(&Options::Defaults, 8);
+  ASSERT_EQ(5U, parser.parse(lines));
+  checkBulk(parser, lines);
+}
+
+TEST(BulkParserTest, Reuse) {
+  BulkParser parser(&Options::Defaults, 4);
+  std::string const large = buildLines(4 * BulkParser::minShardSize);
+  parser.parse(large);
+  checkBulk(parser, large);
+
+  std::string const small("1\n2\n3\n");
+  ASSERT_EQ(3U, parser.parse(small));
+  ASSERT_EQ(1U, parser.shards());
+  checkBulk(parser, small);
+}
+
+TEST(BulkParserTest, Concatenate) {
+  std::string const lines = buildLines(3 * BulkParser::minShardSize);
+  BulkParser parser(&Options::Defaults, 3);
+  ValueLength n = parser.parse(lines);
+
+  Buffer<uint8_t> buffer;
+  std::vector<ValueLength> offsets;
+  ValueLength total = parser.concatenate(buffer, offsets);
+  ASSERT_EQ(total, buffer.size());
+  ASSERT_EQ(n, offsets.size());
+
+  Parser regular;
+  regular.parse(lines, true);
+  ASSERT_EQ(regular.builder().size(), buffer.size());
+  ASSERT_EQ(0, memcmp(regular.builder().data(), buffer.data(), buffer.size()));
+
+  for (ValueLength i = 0; i < n; ++i) {
+    Slice s(buffer.data() + offsets[i]);
+    ASSERT_EQ(parser[i].byteSize(), s.byteSize());
+    ASSERT_EQ(0, memcmp(parser[i].start(), s.start(), s.byteSize()));
+  }
+}
+
+TEST(BulkParserTest, Errors) {
+  std::string lines = buildLines(4 * BulkParser::minShardSize);
+  // put errors into the second and the last shard
+  std::size_t first = lines.find("\n{", lines.size() / 3) + 1;
+  std::size_t second = lines.find("\n{", lines.size() - 200) + 1;
+  lines[second] = '?';
+  lines[first] = '!';
+
+  Parser regular;
+  ASSERT_VELOCYPACK_EXCEPTION(regular.parse(lines, true), Exception::ParseError);
+
+  BulkParser parser(&Options::Defaults, 4);
+  ASSERT_VELOCYPACK_EXCEPTION(parser.parse(lines), Exception::ParseError);
+  ASSERT_EQ(regular.errorPos(), parser.errorPos());
+  ASSERT_EQ(first, parser.errorPos());
+  ASSERT_EQ(0U, parser.size());
+}
+
+TEST(BulkParserTest, MultiLineDocument) {
+  // a pretty-printed document must be rejected at the same position,
+  // no matter where the shard boundaries are
+  std::string const pretty("{\n  \"a\": [\n    1,\n    2\n  ]\n}\n");
+  std::string lines = buildLines(4 * BulkParser::minShardSize);
+  for (std::size_t pos : {std::size_t(0), lines.size() / 4, lines.size() / 2,
+                          lines.size() - 200}) {
+    std::string input(lines);
+    std::size_t const at = (pos == 0) ? 0 : input.find('\n', pos) + 1;
+    input.insert(at, pretty);
+
+    BulkParser single(&Options::Defaults, 1);
+    ASSERT_VELOCYPACK_EXCEPTION(single.parse(input), Exception::ParseError);
+    ASSERT_EQ(0U, single.size());
+
+    for (std::size_t concurrency : {2, 4, 7}) {
+      BulkParser parser(&Options::Defaults, concurrency);
+      ASSERT_VELOCYPACK_EXCEPTION(parser.parse(input), Exception::ParseError);
+      ASSERT_EQ(single.errorPos(), parser.errorPos());
+      ASSERT_EQ(0U, parser.size());
+    }
+  }
+
+  // the error is the incomplete first line
+  Parser regular;
+  ASSERT_VELOCYPACK_EXCEPTION(regular.parse(std::string("{")),
+                              Exception::ParseError);
+  BulkParser parser;
+  ASSERT_VELOCYPACK_EXCEPTION(parser.parse(pretty), Exception::ParseError);
+  ASSERT_EQ(regular.errorPos(), parser.errorPos());
+}
+
+TEST(BulkParserTest, Options) {
+  Options options;
+  options.validateUtf8Strings = true;
+
+  BulkParser parser(&options);
+  ASSERT_VELOCYPACK_EXCEPTION(parser.parse(std::string_view("\"a\"\n\"\x80\"\n")),
+                              Exception::InvalidUtf8Sequence);
+  ASSERT_EQ(5U, parser.errorPos());
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
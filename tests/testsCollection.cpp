@@ -24,6 +24,10 @@
 /// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <random>
 #include <set>
 #include <string>
 #include <unordered_set>
@@ -2114,6 +2118,312 @@ TEST(CollectionTest, SortNonArray) {
   ASSERT_VELOCYPACK_EXCEPTION(Collection::sort(b.slice(), &lt), Exception::InvalidValueType);
 }
 
+static void checkSorted(Slice original, Slice sorted) {
+  ASSERT_TRUE(sorted.isArray());
+  ASSERT_EQ(original.length(), sorted.length());
+  for (ValueLength i = 1; i < sorted.length(); ++i) {
+    ASSERT_LE(NormalizedCompare::compare(sorted.at(i - 1), sorted.at(i)), 0);
+  }
+  // same members as before
+  std::vector<std::string> expected;
+  for (auto it : ArrayIterator(original)) {
+    expected.emplace_back(it.startAs<char>(), it.byteSize());
+  }
+  std::vector<std::string> actual;
+  for (auto it : ArrayIterator(sorted)) {
+    actual.emplace_back(it.startAs<char>(), it.byteSize());
+  }
+  std::sort(expected.begin(), expected.end());
+  std::sort(actual.begin(), actual.end());
+  ASSERT_EQ(expected, actual);
+}
+
+TEST(CollectionTest, SortIntegers) {
+  std::mt19937_64 random(42);
+  Builder b;
+  b.openArray();
+  for (int i = 0; i < 5000; ++i) {
+    switch (i % 4) {
+      case 0:
+        b.add(Value(int64_t(random() % 20) - 10));
+        break;
+      case 1:
+        b.add(Value(int64_t(random())));
+        break;
+      case 2:
+        b.add(Value(uint64_t(random() >> 1)));
+        break;
+      default:
+        b.add(Value(int64_t(random() % 100000) - 50000));
+    }
+  }
+  b.add(Value(std::numeric_limits<int64_t>::min()));
+  b.add(Value(std::numeric_limits<int64_t>::max()));
+  b.close();
+
+  Builder sorted = Collection::sort(b.slice());
+  checkSorted(b.slice(), sorted.slice());
+  ASSERT_EQ(std::numeric_limits<int64_t>::min(), sorted.slice().at(0).getInt());
+}
+
+TEST(CollectionTest, SortBigUnsignedIntegers) {
+  Builder b;
+  b.openArray();
+  b.add(Value(std::numeric_limits<uint64_t>::max()));
+  b.add(Value(-1));
+  b.add(Value(uint64_t(1) << 63));
+  b.add(Value(0));
+  b.close();
+
+  Builder sorted = Collection::sort(b.slice());
+  checkSorted(b.slice(), sorted.slice());
+  ASSERT_EQ(-1, sorted.slice().at(0).getInt());
+  ASSERT_EQ(std::numeric_limits<uint64_t>::max(), sorted.slice().at(3).getUInt());
+}
+
+TEST(CollectionTest, SortDoubles) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<double> dist(-1e10, 1e10);
+  Builder b;
+  b.openArray();
+  for (int i = 0; i < 5000; ++i) {
+    b.add(Value(dist(random)));
+  }
+  b.add(Value(0.0));
+  b.add(Value(-0.0));
+  b.add(Value(std::numeric_limits<double>::infinity()));
+  b.add(Value(-std::numeric_limits<double>::infinity()));
+  b.add(Value(std::numeric_limits<double>::quiet_NaN()));
+  b.add(Value(std::numeric_limits<double>::denorm_min()));
+  b.close();
+
+  Builder sorted = Collection::sort(b.slice());
+  checkSorted(b.slice(), sorted.slice());
+  ASSERT_TRUE(std::isnan(sorted.slice().at(0).getDouble()));
+  ASSERT_EQ(-std::numeric_limits<double>::infinity(), sorted.slice().at(1).getDouble());
+}
+
+TEST(CollectionTest, SortStrings) {
+  std::mt19937_64 random(42);
+  Builder b;
+  b.openArray();
+  for (int i = 0; i < 5000; ++i) {
+    // long common prefixes, to sort strings with the same radix key
+    std::string value(random() % 12, 'x');
+    for (int j = random() % 4; j > 0; --j) {
+      value.push_back(static_cast<char>(random() % 3));
+    }
+    b.add(Value(value));
+  }
+  b.add(Value(std::string(200, 'x')));
+  b.add(Value(std::string("\xff\xfe")));
+  b.add(Value(""));
+  b.close();
+
+  Builder sorted = Collection::sort(b.slice());
+  checkSorted(b.slice(), sorted.slice());
+  ASSERT_EQ("", sorted.slice().at(0).copyString());
+}
+
+TEST(CollectionTest, SortMixedTypes) {
+  Builder b;
+  b.openArray();
+  b.add(Value("foo"));
+  b.add(Value(2.5));
+  b.add(Value(ValueType::Null));
+  b.add(Value(2));
+  b.openArray();
+  b.add(Value(1));
+  b.close();
+  b.add(Value(true));
+  b.add(Value(-3));
+  b.close();
+
+  Builder sorted = Collection::sort(b.slice());
+  checkSorted(b.slice(), sorted.slice());
+  ASSERT_TRUE(sorted.slice().at(0).isNull());
+  ASSERT_EQ(2, sorted.slice().at(3).getInt());
+  ASSERT_EQ(2.5, sorted.slice().at(4).getDouble());
+
+  Builder empty;
+  empty.openArray();
+  empty.close();
+  ASSERT_EQ(0U, Collection::sort(empty.slice()).slice().length());
+
+  ASSERT_VELOCYPACK_EXCEPTION(Collection::sort(Slice::nullSlice()), Exception::InvalidValueType);
+}
+
+TEST(CollectionTest, SortParallel) {
+  std::mt19937_64 random(42);
+  Builder b;
+  b.openArray();
+  for (int i = 0; i < 100000; ++i) {
+    b.add(Value(int64_t(random() % 1000000)));
+  }
+  b.close();
+
+  for (std::size_t concurrency : {0, 1, 2, 3, 7}) {
+    Builder sorted = Collection::sort(b.slice(), &lt, concurrency);
+    checkSorted(b.slice(), sorted.slice());
+  }
+
+  // mixed types are sorted by comparison
+  b.clear();
+  b.openArray();
+  for (int i = 0; i < 100000; ++i) {
+    if (i % 2 == 0) {
+      b.add(Value(int64_t(random() % 1000000)));
+    } else {
+      b.add(Value(double(random() % 1000000) / 3.0));
+    }
+  }
+  b.close();
+  checkSorted(b.slice(), Collection::sort(b.slice(), 4).slice());
+}
+
+TEST(CollectionTest, SortParallelThrows) {
+  Builder b;
+  b.openArray();
+  for (int i = 0; i < 100000; ++i) {
+    b.add(Value(i % 1000));
+  }
+  b.close();
+
+  std::atomic<int> calls(0);
+  auto lessthan = [&calls](Slice const& a, Slice const& b) {
+    if (++calls == 250000) {
+      throw Exception(Exception::InternalError);
+    }
+    return a.getInt() < b.getInt();
+  };
+  ASSERT_VELOCYPACK_EXCEPTION(Collection::sort(b.slice(), lessthan, 4), Exception::InternalError);
+}
+
+static Builder parseArray(std::string const& json) {
+  Parser parser;
+  parser.parse(json);
+  return *parser.steal();
+}
+
+TEST(CollectionTest, Unique) {
+  Builder b = parseArray("[3,1,\"a\",3,1.0,[1],\"a\",[1.0],{\"x\":1},{\"x\":1},null,null]");
+
+  Builder normalized = Collection::unique(b.slice());
+  ASSERT_EQ("[3,1,\"a\",[1],{\"x\":1},null]", normalized.slice().toJson());
+
+  Builder binary = Collection::unique(b.slice(), Collection::BinaryHashing);
+  ASSERT_EQ("[3,1,\"a\",1,[1],[1],{\"x\":1},null]", binary.slice().toJson());
+
+  Builder sorted = Collection::unique(Collection::sort(b.slice()).slice(),
+                                      Collection::SortedMerge);
+  ASSERT_EQ("[null,1,3,\"a\",[1],{\"x\":1}]", sorted.slice().toJson());
+
+  ASSERT_EQ("[]", Collection::unique(parseArray("[]").slice()).slice().toJson());
+  ASSERT_VELOCYPACK_EXCEPTION(Collection::unique(Slice::nullSlice()), Exception::InvalidValueType);
+}
+
+TEST(CollectionTest, SetOperations) {
+  Builder left = parseArray("[5,1,2,2,\"x\",3]");
+  Builder right = parseArray("[2.0,3,3,7,\"y\",\"x\"]");
+  Slice l = left.slice();
+  Slice r = right.slice();
+
+  ASSERT_EQ("[2,\"x\",3]", Collection::intersect(l, r).slice().toJson());
+  ASSERT_EQ("[5,1,2,\"x\",3,7,\"y\"]", Collection::unionOf(l, r).slice().toJson());
+  ASSERT_EQ("[5,1]", Collection::difference(l, r).slice().toJson());
+
+  // 2 and 2.0 are different bytes
+  ASSERT_EQ("[\"x\",3]", Collection::intersect(l, r, Collection::BinaryHashing).slice().toJson());
+  ASSERT_EQ("[5,1,2,\"x\",3,2,7,\"y\"]",
+            Collection::unionOf(l, r, Collection::BinaryHashing).slice().toJson());
+  ASSERT_EQ("[5,1,2]", Collection::difference(l, r, Collection::BinaryHashing).slice().toJson());
+
+  Builder sortedLeft = Collection::sort(l);
+  Builder sortedRight = Collection::sort(r);
+  l = sortedLeft.slice();
+  r = sortedRight.slice();
+  ASSERT_EQ("[2,3,\"x\"]", Collection::intersect(l, r, Collection::SortedMerge).slice().toJson());
+  ASSERT_EQ("[1,2,3,5,7,\"x\",\"y\"]",
+            Collection::unionOf(l, r, Collection::SortedMerge).slice().toJson());
+  ASSERT_EQ("[1,5]", Collection::difference(l, r, Collection::SortedMerge).slice().toJson());
+}
+
+TEST(CollectionTest, SetOperationsNegativeZero) {
+  // 0.0 and -0.0 are equal for NormalizedCompare, and must be for the
+  // normalized hash as well, also when nested
+  Builder left;
+  left.openArray();
+  left.add(Value(0.0));
+  left.add(Value(-0.0));
+  left.openArray();
+  left.add(Value(-0.0));
+  left.close();
+  left.close();
+  Builder right;
+  right.openArray();
+  right.add(Value(-0.0));
+  right.openArray();
+  right.add(Value(0.0));
+  right.close();
+  right.close();
+  Slice l = left.slice();
+  Slice r = right.slice();
+
+  ASSERT_EQ(2U, Collection::unique(l).slice().length());
+  ASSERT_EQ(2U, Collection::intersect(l, r).slice().length());
+  ASSERT_EQ(2U, Collection::unionOf(l, r).slice().length());
+  ASSERT_EQ(0U, Collection::difference(l, r).slice().length());
+
+  Builder sortedLeft = Collection::sort(l);
+  Builder sortedRight = Collection::sort(r);
+  Slice sl = sortedLeft.slice();
+  Slice sr = sortedRight.slice();
+  ASSERT_EQ(2U, Collection::unique(sl, Collection::SortedMerge).slice().length());
+  ASSERT_EQ(2U, Collection::intersect(sl, sr, Collection::SortedMerge).slice().length());
+  ASSERT_EQ(2U, Collection::unionOf(sl, sr, Collection::SortedMerge).slice().length());
+  ASSERT_EQ(0U, Collection::difference(sl, sr, Collection::SortedMerge).slice().length());
+
+  // 0.0 and -0.0 are different bytes
+  ASSERT_EQ(3U, Collection::unique(l, Collection::BinaryHashing).slice().length());
+  ASSERT_EQ(1U, Collection::intersect(l, r, Collection::BinaryHashing).slice().length());
+
+  ASSERT_EQ(Slice(l.at(0)).normalizedHash(), Slice(l.at(1)).normalizedHash());
+  ASSERT_EQ(Slice(l.at(0)).normalizedHash32(), Slice(l.at(1)).normalizedHash32());
+}
+
+TEST(CollectionTest, SetOperationsLarge) {
+  Builder left;
+  left.openArray();
+  for (int i = 0; i < 20000; ++i) {
+    left.add(Value(i % 5000));
+  }
+  left.close();
+  Builder right;
+  right.openArray();
+  for (int i = 0; i < 20000; ++i) {
+    right.add(Value(double(i % 7000) + 2500.0));
+  }
+  right.close();
+
+  for (auto mode : {Collection::BinaryHashing, Collection::NormalizedHashing}) {
+    ASSERT_EQ(5000U, Collection::unique(left.slice(), mode).slice().length());
+  }
+  ASSERT_EQ(2500U, Collection::intersect(left.slice(), right.slice()).slice().length());
+  ASSERT_EQ(9500U, Collection::unionOf(left.slice(), right.slice()).slice().length());
+  ASSERT_EQ(2500U, Collection::difference(left.slice(), right.slice()).slice().length());
+  ASSERT_EQ(0U, Collection::intersect(left.slice(), right.slice(),
+                                      Collection::BinaryHashing).slice().length());
+
+  Builder sortedLeft = Collection::sort(left.slice());
+  Builder sortedRight = Collection::sort(right.slice());
+  Slice l = sortedLeft.slice();
+  Slice r = sortedRight.slice();
+  ASSERT_EQ(5000U, Collection::unique(l, Collection::SortedMerge).slice().length());
+  ASSERT_EQ(2500U, Collection::intersect(l, r, Collection::SortedMerge).slice().length());
+  ASSERT_EQ(9500U, Collection::unionOf(l, r, Collection::SortedMerge).slice().length());
+  ASSERT_EQ(2500U, Collection::difference(l, r, Collection::SortedMerge).slice().length());
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -24,7 +24,11 @@
 /// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cmath>
+#include <functional>
+#include <limits>
 #include <ostream>
+#include <random>
 #include <string>
 
 #include "tests-common.h"
@@ -402,6 +406,127 @@ TEST(NormalizedCompareTest, Objects) {
   ASSERT_FALSE(NormalizedCompare::equals(Parser::fromJson("{\"one\":{\"one-one\":1,\"one-two\":2,\"one-three\":3},\"two\":{\"two-one\":21,\"two-two\":22,\"two-three\":23},\"three\":\"three\"}")->slice(), Parser::fromJson("{\"one\":{\"one-one\":1,\"one-two\":2,\"one-three\":3},\"two\":{\"two-one\":21,\"two-two\":22,\"two-three\":23},\"three\":\"three\",\"four\":\"four\"}")->slice()));
 }
 
+TEST(NormalizedCompareTest, ObjectLayouts) {
+  auto build = [](std::size_t n, int layout, std::size_t modified) {
+    Options options;
+    options.buildUnindexedObjects = (layout == 1);
+    options.buildHashIndexedObjectsThreshold = (layout == 2) ? 1 : 0;
+    Builder b(&options);
+    b.openObject();
+    for (std::size_t i = 0; i < n; ++i) {
+      // insert in different orders
+      std::size_t j = (layout % 2 == 0) ? i : n - 1 - i;
+      b.add("key" + std::to_string(j), Value(j == modified ? 1000 : j));
+    }
+    b.close();
+    return b;
+  };
+
+  for (std::size_t n : {1, 5, 16, 17, 100, 300}) {
+    for (int l = 0; l < 3; ++l) {
+      Builder lhs = build(n, l, n);
+      for (int r = 0; r < 3; ++r) {
+        ASSERT_TRUE(NormalizedCompare::equals(lhs.slice(), build(n, r, n).slice()));
+        ASSERT_FALSE(NormalizedCompare::equals(lhs.slice(), build(n, r, n / 2).slice()));
+        ASSERT_FALSE(NormalizedCompare::equals(lhs.slice(), build(n + 1, r, n + 1).slice()));
+      }
+    }
+  }
+
+  // same number of attributes, but different names
+  for (bool compact : {false, true}) {
+    Options options;
+    options.buildUnindexedObjects = compact;
+    Builder lhs(&options);
+    Builder rhs(&options);
+    lhs.openObject();
+    rhs.openObject();
+    for (std::size_t i = 0; i < 20; ++i) {
+      lhs.add("key" + std::to_string(i), Value(i));
+      rhs.add((i == 7 ? "other" : "key") + std::to_string(i), Value(i));
+    }
+    lhs.close();
+    rhs.close();
+    ASSERT_FALSE(NormalizedCompare::equals(lhs.slice(), rhs.slice()));
+    ASSERT_FALSE(NormalizedCompare::equals(rhs.slice(), lhs.slice()));
+  }
+}
+
+TEST(NormalizedCompareTest, ObjectsSortedLhsUnsortedRhs) {
+  // more than 16 members, so that the unsorted side is looked up in the
+  // sorted one no matter which side is which
+  auto build = [](bool compact, std::size_t renamed, std::size_t modified) {
+    Options options;
+    options.buildUnindexedObjects = compact;
+    Builder b(&options);
+    b.openObject();
+    for (std::size_t i = 0; i < 20; ++i) {
+      std::size_t j = 19 - i;
+      b.add((j == renamed ? "other" : "key") + std::to_string(j),
+            Value(j == modified ? 1000 : j));
+    }
+    b.close();
+    return b;
+  };
+
+  Builder sorted = build(false, 20, 20);
+  ASSERT_TRUE(sorted.slice().isSorted());
+  Builder unsorted = build(true, 20, 20);
+  ASSERT_FALSE(unsorted.slice().isSorted());
+
+  ASSERT_TRUE(NormalizedCompare::equals(sorted.slice(), unsorted.slice()));
+  ASSERT_TRUE(NormalizedCompare::equals(unsorted.slice(), sorted.slice()));
+  Builder renamed = build(true, 7, 20);
+  ASSERT_FALSE(NormalizedCompare::equals(sorted.slice(), renamed.slice()));
+  ASSERT_FALSE(NormalizedCompare::equals(renamed.slice(), sorted.slice()));
+  Builder modified = build(true, 20, 7);
+  ASSERT_FALSE(NormalizedCompare::equals(sorted.slice(), modified.slice()));
+  ASSERT_FALSE(NormalizedCompare::equals(modified.slice(), sorted.slice()));
+}
+
+TEST(NormalizedCompareTest, ObjectsTranslatedKeys) {
+  std::unique_ptr<AttributeTranslator> translator(new AttributeTranslator);
+  translator->add("foo", 1);
+  translator->add("bar", 2);
+  translator->seal();
+
+  AttributeTranslatorScope scope(translator.get());
+
+  Options options;
+  options.attributeTranslator = translator.get();
+
+  for (bool compact : {false, true}) {
+    options.buildUnindexedObjects = compact;
+    Builder translated(&options);
+    translated.openObject();
+    translated.add("foo", Value(1));
+    translated.add("baz", Value(2));
+    translated.add("bar", Value(3));
+    translated.close();
+
+    Builder plain;
+    plain.openObject();
+    plain.add("bar", Value(3));
+    plain.add("baz", Value(2));
+    plain.add("foo", Value(1));
+    plain.close();
+
+    ASSERT_TRUE(NormalizedCompare::equals(translated.slice(), plain.slice()));
+    ASSERT_TRUE(NormalizedCompare::equals(plain.slice(), translated.slice()));
+    ASSERT_TRUE(NormalizedCompare::equals(translated.slice(), translated.slice()));
+
+    plain.clear();
+    plain.openObject();
+    plain.add("bar", Value(3));
+    plain.add("baz", Value(2));
+    plain.add("qux", Value(1));
+    plain.close();
+
+    ASSERT_FALSE(NormalizedCompare::equals(translated.slice(), plain.slice()));
+    ASSERT_FALSE(NormalizedCompare::equals(plain.slice(), translated.slice()));
+  }
+}
+
 TEST(NormalizedCompareTest, Custom) {
   Builder b;
   uint8_t* p = b.add(ValuePair(2ULL, ValueType::Custom));
@@ -411,6 +536,238 @@ TEST(NormalizedCompareTest, Custom) {
   ASSERT_VELOCYPACK_EXCEPTION(NormalizedCompare::equals(b.slice(), b.slice()), Exception::NotImplemented);
 }
 
+static int sign(int value) {
+  return (value > 0) - (value < 0);
+}
+
+static int compareSortKeys(Slice lhs, Slice rhs) {
+  std::string l = NormalizedCompare::sortKey(lhs);
+  std::string r = NormalizedCompare::sortKey(rhs);
+  return sign(l.compare(r));
+}
+
+// groups of values in ascending order. values in the same group are equal
+static void checkOrder(std::vector<std::vector<Builder>> const& groups) {
+  for (std::size_t i = 0; i < groups.size(); ++i) {
+    for (std::size_t j = 0; j < groups.size(); ++j) {
+      for (auto const& lhs : groups[i]) {
+        for (auto const& rhs : groups[j]) {
+          int expected = (i < j) ? -1 : (i > j ? 1 : 0);
+          ASSERT_EQ(expected, sign(NormalizedCompare::compare(lhs.slice(), rhs.slice())))
+              << lhs.slice().toJson() << " vs " << rhs.slice().toJson();
+          ASSERT_EQ(expected, compareSortKeys(lhs.slice(), rhs.slice()))
+              << lhs.slice().toJson() << " vs " << rhs.slice().toJson();
+        }
+      }
+    }
+  }
+}
+
+template<typename... T>
+static std::vector<Builder> values(T const&... value) {
+  std::vector<Builder> result;
+  auto add = [&result](auto const& v) {
+    result.emplace_back();
+    result.back().add(v);
+  };
+  (add(value), ...);
+  return result;
+}
+
+TEST(NormalizedCompareTest, CompareTypes) {
+  uint8_t binary[] = {0x00, 0x01};
+  checkOrder({
+    values(Value(ValueType::MinKey)),
+    values(Value(ValueType::Illegal)),
+    values(Value(ValueType::Null)),
+    values(Value(false)),
+    values(Value(true)),
+    values(Value(-1), Value(-1.0)),
+    values(Value(0), Value(0.0), Value(-0.0), Value(0U)),
+    values(Value(1), Value(1.0), Value(1U)),
+    values(Value(-5, ValueType::UTCDate)),
+    values(Value(5, ValueType::UTCDate)),
+    values(Value("")),
+    values(Value(std::string("\0", 1))),
+    values(Value(std::string("\0\0", 2))),
+    values(Value(std::string("\0a", 2))),
+    values(Value("a")),
+    values(Value("ab")),
+    values(Value("b")),
+    values(ValuePair(binary, 1, ValueType::Binary)),
+    values(ValuePair(binary, 2, ValueType::Binary)),
+    values(Value(ValueType::MaxKey)),
+  });
+
+  // None cannot be added to a Builder
+  ASSERT_LT(NormalizedCompare::compare(Slice::minKeySlice(), Slice()), 0);
+  ASSERT_EQ(0, NormalizedCompare::compare(Slice(), Slice()));
+  ASSERT_GT(NormalizedCompare::compare(Slice::illegalSlice(), Slice()), 0);
+  ASSERT_LT(NormalizedCompare::sortKey(Slice::minKeySlice()), NormalizedCompare::sortKey(Slice()));
+  ASSERT_GT(NormalizedCompare::sortKey(Slice::illegalSlice()), NormalizedCompare::sortKey(Slice()));
+}
+
+TEST(NormalizedCompareTest, CompareNumbers) {
+  double const nan = std::nan("");
+  double const inf = std::numeric_limits<double>::infinity();
+  checkOrder({
+    values(Value(nan)),
+    values(Value(-inf)),
+    values(Value(-1e300)),
+    values(Value(std::numeric_limits<int64_t>::min()), Value(-9223372036854775808.0)),
+    values(Value(int64_t(-9007199254740993))),
+    values(Value(int64_t(-9007199254740992)), Value(-9007199254740992.0)),
+    values(Value(-1000)),
+    values(Value(-1.5)),
+    values(Value(-1), Value(-1.0)),
+    values(Value(-5e-324)),
+    values(Value(0), Value(-0.0)),
+    values(Value(5e-324)),
+    values(Value(0.5)),
+    values(Value(1), Value(1.0), Value(1U)),
+    values(Value(1.0000000000000002)),
+    values(Value(9), Value(9U), Value(9.0)),
+    values(Value(255U), Value(255)),
+    values(Value(uint64_t(9007199254740992ULL)), Value(9007199254740992.0)),
+    values(Value(uint64_t(9007199254740993ULL)), Value(int64_t(9007199254740993))),
+    values(Value(std::numeric_limits<int64_t>::max())),
+    values(Value(uint64_t(9223372036854775808ULL)), Value(9223372036854775808.0)),
+    values(Value(std::numeric_limits<uint64_t>::max())),
+    values(Value(1e300)),
+    values(Value(inf)),
+  });
+}
+
+TEST(NormalizedCompareTest, CompareCompounds) {
+  auto json = [](std::vector<std::string> const& group) {
+    std::vector<Builder> result;
+    for (auto const& value : group) {
+      for (int layout = 0; layout < 3; ++layout) {
+        Options options;
+        options.buildUnindexedArrays = (layout == 1);
+        options.buildUnindexedObjects = (layout == 1);
+        options.buildHashIndexedObjectsThreshold = (layout == 2) ? 1 : 0;
+        Parser parser(&options);
+        parser.parse(value);
+        result.push_back(*parser.steal());
+      }
+    }
+    return result;
+  };
+
+  checkOrder({
+    json({"[]"}),
+    json({"[null]"}),
+    json({"[1]", "[1.0]"}),
+    json({"[1,2]"}),
+    json({"[1,[]]"}),
+    json({"[1,[0]]"}),
+    json({"[2]"}),
+    json({"[\"a\"]"}),
+    json({"{}"}),
+    json({"{\"\":null}"}),
+    json({"{\"a\":1}"}),
+    json({"{\"a\":1,\"b\":0}", "{\"b\":0,\"a\":1.0}"}),
+    json({"{\"a\":1,\"b\":1}"}),
+    json({"{\"a\":2}"}),
+    json({"{\"aa\":0}"}),
+    json({"{\"b\":{\"x\":1,\"y\":[1,2]}}", "{\"b\":{\"y\":[1,2],\"x\":1}}"}),
+    json({"{\"b\":{\"x\":1,\"y\":[1,3]}}"}),
+  });
+}
+
+TEST(NormalizedCompareTest, CompareTagged) {
+  Builder tagged;
+  tagged.addTagged(42, Value(5));
+  Builder plain;
+  plain.add(Value(5));
+  ASSERT_EQ(0, NormalizedCompare::compare(tagged.slice(), plain.slice()));
+  ASSERT_EQ(NormalizedCompare::sortKey(tagged.slice()), NormalizedCompare::sortKey(plain.slice()));
+}
+
+TEST(NormalizedCompareTest, CompareCustom) {
+  Builder b;
+  uint8_t* p = b.add(ValuePair(2ULL, ValueType::Custom));
+  *p++ = 0xf0;
+  *p++ = 0xaa;
+
+  ASSERT_VELOCYPACK_EXCEPTION(NormalizedCompare::compare(b.slice(), b.slice()), Exception::NotImplemented);
+  ASSERT_VELOCYPACK_EXCEPTION(NormalizedCompare::sortKey(b.slice()), Exception::NotImplemented);
+}
+
+TEST(NormalizedCompareTest, CompareRandom) {
+  std::mt19937 rng(42);
+  std::function<void(Builder&, int)> build = [&](Builder& b, int depth) {
+    switch (rng() % (depth < 3 ? 7 : 5)) {
+      case 0:
+        b.add(Value(static_cast<int64_t>(rng() % 5) - 2));
+        break;
+      case 1:
+        b.add(Value(static_cast<double>(static_cast<int>(rng() % 9) - 4) / 2));
+        break;
+      case 2:
+        b.add(Value(std::string(rng() % 3, static_cast<char>('a' + rng() % 2))));
+        break;
+      case 3:
+        b.add(Value(rng() % 2 == 0));
+        break;
+      case 4:
+        b.add(Value(ValueType::Null));
+        break;
+      case 5: {
+        b.openArray(rng() % 2 == 0);
+        for (std::size_t i = rng() % 3; i > 0; --i) {
+          build(b, depth + 1);
+        }
+        b.close();
+        break;
+      }
+      default: {
+        b.openObject(rng() % 2 == 0);
+        std::size_t n = rng() % 3;
+        for (std::size_t i = 0; i < n; ++i) {
+          b.add(Value(std::string(1, static_cast<char>('a' + (i + rng() % 2) % 3))));
+          build(b, depth + 1);
+        }
+        b.close();
+        break;
+      }
+    }
+  };
+
+  Options options;
+  options.checkAttributeUniqueness = true;
+  std::vector<Builder> all;
+  while (all.size() < 300) {
+    Builder b(&options);
+    try {
+      build(b, 0);
+    } catch (Exception const&) {
+      // duplicate attribute name
+      continue;
+    }
+    all.push_back(std::move(b));
+  }
+
+  std::vector<Slice> sorted;
+  for (auto const& b : all) {
+    sorted.push_back(b.slice());
+  }
+  std::sort(sorted.begin(), sorted.end(), NormalizedCompare::Less());
+
+  for (std::size_t i = 0; i < sorted.size(); ++i) {
+    for (std::size_t j = 0; j < sorted.size(); ++j) {
+      int res = sign(NormalizedCompare::compare(sorted[i], sorted[j]));
+      ASSERT_EQ(-res, sign(NormalizedCompare::compare(sorted[j], sorted[i])));
+      ASSERT_EQ(res, compareSortKeys(sorted[i], sorted[j]));
+      ASSERT_EQ(res == 0, NormalizedCompare::equals(sorted[i], sorted[j]));
+      if (i < j) {
+        ASSERT_LE(res, 0);
+      }
+    }
+  }
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -24,12 +24,28 @@
 /// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <ostream>
+#include <random>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "tests-common.h"
 
+namespace arangodb {
+namespace velocypack {
+
+extern void enableNativeStringFunctions();
+extern void enableBuiltinStringFunctions();
+
+}
+}
+
 static unsigned char LocalBuffer[4096];
 
 TEST(DumperTest, CreateWithoutOptions) {
@@ -330,6 +346,80 @@ TEST(StreamDumperTest, ComplexObject) {
             result.str());
 }
 
+TEST(TypedDumperTest, SameOutputForAllSinks) {
+  std::string value("{\"foo\":\"bar\",\"baz\":[1,2,3,[4]],\"bark\":[{"
+                    "\"troet\\nmann\":1,\"mÃ¶tÃ¶r\":[2,3.4,-42.5,true,"
+                    "false,null,\"some\\nstring\"]}],\"long\":[");
+  // enough output to fill the buffer of a BufferedSink several times
+  for (int i = 0; i < 5000; ++i) {
+    if (i > 0) {
+      value.push_back(',');
+    }
+    value.append("\"value \\\"" + std::to_string(i) + "\\\"\"");
+  }
+  value.append("]}");
+
+  std::shared_ptr<Builder> builder = Parser::fromJson(value);
+  Slice s(builder->slice());
+
+  for (bool pretty : {false, true}) {
+    Options options;
+    options.prettyPrint = pretty;
+
+    std::string const expected = Dumper::toString(s, &options);
+    ASSERT_GT(expected.size(), 16384);
+
+    std::string stringResult;
+    StringSink stringSink(&stringResult);
+    BasicDumper<StringSink>::dump(s, &stringSink, &options);
+    ASSERT_EQ(expected, stringResult);
+
+    CharBuffer bufferResult;
+    CharBufferSink bufferSink(&bufferResult);
+    BasicDumper<CharBufferSink>::dump(s, &bufferSink, &options);
+    ASSERT_EQ(expected, std::string(bufferResult.data(), bufferResult.size()));
+
+    std::ostringstream streamResult;
+    StringStreamSink streamSink(&streamResult);
+    BufferedSink bufferedSink(&streamSink);
+    BasicDumper<BufferedSink>::dump(s, &bufferedSink, &options);
+    bufferedSink.flush();
+    ASSERT_EQ(expected, streamResult.str());
+  }
+}
+
+TEST(TypedDumperTest, CustomWithBufferedSink) {
+  struct MyCustomTypeHandler : public CustomTypeHandler {
+    void dump(Slice const&, Dumper* dumper, Slice const&) override {
+      dumper->sink()->append("\"custom\"");
+    }
+  };
+
+  MyCustomTypeHandler handler;
+  Options options;
+  options.customTypeHandler = &handler;
+
+  Builder b(&options);
+  b.openArray();
+  b.add(Value("before"));
+  uint8_t* p = b.add(ValuePair(2ULL, ValueType::Custom));
+  *p++ = 0xf0;
+  *p = 1;
+  b.add(Value("after"));
+  b.close();
+
+  std::string result;
+  StringSink stringSink(&result);
+  {
+    BufferedSink sink(&stringSink);
+    BasicDumper<BufferedSink> dumper(&sink, &options);
+    dumper.dump(b.slice());
+    // nothing is passed on before the buffer is flushed
+    ASSERT_TRUE(result.empty());
+  }
+  ASSERT_EQ("[\"before\",\"custom\",\"after\"]", result);
+}
+
 TEST(BufferDumperTest, Null) {
   LocalBuffer[0] = 0x18;
 
@@ -692,6 +782,107 @@ TEST(StringDumperTest, NumberDoubleScientific4) {
   ASSERT_EQ(std::string("3.4239493e+104"), buffer);
 }
 
+TEST(StringDumperTest, NumberDoubleShortest) {
+  std::vector<std::pair<double, std::string>> const values = {
+      {0.3, "0.3"},
+      {2.0 / 3.0, "0.6666666666666666"},
+      {1e23, "1e+23"},
+      {5e-324, "5e-324"},
+      {1.7976931348623157e308, "1.7976931348623157e+308"},
+      {-0.0, "-0"},
+      {9007199254740992.0, "9007199254740992"},
+      {1e21, "1e+21"},
+      {123e-9, "1.23e-7"},
+      // Grisu2 produced "1120190537298671.3" for this one
+      {1120190537298671.2, "1120190537298671.2"},
+  };
+
+  for (auto const& it : values) {
+    Builder b;
+    b.add(Value(it.first));
+
+    std::string buffer;
+    StringSink sink(&buffer);
+    Dumper dumper(&sink);
+    dumper.dump(b.slice());
+    ASSERT_EQ(it.second, buffer);
+  }
+}
+
+TEST(StringDumperTest, NumberDoubleSignificantDigits) {
+  std::vector<std::tuple<double, uint32_t, std::string>> const values = {
+      {3.14159265358979, 3, "3.14"},
+      {3.14159265358979, 1, "3"},
+      {2.0 / 3.0, 5, "0.66667"},
+      {123456.789, 2, "120000"},
+      {-9.9999, 3, "-10"},
+      // ties are rounded to even
+      {0.125, 2, "0.12"},
+      {0.375, 2, "0.38"},
+      {2.5e-300, 1, "2e-300"},
+      {1.23456789e100, 4, "1.235e+100"},
+      // shorter than the limit, so dumped unchanged
+      {0.1, 5, "0.1"},
+      {2.0 / 3.0, 17, "0.6666666666666666"},
+      {2.0 / 3.0, 100, "0.6666666666666666"},
+  };
+
+  for (auto const& it : values) {
+    Options options;
+    options.doubleSignificantDigits = std::get<1>(it);
+
+    Builder b;
+    b.add(Value(std::get<0>(it)));
+
+    std::string buffer;
+    StringSink sink(&buffer);
+    Dumper dumper(&sink, &options);
+    dumper.dump(b.slice());
+    ASSERT_EQ(std::get<2>(it), buffer);
+  }
+}
+
+TEST(StringDumperTest, NumberDoubleRoundTrip) {
+  std::mt19937_64 random(42);
+
+  for (int i = 0; i < 100000; ++i) {
+    uint64_t bits = random();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (!std::isfinite(value)) {
+      continue;
+    }
+
+    Builder b;
+    b.add(Value(value));
+    std::string json = b.slice().toJson();
+
+    // the output must be read back exactly, and no shorter output
+    // with the same value may exist
+    double parsed = strtod(json.c_str(), nullptr);
+    ASSERT_EQ(0, memcmp(&value, &parsed, sizeof(double))) << json;
+
+    std::string digits;
+    for (char c : json) {
+      if (c == 'e') {
+        break;
+      }
+      if (c >= '0' && c <= '9' && (c != '0' || !digits.empty())) {
+        digits.push_back(c);
+      }
+    }
+    while (!digits.empty() && digits.back() == '0') {
+      digits.pop_back();
+    }
+    if (digits.size() > 1) {
+      char shorter[32];
+      snprintf(shorter, sizeof(shorter), "%.*e",
+               static_cast<int>(digits.size()) - 2, value);
+      ASSERT_NE(value, strtod(shorter, nullptr)) << json;
+    }
+  }
+}
+
 TEST(StringDumperTest, NumberInt1) {
   Builder b;
   b.add(Value(static_cast<int64_t>(123456789)));
@@ -1776,6 +1967,275 @@ TEST(DumperLengthTest, EscapeUnicodeOff) {
   ASSERT_EQ(strlen("\"mötör\""), sink.length);
 }
 
+TEST(DumperLengthTest, MatchesOutput) {
+  Builder b;
+  b.openObject();
+  b.add("null", Value(ValueType::Null));
+  b.add("bools", Value(ValueType::Array));
+  b.add(Value(true));
+  b.add(Value(false));
+  b.close();
+  b.add("ints", Value(ValueType::Array));
+  for (int64_t v : {int64_t(0), int64_t(-1), int64_t(9), int64_t(-9),
+                    int64_t(10), int64_t(-10), int64_t(99999),
+                    int64_t(1000000000000), INT64_MAX, INT64_MIN,
+                    INT64_MIN + 1}) {
+    b.add(Value(v));
+  }
+  for (uint64_t v : {uint64_t(9999999999999999999ULL),
+                     uint64_t(10000000000000000000ULL), UINT64_MAX}) {
+    b.add(Value(v));
+  }
+  b.close();
+  b.add("doubles", Value(ValueType::Array));
+  for (double v : {0.0, -0.0, 0.1, -1.5, 1.0 / 3.0, 1e21, 1e22, 1e-7, 1e-6,
+                   123456789.125, -2.5e-300, 1.7976931348623157e308}) {
+    b.add(Value(v));
+  }
+  b.close();
+  b.add("strings", Value(ValueType::Array));
+  b.add(Value(""));
+  b.add(Value("plain"));
+  b.add(Value("quote \" backslash \\ slash / controls \n\t\x01\x1f"));
+  b.add(Value("m\xc3\xb6t\xc3\xb6r \xe2\x82\xac \xf0\x9f\x98\x80"));
+  b.add(Value(std::string(200, 'x') + "\"" + std::string(100, 'y')));
+  b.close();
+  b.add("nested", Value(ValueType::Object));
+  b.add("a", Value(ValueType::Array));
+  b.add(Value(ValueType::Object));
+  b.close();
+  b.add(Value(ValueType::Array));
+  b.close();
+  b.close();
+  b.close();
+  b.add("date", Value(1234567890123, ValueType::UTCDate));
+  uint8_t const binary[] = {0x00, 0x7f, 0x80, 0xff};
+  b.add("binary", ValuePair(&binary[0], sizeof(binary), ValueType::Binary));
+  b.close();
+  Slice s = b.slice();
+
+  for (int i = 0; i < 64; ++i) {
+    Options options;
+    options.prettyPrint = (i & 1) != 0;
+    options.singleLinePrettyPrint = (i & 2) != 0;
+    options.escapeUnicode = (i & 4) != 0;
+    options.escapeForwardSlashes = (i & 8) != 0;
+    options.doubleSignificantDigits = (i & 16) ? 3 : 0;
+    options.binaryAsHex = options.datesAsIntegers = (i & 32) != 0;
+    options.unsupportedTypeBehavior = (i & 32) ? Options::FailOnUnsupportedType
+                                               : Options::ConvertUnsupportedType;
+
+    std::string const json = Dumper::toString(s, &options);
+    ASSERT_EQ(json.size(), Dumper::dumpLength(s, &options));
+  }
+}
+
+TEST(DumperLengthTest, MatchesOutputForInvalidUtf8) {
+  Builder b;
+  b.openArray();
+  b.add(Value(std::string("abc\x80\xff\xc3\xb6" "def\xbf")));
+  b.close();
+
+  for (bool escapeUnicode : {false, true}) {
+    Options options;
+    options.escapeUnicode = escapeUnicode;
+    std::string const json = Dumper::toString(b.slice(), &options);
+    ASSERT_EQ(json.size(), Dumper::dumpLength(b.slice(), &options));
+  }
+}
+
+TEST(DumperLengthTest, MatchesOutputForCustomTypes) {
+  struct MyCustomTypeHandler : public CustomTypeHandler {
+    void dump(Slice const&, Dumper* dumper, Slice const&) override {
+      dumper->appendString("custom");
+    }
+  };
+
+  MyCustomTypeHandler handler;
+  Options options;
+  options.customTypeHandler = &handler;
+
+  Builder b(&options);
+  b.openArray();
+  uint8_t* p = b.add(ValuePair(2ULL, ValueType::Custom));
+  *p++ = 0xf0;
+  *p = 1;
+  b.close();
+
+  ASSERT_EQ("[\"custom\"]", Dumper::toString(b.slice(), &options));
+  ASSERT_EQ(10, Dumper::dumpLength(b.slice(), &options));
+}
+
+TEST(DumperLengthTest, DumpAppend) {
+  std::shared_ptr<Builder> b = Parser::fromJson("{\"foo\":[1,2.5,\"bar\"]}");
+
+  std::string out("prefix");
+  Dumper::dumpAppend(out, b->slice());
+  ASSERT_EQ("prefix{\"foo\":[1,2.5,\"bar\"]}", out);
+  ASSERT_EQ("{\"foo\":[1,2.5,\"bar\"]}", b->slice().toJson());
+}
+
+TEST(DumperLengthTest, DumpAppendLarge) {
+  // large enough to be dumped in two passes
+  Builder b;
+  b.openArray();
+  std::string const value(10000, 'x');
+  for (std::size_t i = 0; i <= Dumper::exactReservationThreshold / value.size();
+       ++i) {
+    b.add(Value(value));
+  }
+  b.close();
+  ASSERT_GE(b.size(), Dumper::exactReservationThreshold);
+
+  std::string expected;
+  StringSink sink(&expected);
+  BasicDumper<StringSink>::dump(b.slice(), &sink);
+
+  std::string out("prefix");
+  Dumper::dumpAppend(out, b.slice());
+  ASSERT_EQ("prefix" + expected, out);
+  ASSERT_EQ(expected, b.slice().toJson());
+}
+
+// escapes a string for JSON one byte at a time, the way Dumper did before
+// it scanned for bytes that need escaping. returns false if the string
+// ends within a multi-byte UTF-8 sequence
+static bool referenceEscape(std::string const& value, Options const& options,
+                            std::string& out) {
+  auto appendUnicode = [&out](uint32_t value) {
+    char buffer[8];
+    snprintf(buffer, sizeof(buffer), "\\u%04X", static_cast<unsigned>(value));
+    out.append(buffer);
+  };
+
+  out.push_back('"');
+  std::size_t const n = value.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    uint8_t const c = static_cast<uint8_t>(value[i]);
+    if (c < 0x80) {
+      switch (c) {
+        case '"': out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '/': out.append(options.escapeForwardSlashes ? "\\/" : "/"); break;
+        case '\b': out.append("\\b"); break;
+        case '\t': out.append("\\t"); break;
+        case '\n': out.append("\\n"); break;
+        case '\f': out.append("\\f"); break;
+        case '\r': out.append("\\r"); break;
+        default:
+          if (c < 0x20) {
+            appendUnicode(c);
+          } else {
+            out.push_back(static_cast<char>(c));
+          }
+      }
+      continue;
+    }
+
+    // the length of the sequence is taken from the lead byte. bytes that
+    // cannot start a sequence are dropped
+    std::size_t length;
+    if ((c & 0xe0) == 0xc0) {
+      length = 2;
+    } else if ((c & 0xf0) == 0xe0) {
+      length = 3;
+    } else if ((c & 0xf8) == 0xf0) {
+      length = 4;
+    } else {
+      continue;
+    }
+    if (i + length > n) {
+      return false;
+    }
+    if (!options.escapeUnicode) {
+      out.append(value, i, length);
+    } else {
+      uint32_t cp = c & (0x7f >> length);
+      for (std::size_t j = 1; j < length; ++j) {
+        cp = (cp << 6) | (static_cast<uint8_t>(value[i + j]) & 0x3f);
+      }
+      if (length == 4) {
+        cp -= 0x10000;
+        appendUnicode(((cp >> 10) & 0x3ff) + 0xd800);
+        appendUnicode((cp & 0x3ff) + 0xdc00);
+      } else {
+        appendUnicode(cp & 0xffff);
+      }
+    }
+    i += length - 1;
+  }
+  out.push_back('"');
+  return true;
+}
+
+TEST(StringDumperTest, StringEscapeFastPath) {
+  // the output of the vectorized scan for bytes that need escaping, with
+  // and without native string functions, must match an independent
+  // byte-by-byte escaper, also for invalid UTF-8
+  static char const* pieces[] = {"a", "abcdefghijklmnop", "\"", "\\", "/",
+                                 "\n", "\x01", "\x1f", " ", "\x7f",
+                                 "\xc3\xb6", "\xe2\x82\xac",
+                                 "\xf0\x9f\x98\x80", "\x80", "\xff", "\xc3"};
+  std::mt19937 rng(42);
+
+  for (int i = 0; i < 2000; ++i) {
+    std::string value;
+    std::size_t n = rng() % 40;
+    for (std::size_t j = 0; j < n; ++j) {
+      value.append(pieces[rng() % (sizeof(pieces) / sizeof(pieces[0]))]);
+    }
+    Builder b;
+    b.add(Value(value));
+
+    for (int flags = 0; flags < 4; ++flags) {
+      Options options;
+      options.escapeForwardSlashes = (flags & 1) != 0;
+      options.escapeUnicode = (flags & 2) != 0;
+
+      std::string expected;
+      int expectedError = 0;
+      if (!referenceEscape(value, options, expected)) {
+        expectedError = Exception::InvalidUtf8Sequence;
+      }
+
+      for (int native = 0; native < 2; ++native) {
+        if (native) {
+          enableNativeStringFunctions();
+        } else {
+          enableBuiltinStringFunctions();
+        }
+        std::string actual;
+        int actualError = 0;
+        try {
+          actual = Dumper::toString(b.slice(), &options);
+        } catch (Exception const& ex) {
+          actualError = ex.errorCode();
+        }
+
+        ASSERT_EQ(expectedError, actualError);
+        if (expectedError == 0) {
+          ASSERT_EQ(expected, actual);
+        }
+      }
+    }
+  }
+}
+
+TEST(StringDumperTest, StringLongRuns) {
+  for (std::size_t length = 0; length < 100; ++length) {
+    for (std::size_t pos = 0; pos < length; ++pos) {
+      std::string value(length, 'x');
+      value[pos] = '"';
+      Builder b;
+      b.add(Value(value));
+
+      std::string expected = "\"" + value.substr(0, pos) + "\\\"" +
+                             value.substr(pos + 1) + "\"";
+      ASSERT_EQ(expected, Dumper::toString(b.slice()));
+    }
+  }
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
 
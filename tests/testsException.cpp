@@ -76,10 +76,15 @@ TEST(ExceptionTest, TestMessages) {
                Exception::message(Exception::BuilderTagsDisallowed));
   ASSERT_STREQ("BCD types are not allowed in this configuration",
                Exception::message(Exception::BuilderBCDDisallowed));
+  ASSERT_STREQ("Number of values does not match the Object shape",
+               Exception::message(Exception::BuilderShapeMismatch));
   ASSERT_STREQ("Invalid type found in binary data",
                Exception::message(Exception::ValidatorInvalidType));
   ASSERT_STREQ("Invalid length found in binary data",
                Exception::message(Exception::ValidatorInvalidLength));
+  ASSERT_STREQ("Binary data is nested too deeply",
+               Exception::message(Exception::ValidatorNestingTooDeep));
+  ASSERT_STREQ("File error", Exception::message(Exception::FileError));
   ASSERT_STREQ("Array size does not match tuple size",
                Exception::message(Exception::BadTupleSize));
 
@@ -83,6 +83,32 @@ static bool parseFile(std::string const& filename) {
   }
 }
 
+// parses the file in chunks of different sizes with the stream parser,
+// and compares the result to the regular parser
+static bool streamParseFile(std::string const& filename) {
+  std::string const data = readFile(filename);
+
+  Parser parser;
+  parser.parse(data);
+  Buffer<uint8_t> const& expected = parser.builder().bufferRef();
+
+  for (std::size_t chunkSize : {1, 7, 64, 4096}) {
+    StreamParser streamParser;
+    for (std::size_t i = 0; i < data.size(); i += chunkSize) {
+      streamParser.feed(data.data() + i, (std::min)(chunkSize, data.size() - i));
+    }
+    if (streamParser.finish() != 1) {
+      return false;
+    }
+    Buffer<uint8_t> const& actual = streamParser.builder().bufferRef();
+    if (expected.size() != actual.size() ||
+        memcmp(expected.data(), actual.data(), expected.size()) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 TEST(StaticFilesTest, CommitsJson) { ASSERT_TRUE(parseFile("commits.json")); }
 
 TEST(StaticFilesTest, SampleJson) { ASSERT_TRUE(parseFile("sample.json")); }
@@ -155,6 +181,22 @@ TEST(StaticFilesTest, Fail32Json) { ASSERT_FALSE(parseFile("fail32.json")); }
 
 TEST(StaticFilesTest, Fail33Json) { ASSERT_FALSE(parseFile("fail33.json")); }
 
+TEST(StaticFilesTest, StreamCommitsJson) {
+  ASSERT_TRUE(streamParseFile("commits.json"));
+}
+
+TEST(StaticFilesTest, StreamSampleJson) {
+  ASSERT_TRUE(streamParseFile("sample.json"));
+}
+
+TEST(StaticFilesTest, StreamSampleNoWhiteJson) {
+  ASSERT_TRUE(streamParseFile("sampleNoWhite.json"));
+}
+
+TEST(StaticFilesTest, StreamSmallJson) {
+  ASSERT_TRUE(streamParseFile("small.json"));
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
 
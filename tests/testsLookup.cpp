@@ -1054,6 +1054,174 @@ TEST(LookupTest, ValueAtObjectEmpty) {
   ASSERT_VELOCYPACK_EXCEPTION(s.valueAt(1), Exception::IndexOutOfBounds);
 }
 
+TEST(LookupTest, CompiledPathEmpty) {
+  ASSERT_VELOCYPACK_EXCEPTION(CompiledPath(std::vector<std::string>()),
+                              Exception::InvalidAttributePath);
+}
+
+TEST(LookupTest, CompiledPathNonObject) {
+  CompiledPath path({"foo"});
+  ASSERT_VELOCYPACK_EXCEPTION(path.get(Slice::nullSlice()), Exception::InvalidValueType);
+  ASSERT_VELOCYPACK_EXCEPTION(Slice::emptyArraySlice().get(path), Exception::InvalidValueType);
+}
+
+TEST(LookupTest, CompiledPath) {
+  std::string const value(
+      "{\"foo\":{\"bar\":{\"baz\":1,\"qux\":2},\"x\":[1]},\"a\":\"b\",\"c\":{}}");
+
+  for (int layout = 0; layout < 3; ++layout) {
+    Options options;
+    options.buildUnindexedObjects = (layout == 1);
+    options.buildHashIndexedObjectsThreshold = (layout == 2 ? 1 : 0);
+    Parser parser(&options);
+    parser.parse(value);
+    Slice s = parser.builder().slice();
+
+    CompiledPath path({"foo", "bar", "qux"});
+    ASSERT_EQ(3U, path.size());
+    ASSERT_EQ("bar", path[1]);
+    ASSERT_EQ(2, path.get(s).getInt());
+    ASSERT_EQ(2, s.get(path).getInt());
+    // again, using the remembered positions
+    ASSERT_EQ(2, s.get(path).getInt());
+
+    ASSERT_EQ(1, s.get(CompiledPath({"foo", "bar", "baz"})).getInt());
+    ASSERT_EQ("b", s.get(CompiledPath({"a"})).copyString());
+    ASSERT_TRUE(s.get(CompiledPath({"c"})).isObject());
+    ASSERT_TRUE(s.get(CompiledPath({"foo", "x"})).isArray());
+    ASSERT_TRUE(s.get(CompiledPath({"foo", "bar", "quux"})).isNone());
+    ASSERT_TRUE(s.get(CompiledPath({"foo", "x", "y"})).isNone());
+    ASSERT_TRUE(s.get(CompiledPath({"a", "b"})).isNone());
+    ASSERT_TRUE(s.get(CompiledPath({"c", "d"})).isNone());
+    ASSERT_TRUE(s.get(CompiledPath({"bar"})).isNone());
+  }
+}
+
+TEST(LookupTest, CompiledPathDifferentShapes) {
+  for (int layout = 0; layout < 2; ++layout) {
+    Options options;
+    options.buildHashIndexedObjectsThreshold = (layout == 1 ? 1 : 0);
+
+    std::vector<std::shared_ptr<Builder>> documents;
+    for (std::size_t i = 0; i < 50; ++i) {
+      std::string value("{");
+      for (std::size_t j = 0; j < i; ++j) {
+        value.append("\"attr" + std::to_string(j) + "\":" + std::to_string(j) + ",");
+      }
+      value.append("\"value\":{\"nested\":" + std::to_string(i) + "}}");
+      documents.push_back(Parser::fromJson(value, &options));
+    }
+
+    CompiledPath path({"value", "nested"});
+    CompiledPath missing({"value", "missing"});
+    for (int round = 0; round < 2; ++round) {
+      for (std::size_t i = 0; i < documents.size(); ++i) {
+        Slice s = documents[i]->slice();
+        ASSERT_EQ(i, s.get(path).getUInt());
+        ASSERT_TRUE(s.get(missing).isNone());
+        for (std::size_t j = 0; j < i; j += 7) {
+          CompiledPath attr({"attr" + std::to_string(j)});
+          ASSERT_EQ(j, s.get(attr).getUInt());
+          ASSERT_EQ(j, s.get(attr).getUInt());
+        }
+      }
+    }
+  }
+}
+
+TEST(LookupTest, CompiledPathUnsortedObject) {
+  // {"b":1,"a":2} with an unsorted 1-byte index table
+  uint8_t const data[] = {0x0f, 0x0b, 0x02, 0x41, 0x62, 0x31,
+                          0x41, 0x61, 0x32, 0x03, 0x06};
+  Slice s(&data[0]);
+
+  ASSERT_EQ(1, s.get(CompiledPath({"b"})).getInt());
+  ASSERT_EQ(2, s.get(CompiledPath({"a"})).getInt());
+  ASSERT_TRUE(s.get(CompiledPath({"c"})).isNone());
+}
+
+TEST(LookupTest, CompiledPathLongStringKeys) {
+  // {"a":1,"bc":2} with short names stored as long strings
+  uint8_t const data[] = {0x0b, 0x1c, 0x02,
+                          0xbf, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                          0x61, 0x31,
+                          0xbf, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                          0x62, 0x63, 0x32,
+                          0x03, 0x0e};
+  Slice s(&data[0]);
+  ASSERT_EQ(sizeof(data), s.byteSize());
+  ASSERT_EQ(2, s.get("bc").getInt());
+
+  for (int round = 0; round < 2; ++round) {
+    ASSERT_EQ(1, s.get(CompiledPath({"a"})).getInt());
+    ASSERT_EQ(2, s.get(CompiledPath({"bc"})).getInt());
+    ASSERT_TRUE(s.get(CompiledPath({"b"})).isNone());
+  }
+
+  // {"a":1} has no index table
+  uint8_t const single[] = {0x0b, 0x0f, 0x01,
+                            0xbf, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                            0x61, 0x31, 0x03};
+  Slice t(&single[0]);
+  ASSERT_EQ(sizeof(single), t.byteSize());
+  ASSERT_EQ(1, t.get(CompiledPath({"a"})).getInt());
+  ASSERT_TRUE(t.get(CompiledPath({"b"})).isNone());
+}
+
+TEST(LookupTest, CompiledPathExternals) {
+  Builder inner;
+  inner.openObject();
+  inner.add("bar", Value(42));
+  inner.close();
+
+  Builder outer;
+  outer.openObject();
+  outer.add("foo", Value(static_cast<void const*>(inner.slice().start())));
+  outer.close();
+
+  Builder b;
+  b.add(Value(static_cast<void const*>(outer.slice().start())));
+
+  CompiledPath path({"foo", "bar"});
+  ASSERT_EQ(42, b.slice().get(path, true).getInt());
+  ASSERT_VELOCYPACK_EXCEPTION(b.slice().get(path), Exception::InvalidValueType);
+}
+
+TEST(LookupTest, CompiledPathTranslations) {
+  std::unique_ptr<AttributeTranslator> translator(new AttributeTranslator);
+
+  translator->add("foo", 1);
+  translator->add("bar", 2);
+  translator->seal();
+
+  AttributeTranslatorScope scope(translator.get());
+
+  for (bool unindexed : {false, true}) {
+    Options options;
+    options.attributeTranslator = translator.get();
+    options.buildUnindexedObjects = unindexed;
+
+    Builder b(&options);
+    b.openObject();
+    b.add("foo", Value(ValueType::Object));
+    b.add("bar", Value(1));
+    b.add("baz", Value(2));
+    b.close();
+    b.add("abc", Value(3));
+    b.add("bar", Value(4));
+    b.close();
+    Slice s = b.slice();
+
+    for (int round = 0; round < 2; ++round) {
+      ASSERT_EQ(1, s.get(CompiledPath({"foo", "bar"})).getInt());
+      ASSERT_EQ(2, s.get(CompiledPath({"foo", "baz"})).getInt());
+      ASSERT_EQ(3, s.get(CompiledPath({"abc"})).getInt());
+      ASSERT_EQ(4, s.get(CompiledPath({"bar"})).getInt());
+      ASSERT_TRUE(s.get(CompiledPath({"foo", "abc"})).isNone());
+    }
+  }
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Library to build up VPack documents.
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "tests-common.h"
+
+// temporary file that is removed at the end of the test
+struct TempFile {
+  std::string path;
+
+  explicit TempFile(std::string const& content) {
+    static int counter = 0;
+    path = (std::filesystem::temp_directory_path() /
+            ("testsMappedFile-" + std::to_string(++counter) + ".vpack"))
+               .string();
+    std::ofstream ofs(path, std::ofstream::out | std::ofstream::binary |
+                                std::ofstream::trunc);
+    ofs.write(content.data(), content.size());
+  }
+
+  ~TempFile() {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+  }
+};
+
+static std::string buildValues(std::size_t n) {
+  std::string values;
+  for (std::size_t i = 0; i < n; ++i) {
+    Builder b;
+    b.openObject();
+    b.add("value", Value(i));
+    b.add("name", Value("test" + std::to_string(i)));
+    b.add("list", Value(ValueType::Array));
+    for (std::size_t j = 0; j < i % 10; ++j) {
+      b.add(Value(j));
+    }
+    b.close();
+    b.close();
+    values.append(reinterpret_cast<char const*>(b.data()), b.size());
+  }
+  return values;
+}
+
+TEST(MappedFileTest, CreateWithoutOptions) {
+  TempFile file("\x18");
+  ASSERT_VELOCYPACK_EXCEPTION(new MappedFile(file.path, nullptr),
+                              Exception::InternalError);
+}
+
+TEST(MappedFileTest, NonExistingFile) {
+  ASSERT_VELOCYPACK_EXCEPTION(MappedFile("this-file-does-not-exist.vpack"),
+                              Exception::FileError);
+}
+
+#ifndef _WIN32
+TEST(MappedFileTest, Directory) {
+  ASSERT_VELOCYPACK_EXCEPTION(
+      MappedFile(std::filesystem::temp_directory_path().string()),
+      Exception::FileError);
+}
+
+TEST(MappedFileTest, Pipe) {
+  std::string const values = buildValues(3);
+  int fds[2];
+  ASSERT_EQ(0, ::pipe(fds));
+  // small enough to fit into the pipe's buffer
+  ASSERT_EQ(static_cast<ssize_t>(values.size()),
+            ::write(fds[1], values.data(), values.size()));
+  ::close(fds[1]);
+
+  // pipes cannot be mapped, so they are read
+  MappedFile mapped("/dev/fd/" + std::to_string(fds[0]));
+  ::close(fds[0]);
+  ASSERT_EQ(values.size(), mapped.size());
+  ASSERT_EQ(0, memcmp(values.data(), mapped.data(), values.size()));
+  ASSERT_EQ(3U, mapped.length());
+  ASSERT_TRUE(mapped.isValidated());
+  ASSERT_EQ(2U, mapped.at(2).slice().get("value").getUInt());
+}
+#endif
+
+TEST(MappedFileTest, EmptyFile) {
+  TempFile file("");
+  MappedFile mapped(file.path);
+  ASSERT_EQ(nullptr, mapped.data());
+  ASSERT_EQ(0U, mapped.size());
+  ASSERT_EQ(0U, mapped.length());
+  ASSERT_TRUE(mapped.isValidated());
+  ASSERT_VELOCYPACK_EXCEPTION(mapped.at(0), Exception::IndexOutOfBounds);
+}
+
+TEST(MappedFileTest, SingleValue) {
+  std::string const values = buildValues(1);
+  TempFile file(values);
+  MappedFile mapped(file.path);
+  ASSERT_EQ(values.size(), mapped.size());
+  ASSERT_EQ(0, memcmp(values.data(), mapped.data(), values.size()));
+
+  SharedSlice s = mapped.at(0);
+  ASSERT_EQ(mapped.data(), s.start().get());
+  ASSERT_EQ(0U, s.get("value").getUInt());
+  ASSERT_EQ("test0", s.get("name").copyString());
+  ASSERT_TRUE(mapped.isValidated());
+  ASSERT_EQ(1U, mapped.length());
+  ASSERT_VELOCYPACK_EXCEPTION(mapped.at(1), Exception::IndexOutOfBounds);
+}
+
+TEST(MappedFileTest, ManyValues) {
+  std::string const values = buildValues(1000);
+  TempFile file(values);
+  MappedFile mapped(file.path);
+
+  // values are validated lazily
+  ASSERT_FALSE(mapped.isValidated());
+  ASSERT_EQ(5U, mapped[5].get("value").getUInt());
+  ASSERT_FALSE(mapped.isValidated());
+
+  ASSERT_EQ(1000U, mapped.length());
+  ASSERT_TRUE(mapped.isValidated());
+
+  uint8_t const* p = reinterpret_cast<uint8_t const*>(values.data());
+  for (ValueLength i = 0; i < 1000; ++i) {
+    Slice expected(p);
+    Slice actual = mapped.sliceAt(i);
+    ASSERT_EQ(expected.byteSize(), actual.byteSize());
+    ASSERT_EQ(0, memcmp(expected.start(), actual.start(), expected.byteSize()));
+    ASSERT_EQ(i, actual.get("value").getUInt());
+    p += expected.byteSize();
+  }
+}
+
+TEST(MappedFileTest, Lifetime) {
+  std::string const values = buildValues(3);
+  TempFile file(values);
+
+  auto mapped = std::make_unique<MappedFile>(file.path);
+  SharedSlice s = mapped->at(2);
+  ASSERT_EQ(2, mapped->buffer().use_count());
+  mapped.reset();
+
+  // the SharedSlice keeps the mapping alive
+  ASSERT_EQ(1, s.buffer().use_count());
+  ASSERT_EQ(2U, s.get("value").getUInt());
+  ASSERT_EQ("test2", s.get("name").copyString());
+}
+
+TEST(MappedFileTest, InvalidValues) {
+  std::string values = buildValues(10);
+  // an Array that claims to be longer than the rest of the file
+  values.append("\x02\x40\x18", 3);
+  TempFile file(values);
+
+  MappedFile mapped(file.path);
+  for (ValueLength i = 0; i < 10; ++i) {
+    ASSERT_EQ(i, mapped[i].get("value").getUInt());
+  }
+  ASSERT_VELOCYPACK_EXCEPTION(mapped.at(10), Exception::ValidatorInvalidLength);
+  ASSERT_VELOCYPACK_EXCEPTION(mapped.validate(), Exception::ValidatorInvalidLength);
+  ASSERT_VELOCYPACK_EXCEPTION(mapped.length(), Exception::ValidatorInvalidLength);
+  ASSERT_FALSE(mapped.isValidated());
+
+  // the valid values stay accessible
+  ASSERT_EQ(9U, mapped[9].get("value").getUInt());
+}
+
+TEST(MappedFileTest, Options) {
+  Builder b;
+  b.add(Value(ValueType::Array));
+  b.addTagged(42, Value(1));
+  b.close();
+  TempFile file(std::string(reinterpret_cast<char const*>(b.data()), b.size()));
+
+  MappedFile mapped(file.path);
+  ASSERT_EQ(1U, mapped.length());
+
+  Options options;
+  options.disallowTags = true;
+  MappedFile strict(file.path, &options);
+  ASSERT_VELOCYPACK_EXCEPTION(strict.validate(), Exception::BuilderTagsDisallowed);
+}
+
+TEST(MappedFileTest, DeepValue) {
+  // deeper than the default Options::maxValidationDepth
+  Builder b;
+  for (std::size_t i = 0; i < 2000; ++i) {
+    b.openArray();
+  }
+  for (std::size_t i = 0; i < 2000; ++i) {
+    b.close();
+  }
+  TempFile file(std::string(reinterpret_cast<char const*>(b.data()), b.size()));
+
+  MappedFile mapped(file.path);
+  mapped.validate();
+  ASSERT_EQ(1U, mapped.length());
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -24,7 +24,13 @@
 /// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
 #include <ostream>
+#include <random>
 #include <string>
 
 #include "tests-common.h"
@@ -731,6 +737,102 @@ TEST(ParserTest, DoublePlusInf) {
   ASSERT_VELOCYPACK_EXCEPTION(parser.parse(value), Exception::NumberOutOfRange);
 }
 
+static void checkDoubleAgainstStrtod(std::string const& value) {
+  double expected = strtod(value.c_str(), nullptr);
+  if (std::isinf(expected)) {
+    ASSERT_VELOCYPACK_EXCEPTION(Parser::fromJson(value),
+                                Exception::NumberOutOfRange);
+    return;
+  }
+
+  std::shared_ptr<Builder> builder = Parser::fromJson(value);
+  Slice s(builder->slice());
+  ASSERT_TRUE(s.isDouble()) << value;
+  double actual = s.getDouble();
+  // compare bit patterns, so that 0.0 and -0.0 are different
+  ASSERT_EQ(0, memcmp(&expected, &actual, sizeof(double)))
+      << value << ": expected " << expected << ", got " << actual;
+}
+
+TEST(ParserTest, DoubleExactRounding) {
+  for (auto const& value : {
+           "0.1", "0.2", "0.3", "-0.0", "0.0e0", "1e23", "1e22", "1e-22",
+           // 2^53 + 1, rounds to 2^53
+           "9007199254740993.0",
+           // largest and smallest doubles, and their neighborhood
+           "1.7976931348623157e308", "1.7976931348623158e308",
+           "4.9406564584124654e-324", "2.4703282292062328e-324",
+           "2.4703282292062327e-324", "1e-400", "0.0000001e-320",
+           // largest subnormal and smallest normal double
+           "2.2250738585072009e-308", "2.2250738585072011e-308",
+           "2.2250738585072014e-308",
+           // exactly half-way between 1 and the next double, and next to it
+           "1.00000000000000011102230246251565404236316680908203125",
+           "1.00000000000000011102230246251565404236316680908203124",
+           "1.00000000000000011102230246251565404236316680908203126",
+           // long mantissas
+           "123456789012345678901234567890e-10",
+           "0.000000000000000000000000000001234567890123456789012345",
+           "18446744073709551616", "-18446744073709551617",
+           "99999999999999999999999999999999999999999999999999e-50",
+       }) {
+    checkDoubleAgainstStrtod(value);
+  }
+}
+
+TEST(ParserTest, DoubleRoundTripRandomBits) {
+  std::mt19937_64 random(42);
+  char buffer[64];
+
+  for (int i = 0; i < 100000; ++i) {
+    uint64_t bits = random();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (!std::isfinite(value)) {
+      continue;
+    }
+    // shortest round-trip representation and a truncated one
+    snprintf(buffer, sizeof(buffer), "%.17g", value);
+    if (strpbrk(buffer, ".e") == nullptr) {
+      // integral value. force a double
+      strcat(buffer, ".0");
+    }
+    checkDoubleAgainstStrtod(buffer);
+    snprintf(buffer, sizeof(buffer), "%.*e", static_cast<int>(random() % 20),
+             value);
+    checkDoubleAgainstStrtod(buffer);
+  }
+}
+
+TEST(ParserTest, DoubleRoundTripRandomDigits) {
+  std::mt19937_64 random(42);
+
+  for (int i = 0; i < 100000; ++i) {
+    // up to 40 digits, so that some of them do not fit into 64 bits
+    std::size_t digits = 1 + random() % 40;
+    std::string value;
+    if (random() % 2 == 0) {
+      value.push_back('-');
+    }
+    value.push_back(static_cast<char>('1' + random() % 9));
+    for (std::size_t j = 1; j < digits; ++j) {
+      value.push_back(static_cast<char>('0' + random() % 10));
+    }
+    std::size_t dot = random() % (digits + 1);
+    if (dot > 0 && dot < digits) {
+      value.insert(value.size() - dot, ".");
+    }
+    if (random() % 2 == 0 || (dot == 0 && digits > 19)) {
+      value.append("e");
+      value.append(std::to_string(static_cast<int>(random() % 700) - 350));
+    } else if (dot == 0 || dot == digits) {
+      // force a double
+      value.append(".0");
+    }
+    checkDoubleAgainstStrtod(value);
+  }
+}
+
 TEST(ParserTest, Empty) {
   std::string const value("");
 
@@ -2534,6 +2636,195 @@ TEST(ParserTest, UseBuilderOnStackOptionsNullPtr) {
   delete parser;
 }
 
+static void checkStructuralIndex(std::string const& value, bool multi = false) {
+  Options regular;
+  regular.useStructuralIndex = false;
+  Options indexed;
+  indexed.useStructuralIndex = true;
+
+  Parser regularParser(&regular);
+  Parser indexedParser(&indexed);
+
+  bool regularFailed = false;
+  int regularCode = 0;
+  std::size_t regularPos = 0;
+  try {
+    regularParser.parse(value, multi);
+  } catch (Exception const& ex) {
+    regularFailed = true;
+    regularCode = ex.errorCode();
+    regularPos = regularParser.errorPos();
+  }
+
+  bool indexedFailed = false;
+  int indexedCode = 0;
+  std::size_t indexedPos = 0;
+  try {
+    indexedParser.parse(value, multi);
+  } catch (Exception const& ex) {
+    indexedFailed = true;
+    indexedCode = ex.errorCode();
+    indexedPos = indexedParser.errorPos();
+  }
+
+  ASSERT_EQ(regularFailed, indexedFailed) << value;
+  if (regularFailed) {
+    ASSERT_EQ(regularCode, indexedCode) << value;
+    ASSERT_EQ(regularPos, indexedPos) << value;
+  } else {
+    Buffer<uint8_t> const& a = regularParser.builder().bufferRef();
+    Buffer<uint8_t> const& b = indexedParser.builder().bufferRef();
+    ASSERT_EQ(a.size(), b.size()) << value;
+    ASSERT_EQ(0, memcmp(a.data(), b.data(), a.size())) << value;
+  }
+}
+
+TEST(ParserTest, StructuralIndexScalars) {
+  for (auto const& value : { "null", "true", "false", "0", "-1", "17",
+                             "1.5", "-3.25e10", "18446744073709551616",
+                             "\"\"", "\"foo\"", "  \"foo bar\"  ",
+                             "\"\\\"\"", "\"\\\\\"", "\"a\\u00e4b\"" }) {
+    checkStructuralIndex(value);
+  }
+}
+
+TEST(ParserTest, StructuralIndexCompound) {
+  for (auto const& value : { "[]", "{}", "[[]]", "[1,2,3]", " [ 1 , \"2\" , 3 ] ",
+                             "{\"a\":1,\"b\":[true,false,null],\"c\":{\"d\":\"e\"}}",
+                             "{\"a\\\"b\":\"c\\\\\",\"d\":\"{[,:]}\"}",
+                             "[\"\\\\\\\\\\\"\",\"\\\\\"]" }) {
+    checkStructuralIndex(value);
+  }
+}
+
+TEST(ParserTest, StructuralIndexLongStrings) {
+  // string lengths around the short/long string boundary, with
+  // escape sequences crossing the 64 byte block boundaries
+  for (std::size_t length = 0; length < 300; ++length) {
+    std::string plain(length, 'x');
+    checkStructuralIndex("\"" + plain + "\"");
+    checkStructuralIndex("[\"" + plain + "\",\"" + plain + "\"]");
+
+    std::string escaped(length, '\\');
+    escaped.push_back('"');
+    checkStructuralIndex("[\"" + escaped + "\"]");
+    checkStructuralIndex("{\"" + escaped + "\":" + std::to_string(length) + "}");
+  }
+}
+
+TEST(ParserTest, StructuralIndexErrors) {
+  for (auto const& value : { "", " ", "z", "foo", "truth", "tru", "truebar",
+                             "[", "[1", "[1,", "[1,]", "[1 2]", "]", "{",
+                             "{\"a\"", "{\"a\":", "{\"a\":1,", "{\"a\" 1}",
+                             "{a:1}", "{\"a\":1]", "\"abc", "\"a\\\"", 
+                             "\"a\x01b\"", "[1]x", "1 \"", "-", "1.", "1e",
+                             "[truefalse]", "{\"a\":nullx}" }) {
+    checkStructuralIndex(value);
+  }
+}
+
+TEST(ParserTest, StructuralIndexMulti) {
+  for (auto const& value : { "1 2 3", "[] {} \"\"", "{\"a\":1}\n{\"b\":2}\n",
+                             "true5", "0f", "1 [" }) {
+    checkStructuralIndex(value, true);
+  }
+}
+
+TEST(ParserTest, StructuralIndexRelease) {
+  // the index is kept for later inputs until it is released
+  std::string big("[");
+  for (std::size_t i = 0; i < 300000; ++i) {
+    big.append(i == 0 ? "1" : ",1");
+  }
+  big.append("]");
+
+  Options options;
+  options.useStructuralIndex = true;
+  Parser parser(&options);
+  ASSERT_EQ(0U, parser.structuralIndexCapacity());
+
+  for (int i = 0; i < 2; ++i) {
+    parser.parse(big);
+    ASSERT_EQ(300000U, parser.builder().slice().length());
+    ASSERT_EQ(big.size(), parser.structuralIndexCapacity());
+
+    parser.parse("[1,{\"a\":2}]");
+    ASSERT_EQ("[1,{\"a\":2}]", parser.builder().slice().toJson());
+    ASSERT_EQ(big.size(), parser.structuralIndexCapacity());
+
+    std::string broken = big;
+    broken[broken.size() / 2] = 'x';
+    ASSERT_VELOCYPACK_EXCEPTION(parser.parse(broken), Exception::ParseError);
+
+    parser.releaseStructuralIndex();
+    ASSERT_EQ(0U, parser.structuralIndexCapacity());
+    parser.parse("[1,{\"a\":2}]");
+    ASSERT_EQ("[1,{\"a\":2}]", parser.builder().slice().toJson());
+    ASSERT_EQ(11U, parser.structuralIndexCapacity());
+  }
+}
+
+TEST(ParserTest, StructuralIndexKeepTopLevelOpen) {
+  Options options;
+  options.useStructuralIndex = true;
+  options.keepTopLevelOpen = true;
+
+  Parser parser(&options);
+  parser.parse("{\"foo\":\"bar\",\"baz\":{}}");
+  Builder const& builder = parser.builder();
+  ASSERT_TRUE(builder.isOpenObject());
+}
+
+TEST(ParserTest, StructuralIndexUtf8Check) {
+  Options options;
+  options.useStructuralIndex = true;
+  options.validateUtf8Strings = true;
+
+  std::string value("\"");
+  value.push_back(static_cast<char>(0xc3));
+  value.push_back(static_cast<char>(0xa4));
+  value.append("\"");
+
+  Parser parser(&options);
+  parser.parse(value);
+  ASSERT_EQ(value.substr(1, 2), parser.builder().slice().copyString());
+
+  value.insert(1, 1, static_cast<char>(0x80));
+  ASSERT_VELOCYPACK_EXCEPTION(parser.parse(value),
+                              Exception::InvalidUtf8Sequence);
+}
+
+TEST(ParserTest, StructuralIndexNonSSE) {
+  // modify global function pointer!
+  enableBuiltinStringFunctions();
+
+  checkStructuralIndex("{\"a\\\"b\":[1,2.5,\"c\"],\"d\":{\"e\":null}}");
+  checkStructuralIndex("[\"" + std::string(200, 'x') + "\\\\\"]");
+
+  enableNativeStringFunctions();
+}
+
+TEST(ParserTest, MemoryResource) {
+  std::string const value(
+      "{\"foo\":[1,2,3,{\"bar\":\"baz\"}],\"qux\":\"" +
+      std::string(1000, 'x') + "\",\"num\":-1.5e10,\"t\":true}");
+
+  std::vector<char> memory(64 * 1024);
+  std::pmr::monotonic_buffer_resource resource(memory.data(), memory.size(),
+                                               std::pmr::null_memory_resource());
+  Parser parser(&resource, &Options::Defaults);
+  ASSERT_EQ(1U, parser.parse(value));
+
+  std::shared_ptr<Builder> builder = Parser::fromJson(value);
+  ASSERT_EQ(builder->size(), parser.builder().size());
+  ASSERT_EQ(0, memcmp(builder->data(), parser.builder().data(), builder->size()));
+  ASSERT_EQ(&resource, parser.builder().bufferRef().memoryResource());
+
+  std::pmr::memory_resource* nullResource = nullptr;
+  ASSERT_VELOCYPACK_EXCEPTION(new Parser(nullResource, &Options::Defaults),
+                              Exception::InternalError);
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -0,0 +1,386 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Library to build up VPack documents.
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tests-common.h"
+
+struct Point {
+  int32_t x = 0;
+  int32_t y = 0;
+};
+VELOCYPACK_REFLECT(Point, x, y)
+
+struct Event {
+  uint64_t time = 0;
+  std::string level;
+  double value = 0.0;
+  bool flag = false;
+  std::vector<Point> points;
+  std::optional<std::string> comment;
+  std::map<std::string, int64_t> counters;
+};
+VELOCYPACK_REFLECT(Event, time, level, value, flag, points, comment, counters)
+
+struct Wide {
+  int64_t f0 = 0;
+  int64_t f1 = 0;
+  int64_t f2 = 0;
+  int64_t f3 = 0;
+  int64_t f4 = 0;
+  int64_t f5 = 0;
+  int64_t f6 = 0;
+  int64_t f7 = 0;
+  int64_t f8 = 0;
+  int64_t f9 = 0;
+  int64_t f10 = 0;
+  int64_t f11 = 0;
+  int64_t f12 = 0;
+  int64_t f13 = 0;
+  int64_t f14 = 0;
+  int64_t f15 = 0;
+  int64_t f16 = 0;
+  int64_t f17 = 0;
+  int64_t f18 = 0;
+  int64_t f19 = 0;
+  int64_t f20 = 0;
+  int64_t f21 = 0;
+  int64_t f22 = 0;
+  int64_t f23 = 0;
+  int64_t f24 = 0;
+  int64_t f25 = 0;
+  int64_t f26 = 0;
+  int64_t f27 = 0;
+  int64_t f28 = 0;
+  int64_t f29 = 0;
+  int64_t f30 = 0;
+  int64_t f31 = 0;
+};
+VELOCYPACK_REFLECT(Wide, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31)
+
+struct View {
+  std::string_view name;
+  std::optional<std::string_view> alias;
+  Slice raw;
+};
+VELOCYPACK_REFLECT(View, name, alias, raw)
+
+namespace serializertest {
+struct Renamed {
+  std::string name;
+  int64_t id = 0;
+};
+
+constexpr auto velocypackFields(Renamed const*) {
+  return std::make_tuple(arangodb::velocypack::field("_key", &Renamed::name),
+                         arangodb::velocypack::field("_id", &Renamed::id));
+}
+}  // namespace serializertest
+
+static_assert(IsReflected<Event>::value);
+static_assert(!IsReflected<std::string>::value);
+static_assert(Reflection<Event>::size == 7);
+static_assert(Reflection<Event>::names()[1] == "level");
+
+static Event makeEvent() {
+  Event e;
+  e.time = 1234567890123;
+  e.level = "warning";
+  e.value = -2.5;
+  e.flag = true;
+  e.points = {Point{1, 2}, Point{-3, 40000}};
+  e.comment = "disk almost full";
+  e.counters = {{"errors", 3}, {"retries", -1}};
+  return e;
+}
+
+// builds e with Builder::add(name, value) for each attribute
+static void addEvent(Builder& expected, Event const& e) {
+  expected.openObject();
+  expected.add("time", Value(e.time));
+  expected.add("level", Value(e.level));
+  expected.add("value", Value(e.value));
+  expected.add("flag", Value(e.flag));
+  expected.add("points", Value(ValueType::Array));
+  for (auto const& p : e.points) {
+    expected.openObject();
+    expected.add("x", Value(p.x));
+    expected.add("y", Value(p.y));
+    expected.close();
+  }
+  expected.close();
+  expected.add("comment", Value(*e.comment));
+  expected.add("counters", Value(ValueType::Object));
+  for (auto const& it : e.counters) {
+    expected.add(it.first, Value(it.second));
+  }
+  expected.close();
+  expected.close();
+}
+
+TEST(SerializerTest, SameAsBuilder) {
+  Event e = makeEvent();
+
+  Builder expected;
+  addEvent(expected, e);
+
+  Builder b;
+  serialize(b, e);
+
+  ASSERT_EQ(expected.size(), b.size());
+  ASSERT_EQ(0, memcmp(expected.start(), b.start(), b.size()));
+}
+
+TEST(SerializerTest, SameAsBuilderWithTranslator) {
+  std::unique_ptr<AttributeTranslator> translator(new AttributeTranslator);
+  translator->add("level", 1);
+  translator->add("x", 2);
+  translator->seal();
+
+  AttributeTranslatorScope scope(translator.get());
+
+  Options options;
+  options.attributeTranslator = translator.get();
+  Options plainOptions;
+  plainOptions.attributeTranslator = nullptr;
+  Event e = makeEvent();
+
+  for (int i = 0; i < 2; ++i) {
+    // the keys are translated with the Builder's translator
+    Builder expected(&options);
+    addEvent(expected, e);
+
+    Builder b(&options);
+    serialize(b, e);
+
+    ASSERT_EQ(expected.size(), b.size());
+    ASSERT_EQ(0, memcmp(expected.start(), b.start(), b.size()));
+    ASSERT_EQ(e.level, b.slice().get("level").copyString());
+
+    Event out = deserialize<Event>(b.slice());
+    ASSERT_EQ(e.level, out.level);
+    ASSERT_EQ(e.points.size(), out.points.size());
+    ASSERT_EQ(e.points[1].x, out.points[1].x);
+
+    // Builders without translator still get untranslated keys
+    Builder plainExpected(&plainOptions);
+    addEvent(plainExpected, e);
+    Builder plain(&plainOptions);
+    serialize(plain, e);
+    ASSERT_EQ(plainExpected.size(), plain.size());
+    ASSERT_EQ(0, memcmp(plainExpected.start(), plain.start(), plain.size()));
+  }
+}
+
+TEST(SerializerTest, RoundTrip) {
+  Event e = makeEvent();
+
+  Builder b;
+  serialize(b, e);
+  Event out = deserialize<Event>(b.slice());
+
+  ASSERT_EQ(e.time, out.time);
+  ASSERT_EQ(e.level, out.level);
+  ASSERT_EQ(e.value, out.value);
+  ASSERT_EQ(e.flag, out.flag);
+  ASSERT_EQ(2, out.points.size());
+  ASSERT_EQ(-3, out.points[1].x);
+  ASSERT_EQ(40000, out.points[1].y);
+  ASSERT_EQ(e.comment, out.comment);
+  ASSERT_EQ(e.counters, out.counters);
+}
+
+TEST(SerializerTest, Null) {
+  Event e;
+
+  Builder b;
+  serialize(b, e);
+  ASSERT_TRUE(b.slice().get("comment").isNull());
+
+  Event out = makeEvent();
+  deserialize(b.slice(), out);
+  ASSERT_FALSE(out.comment.has_value());
+  ASSERT_TRUE(out.points.empty());
+  ASSERT_TRUE(out.counters.empty());
+}
+
+TEST(SerializerTest, MissingAttributes) {
+  auto b = Parser::fromJson("{\"level\":\"info\",\"x\":42}");
+  Event out = makeEvent();
+  deserialize(b->slice(), out);
+  ASSERT_EQ("info", out.level);
+  ASSERT_EQ(1234567890123, out.time);
+  ASSERT_FALSE(out.comment.has_value());
+  ASSERT_EQ(2, out.points.size());
+}
+
+TEST(SerializerTest, RenamedAttributes) {
+  serializertest::Renamed r{"abc", 42};
+
+  Builder b;
+  serialize(b, r);
+  ASSERT_EQ("{\"_id\":42,\"_key\":\"abc\"}", b.toJson());
+
+  auto out = deserialize<serializertest::Renamed>(b.slice());
+  ASSERT_EQ("abc", out.name);
+  ASSERT_EQ(42, out.id);
+}
+
+TEST(SerializerTest, ArrayOfStructs) {
+  std::vector<Point> points = {Point{1, 2}, Point{3, 4}, Point{5, 6}};
+
+  Builder b;
+  serialize(b, points);
+  ASSERT_EQ("[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4},{\"x\":5,\"y\":6}]", b.toJson());
+  ASSERT_EQ(points.size(), deserialize<std::vector<Point>>(b.slice()).size());
+}
+
+TEST(SerializerTest, InsideObject) {
+  Builder b;
+  b.openObject();
+  b.add(Value("point"));
+  serialize(b, Point{7, 8});
+  b.add("other", Value(true));
+  b.close();
+  ASSERT_EQ("{\"other\":true,\"point\":{\"x\":7,\"y\":8}}", b.toJson());
+}
+
+TEST(SerializerTest, StringView) {
+  std::string_view s;
+  Builder b;
+  b.add(Value("foobar"));
+  deserialize(b.slice(), s);
+  ASSERT_EQ("foobar", s);
+  ASSERT_EQ(reinterpret_cast<char const*>(b.start()) + 1, s.data());
+}
+
+TEST(SerializerTest, FindField) {
+  for (std::size_t i = 0; i < Reflection<Wide>::size; ++i) {
+    ASSERT_EQ(i, Reflection<Wide>::find("f" + std::to_string(i)));
+  }
+  ASSERT_EQ(Reflection<Wide>::size, Reflection<Wide>::find("f32"));
+  ASSERT_EQ(Reflection<Wide>::size, Reflection<Wide>::find(""));
+  ASSERT_EQ(Reflection<Wide>::size, Reflection<Wide>::find("f0 "));
+  ASSERT_EQ(1, Reflection<Event>::find("level"));
+  ASSERT_EQ(Reflection<Event>::size, Reflection<Event>::find("levels"));
+}
+
+TEST(SerializerTest, WideRoundTrip) {
+  Wide w;
+  w.f0 = -1;
+  w.f17 = 17;
+  w.f31 = 1234567890;
+
+  Builder b;
+  serialize(b, w);
+  ASSERT_EQ(32, b.slice().length());
+
+  Wide out = deserialize<Wide>(b.slice());
+  ASSERT_EQ(-1, out.f0);
+  ASSERT_EQ(17, out.f17);
+  ASSERT_EQ(1234567890, out.f31);
+}
+
+TEST(SerializerTest, ObjectLayouts) {
+  std::string json = "{\"unknown\":[1,2,3],\"level\":\"error\",\"time\":99,\"comment\":\"c\"}";
+  for (int layout = 0; layout < 3; ++layout) {
+    Options options;
+    options.buildUnindexedObjects = (layout == 1);
+    options.buildHashIndexedObjectsThreshold = (layout == 2 ? 1 : 0);
+    Parser parser(&options);
+    parser.parse(json);
+    Slice s = parser.builder().slice();
+
+    Event out;
+    deserialize(s, out);
+    ASSERT_EQ(99, out.time);
+    ASSERT_EQ("error", out.level);
+    ASSERT_EQ("c", out.comment);
+  }
+}
+
+TEST(SerializerTest, TranslatedKeys) {
+  std::unique_ptr<AttributeTranslator> translator(new AttributeTranslator);
+  translator->add("level", 1);
+  translator->seal();
+
+  AttributeTranslatorScope scope(translator.get());
+
+  Options options;
+  options.attributeTranslator = translator.get();
+
+  Builder b(&options);
+  b.openObject();
+  b.add("level", Value("debug"));
+  b.add("time", Value(5));
+  b.close();
+  ASSERT_TRUE(ObjectIterator(b.slice(), true).key(false).isSmallInt());
+
+  Event out = deserialize<Event>(b.slice());
+  ASSERT_EQ("debug", out.level);
+  ASSERT_EQ(5, out.time);
+}
+
+TEST(SerializerTest, ZeroCopy) {
+  auto b = Parser::fromJson("{\"raw\":{\"a\":[1]},\"name\":\"some name\",\"alias\":\"x\"}");
+  Slice s = b->slice();
+  uint8_t const* begin = s.start();
+  uint8_t const* end = s.start() + s.byteSize();
+
+  View v = deserialize<View>(s);
+  ASSERT_EQ("some name", v.name);
+  ASSERT_EQ("x", *v.alias);
+  ASSERT_TRUE(reinterpret_cast<uint8_t const*>(v.name.data()) > begin);
+  ASSERT_TRUE(reinterpret_cast<uint8_t const*>(v.name.data()) < end);
+  ASSERT_TRUE(v.raw.start() > begin && v.raw.start() < end);
+  ASSERT_EQ(1, v.raw.get("a").at(0).getInt());
+
+  b = Parser::fromJson("{\"name\":\"other\"}");
+  deserialize(b->slice(), v);
+  ASSERT_EQ("other", v.name);
+  ASSERT_FALSE(v.alias.has_value());
+}
+
+TEST(SerializerTest, WrongTypes) {
+  Event out;
+  auto b = Parser::fromJson("{\"time\":\"now\"}");
+  ASSERT_VELOCYPACK_EXCEPTION(deserialize(b->slice(), out), Exception::InvalidValueType);
+
+  b = Parser::fromJson("[1, 2]");
+  ASSERT_VELOCYPACK_EXCEPTION(deserialize(b->slice(), out), Exception::InvalidValueType);
+
+  b = Parser::fromJson("{\"points\":{}}");
+  ASSERT_VELOCYPACK_EXCEPTION(deserialize(b->slice(), out), Exception::InvalidValueType);
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
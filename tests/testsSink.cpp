@@ -27,6 +27,12 @@
 #include <ostream>
 #include <string>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <thread>
+#endif
+
 #include "tests-common.h"
 
 TEST(SinkTest, CharBufferSink) {
@@ -110,6 +116,237 @@ TEST(SinkTest, StringStreamSink) {
   ASSERT_EQ("xfoobarbazfoobarbazfoobarbaz", out.str());
 }
 
+TEST(SinkTest, BufferedSink) {
+  std::string out;
+  StringSink target(&out);
+  BufferedSink s(&target);
+
+  s.push_back('x');
+  s.append(std::string("foo"));
+  s.append("bar");
+  s.append("baz", 3);
+  ASSERT_TRUE(out.empty());
+
+  s.flush();
+  ASSERT_EQ("xfoobarbaz", out);
+
+  s.flush();
+  ASSERT_EQ("xfoobarbaz", out);
+}
+
+TEST(SinkTest, BufferedSinkFullBuffer) {
+  std::string out;
+  StringSink target(&out);
+  BufferedSinkImpl<StringSink, 4096> s(&target);
+
+  std::string expected;
+  for (int i = 0; i < 4096; ++i) {
+    s.push_back('a' + (i % 26));
+    expected.push_back('a' + (i % 26));
+  }
+  ASSERT_TRUE(out.empty());
+
+  // the buffer is full, so the next byte flushes it
+  s.push_back('!');
+  expected.push_back('!');
+  ASSERT_EQ(4096, out.size());
+
+  // appends that do not fit flush the buffer first
+  std::string chunk(4000, 'y');
+  s.append(chunk);
+  expected.append(chunk);
+  ASSERT_EQ(4096, out.size());
+  s.append(chunk);
+  expected.append(chunk);
+  ASSERT_EQ(4096 + 4001, out.size());
+
+  // chunks larger than the buffer are passed on directly
+  std::string large(10000, 'z');
+  s.append(large);
+  expected.append(large);
+  ASSERT_EQ(expected, out);
+}
+
+TEST(SinkTest, BufferedSinkFlushesOnDestruction) {
+  std::ostringstream out;
+  StringStreamSink target(&out);
+  {
+    BufferedSinkImpl<StringStreamSink> s(&target);
+    s.append("foobarbaz");
+    ASSERT_EQ("", out.str());
+  }
+  ASSERT_EQ("foobarbaz", out.str());
+}
+
+TEST(SinkTest, BufferedSinkReserve) {
+  std::string out;
+  StringSink target(&out);
+  BufferedSink s(&target);
+
+  // small reservations are covered by the buffer
+  s.reserve(100);
+  ASSERT_EQ(0, out.size());
+
+  s.reserve(100000);
+  ASSERT_GE(out.capacity(), 100000);
+}
+
+#ifndef _WIN32
+
+// reads from fd until end of file
+static std::string readAll(int fd) {
+  std::string result;
+  char buffer[4096];
+  while (true) {
+    ssize_t n = ::read(fd, &buffer[0], sizeof(buffer));
+    if (n <= 0) {
+      break;
+    }
+    result.append(&buffer[0], static_cast<std::size_t>(n));
+  }
+  return result;
+}
+
+// appends enough data to fill the buffers of a FileDescriptorSink with
+// small buffers many times, and returns it
+static std::string fillSink(FileDescriptorSink& s) {
+  std::string expected;
+  for (int i = 0; i < 50000; ++i) {
+    std::string value = std::to_string(i);
+    s.append(value);
+    s.push_back(',');
+    expected.append(value);
+    expected.push_back(',');
+  }
+  std::string large(20000, 'x');
+  s.append(large);
+  expected.append(large);
+  return expected;
+}
+
+TEST(SinkTest, FileDescriptorSinkInvalid) {
+  ASSERT_VELOCYPACK_EXCEPTION(FileDescriptorSink(-1), Exception::FileError);
+}
+
+TEST(SinkTest, FileDescriptorSinkFile) {
+  char path[] = "/tmp/testsSink-XXXXXX";
+  int fd = ::mkstemp(&path[0]);
+  ASSERT_NE(-1, fd);
+  ::unlink(&path[0]);
+
+  FileDescriptorSinkOptions options;
+  options.bufferSize = 4096;
+  options.maxBuffers = 2;
+  FileDescriptorSink s(fd, options);
+  ASSERT_EQ(fd, s.fd());
+
+  std::string expected = fillSink(s);
+  s.flush();
+  ASSERT_EQ(expected.size(), s.written());
+
+  ASSERT_EQ(0, ::lseek(fd, 0, SEEK_SET));
+  ASSERT_EQ(expected, readAll(fd));
+  ::close(fd);
+}
+
+TEST(SinkTest, FileDescriptorSinkDumper) {
+  std::string value("{\"short\":\"abc\",\"long\":[");
+  for (int i = 0; i < 1000; ++i) {
+    if (i > 0) {
+      value.push_back(',');
+    }
+    // long strings with escapes in between
+    value.append("\"" + std::string(100, 'a' + (i % 26)) + "\\n" +
+                 std::string(50, 'z') + "\\u0001\"");
+  }
+  value.append("]}");
+  std::shared_ptr<Builder> builder = Parser::fromJson(value);
+  std::string expected = Dumper::toString(builder->slice());
+
+  for (std::size_t threshold : {0, 1, 16, 64, 1000}) {
+    int fds[2];
+    ASSERT_EQ(0, ::pipe(&fds[0]));
+    std::string result;
+    std::thread reader([&]() { result = readAll(fds[0]); });
+
+    {
+      FileDescriptorSinkOptions options;
+      options.bufferSize = 4096;
+      options.zeroCopyThreshold = threshold;
+      FileDescriptorSink s(fds[1], options);
+      BasicDumper<FileDescriptorSink>::dump(builder->slice(), &s);
+      s.flush();
+      ASSERT_EQ(expected.size(), s.written());
+    }
+    ::close(fds[1]);
+    reader.join();
+    ::close(fds[0]);
+    ASSERT_EQ(expected, result);
+  }
+}
+
+TEST(SinkTest, FileDescriptorSinkNonBlockingWithBackpressure) {
+  int fds[2];
+  ASSERT_EQ(0, ::pipe(&fds[0]));
+  ASSERT_EQ(0, ::fcntl(fds[1], F_SETFL, O_NONBLOCK));
+  std::string result;
+  std::thread reader([&]() { result = readAll(fds[0]); });
+
+  std::string expected;
+  {
+    FileDescriptorSinkOptions options;
+    options.bufferSize = 4096;
+    options.maxBuffers = 2;
+    FileDescriptorSink s(fds[1], options);
+    // the sink must wait for the reader whenever the pipe is full
+    expected = fillSink(s);
+    s.flush();
+  }
+  ::close(fds[1]);
+  reader.join();
+  ::close(fds[0]);
+  ASSERT_EQ(expected, result);
+}
+
+TEST(SinkTest, FileDescriptorSinkNonBlockingWithoutBackpressure) {
+  int fds[2];
+  ASSERT_EQ(0, ::pipe(&fds[0]));
+  ASSERT_EQ(0, ::fcntl(fds[1], F_SETFL, O_NONBLOCK));
+
+  FileDescriptorSinkOptions options;
+  options.bufferSize = 4096;
+  options.maxBuffers = 2;
+  options.backpressure = false;
+  auto s = std::make_unique<FileDescriptorSink>(fds[1], options);
+  // nobody reads yet, so the sink must buffer what does not fit into
+  // the pipe instead of waiting
+  std::string expected = fillSink(*s);
+  ASSERT_LT(s->written(), expected.size());
+
+  std::string result;
+  std::thread reader([&]() { result = readAll(fds[0]); });
+  s->flush();
+  ASSERT_EQ(expected.size(), s->written());
+  s.reset();
+  ::close(fds[1]);
+  reader.join();
+  ::close(fds[0]);
+  ASSERT_EQ(expected, result);
+}
+
+TEST(SinkTest, FileDescriptorSinkWriteError) {
+  int fd = ::open("/dev/null", O_RDONLY);
+  ASSERT_NE(-1, fd);
+  {
+    FileDescriptorSink s(fd);
+    s.append("foobar");
+    ASSERT_VELOCYPACK_EXCEPTION(s.flush(), Exception::FileError);
+  }
+  ::close(fd);
+}
+
+#endif
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -821,6 +821,59 @@ TEST(SliceTest, LengthObjectCompact) {
   ASSERT_EQ(10UL, s.length());
 }
 
+TEST(SliceTest, LengthArrayWideIndex) {
+  // Array with 8-byte index table, containing a single null value
+  uint8_t buf[] = {0x09, 0x1a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                   0x18,
+                   0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                   0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  Slice s(buf);
+
+  ASSERT_EQ(sizeof(buf), s.byteSize());
+  ASSERT_EQ(1UL, s.length());
+  ASSERT_TRUE(s.at(0).isNull());
+}
+
+TEST(SliceTest, LengthObjectWideIndex) {
+  // Object with 8-byte index table, containing {"a":null}
+  uint8_t buf[] = {0x0e, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                   0x41, 0x61, 0x18,
+                   0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                   0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  Slice s(buf);
+
+  ASSERT_EQ(sizeof(buf), s.byteSize());
+  ASSERT_EQ(1UL, s.length());
+  ASSERT_TRUE(s.get("a").isNull());
+}
+
+TEST(SliceTest, ByteSizeLengthWidths) {
+  uint8_t buf[16];
+
+  for (unsigned int h = 0xc0; h <= 0xd7; ++h) {
+    // Binary, positive BCD and negative BCD, each with 1 to 8 length bytes
+    ValueLength width = (h <= 0xc7) ? h - 0xbf : ((h <= 0xcf) ? h - 0xc7 : h - 0xcf);
+    memset(&buf[0], 0, sizeof(buf));
+    buf[0] = static_cast<uint8_t>(h);
+    buf[1] = 0x03;
+
+    ASSERT_EQ(1 + width + 3, Slice(&buf[0]).byteSize());
+  }
+}
+
+TEST(SliceTest, ByteSizeInvalidTypes) {
+  uint8_t buf[16];
+  memset(&buf[0], 0, sizeof(buf));
+
+  buf[0] = 0x16;
+  ASSERT_VELOCYPACK_EXCEPTION(Slice(&buf[0]).byteSize(), Exception::InternalError);
+
+  for (unsigned int h = 0xd8; h <= 0xed; ++h) {
+    buf[0] = static_cast<uint8_t>(h);
+    ASSERT_VELOCYPACK_EXCEPTION(Slice(&buf[0]).byteSize(), Exception::InternalError);
+  }
+}
+
 TEST(SliceTest, Null) {
   LocalBuffer[0] = 0x18;
 
@@ -3564,6 +3617,208 @@ TEST(SliceTest, ExtractTuple) {
   ASSERT_TRUE(std::get<3>(t).isString());
 }
 
+TEST(SliceTest, HashIndexedObject) {
+  Options options;
+  options.buildHashIndexedObjectsThreshold = 1;
+
+  for (std::size_t n : {2, 3, 5, 16, 100, 1000, 70000}) {
+    Builder b(&options);
+    Builder regular;
+    b.openObject();
+    regular.openObject();
+    for (std::size_t i = 0; i < n; ++i) {
+      std::string key = "test" + std::to_string(i);
+      b.add(key, Value(i));
+      regular.add(key, Value(i));
+    }
+    b.close();
+    regular.close();
+
+    Slice s = b.slice();
+    ASSERT_EQ(0x15, s.head());
+    ASSERT_TRUE(s.isObject());
+    ASSERT_EQ(n, s.length());
+
+    for (std::size_t i = 0; i < n; ++i) {
+      std::string key = "test" + std::to_string(i);
+      ASSERT_TRUE(s.hasKey(key));
+      ASSERT_EQ(i, s.get(key).getUInt());
+    }
+    ASSERT_FALSE(s.hasKey(""));
+    ASSERT_FALSE(s.hasKey("test"));
+    ASSERT_FALSE(s.hasKey("test" + std::to_string(n)));
+    ASSERT_FALSE(s.hasKey("foobar"));
+
+    // iteration order is the same as for the regular layout
+    Slice r = regular.slice();
+    for (std::size_t i = 0; i < n; ++i) {
+      ASSERT_EQ(r.keyAt(i).copyString(), s.keyAt(i).copyString());
+      ASSERT_EQ(r.valueAt(i).getUInt(), s.valueAt(i).getUInt());
+    }
+    std::size_t count = 0;
+    for (auto it : ObjectIterator(s, true)) {
+      ASSERT_EQ(it.value.getUInt(), r.get(it.key.stringView()).getUInt());
+      ++count;
+    }
+    ASSERT_EQ(n, count);
+
+    ASSERT_EQ(r.toJson(), s.toJson());
+    ASSERT_TRUE(NormalizedCompare::equals(r, s));
+    ASSERT_EQ(r.normalizedHash(), s.normalizedHash());
+  }
+}
+
+TEST(SliceTest, HashIndexedObjectFromJson) {
+  Options options;
+  options.buildHashIndexedObjectsThreshold = 4;
+
+  std::string const value(
+      "{\"foo\":1,\"bar\":{\"baz\":true},\"qux\":[1,2],\"quux\":null,\"a\":\"b\"}");
+  std::shared_ptr<Builder> b = Parser::fromJson(value, &options);
+  Slice s = b->slice();
+
+  ASSERT_EQ(0x15, s.head());
+  ASSERT_EQ(0x14, s.get("bar").head());
+  ASSERT_EQ(1, s.get("foo").getInt());
+  ASSERT_TRUE(s.get(std::vector<std::string>({"bar", "baz"})).getBool());
+  ASSERT_EQ(2U, s.get("qux").length());
+  ASSERT_TRUE(s.get("quux").isNull());
+  ASSERT_EQ("b", s.get("a").copyString());
+  ASSERT_TRUE(s.get("b").isNone());
+  ASSERT_EQ(
+      "{\"a\":\"b\",\"bar\":{\"baz\":true},\"foo\":1,\"quux\":null,\"qux\":[1,2]}",
+      s.toJson());
+}
+
+static void checkGetMany(Slice s, std::vector<std::string_view> const& keys) {
+  std::vector<Slice> expected;
+  for (auto const& key : keys) {
+    expected.push_back(s.get(key));
+  }
+
+  std::vector<Slice> out;
+  s.getMany(keys, out);
+  ASSERT_EQ(keys.size(), out.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(expected[i].start(), out[i].start());
+  }
+
+  AttributeSet set(keys);
+  ASSERT_EQ(keys.size(), set.size());
+  std::vector<Slice> prepared(set.size());
+  s.getMany(set, prepared.data());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(expected[i].start(), prepared[i].start());
+  }
+}
+
+TEST(SliceTest, GetMany) {
+  for (int layout = 0; layout < 3; ++layout) {
+    Options options;
+    options.buildUnindexedObjects = (layout == 1);
+    options.buildHashIndexedObjectsThreshold = (layout == 2 ? 1 : 0);
+
+    for (std::size_t n : {1, 2, 3, 5, 20, 100, 1000}) {
+      Builder b(&options);
+      b.openObject();
+      for (std::size_t i = 0; i < n; ++i) {
+        b.add("test" + std::to_string(i), Value(i));
+      }
+      b.close();
+      Slice s = b.slice();
+
+      checkGetMany(s, {});
+      checkGetMany(s, {"test0"});
+      checkGetMany(s, {"foo"});
+      checkGetMany(s, {"test0", "test1", "test2"});
+      checkGetMany(s, {"test2", "foo", "test0", "", "test1", "test"});
+      checkGetMany(s, {"test0", "test0", "zzz", "test0", "zzz"});
+
+      std::vector<std::string> all;
+      for (std::size_t i = 0; i < n + 10; i += 3) {
+        all.push_back("test" + std::to_string(i));
+      }
+      checkGetMany(s, std::vector<std::string_view>(all.begin(), all.end()));
+      checkGetMany(s, std::vector<std::string_view>(all.rbegin(), all.rend()));
+    }
+  }
+}
+
+TEST(SliceTest, GetManyEmptyObject) {
+  Builder b;
+  b.openObject();
+  b.close();
+
+  std::vector<Slice> out;
+  b.slice().getMany({"foo", "bar"}, out);
+  ASSERT_EQ(2U, out.size());
+  ASSERT_TRUE(out[0].isNone());
+  ASSERT_TRUE(out[1].isNone());
+}
+
+TEST(SliceTest, GetManyNonObject) {
+  Builder b;
+  b.openArray();
+  b.close();
+
+  std::vector<Slice> out;
+  ASSERT_VELOCYPACK_EXCEPTION(b.slice().getMany({"foo"}, out), Exception::InvalidValueType);
+  AttributeSet set({"foo"});
+  Slice result;
+  ASSERT_VELOCYPACK_EXCEPTION(b.slice().getMany(set, &result), Exception::InvalidValueType);
+}
+
+TEST(SliceTest, GetManyTranslations) {
+  std::unique_ptr<AttributeTranslator> translator(new AttributeTranslator);
+
+  translator->add("foo", 1);
+  translator->add("bar", 2);
+  translator->add("baz", 3);
+  translator->seal();
+
+  AttributeTranslatorScope scope(translator.get());
+
+  for (bool unindexed : {false, true}) {
+    Options options;
+    options.attributeTranslator = translator.get();
+    options.buildUnindexedObjects = unindexed;
+
+    Builder b(&options);
+    b.openObject();
+    b.add("foo", Value(1));
+    b.add("bar", Value(2));
+    b.add("qux", Value(3));
+    b.add("baz", Value(4));
+    b.add("abc", Value(5));
+    b.close();
+    Slice s = b.slice();
+
+    AttributeSet set({"qux", "foo", "abc", "baz", "bar", "xyz"});
+    Slice out[6];
+    s.getMany(set, &out[0]);
+    ASSERT_EQ(3, out[0].getInt());
+    ASSERT_EQ(1, out[1].getInt());
+    ASSERT_EQ(5, out[2].getInt());
+    ASSERT_EQ(4, out[3].getInt());
+    ASSERT_EQ(2, out[4].getInt());
+    ASSERT_TRUE(out[5].isNone());
+
+    checkGetMany(s, {"qux", "foo", "abc", "baz", "bar", "xyz"});
+  }
+
+  Options options;
+  options.attributeTranslator = translator.get();
+  Builder b(&options);
+  b.openObject();
+  b.add("foo", Value(1));
+  b.add("bar", Value(2));
+  b.close();
+
+  scope.revert();
+  std::vector<Slice> out;
+  ASSERT_VELOCYPACK_EXCEPTION(b.slice().getMany({"foo", "bar"}, out), Exception::NeedAttributeTranslator);
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
 
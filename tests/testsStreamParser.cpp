@@ -0,0 +1,318 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Library to build up VPack documents.
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Max Neunhoeffer
+/// @author Jan Steemann
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ostream>
+#include <string>
+
+#include "tests-common.h"
+
+// parses the value with the regular parser, and with the stream parser
+// in all possible splits into two chunks as well as byte by byte, and
+// checks that the results are identical
+static void checkStream(std::string const& value, bool multi = false,
+                        Options const* options = &Options::Defaults) {
+  Parser parser(options);
+  bool failed = false;
+  int code = 0;
+  try {
+    parser.parse(value, multi);
+  } catch (Exception const& ex) {
+    failed = true;
+    code = ex.errorCode();
+  }
+
+  auto check = [&](std::vector<std::size_t> const& splits) {
+    StreamParser streamParser(options, multi);
+    bool streamFailed = false;
+    int streamCode = 0;
+    ValueLength count = 0;
+    try {
+      std::size_t last = 0;
+      for (auto split : splits) {
+        streamParser.feed(value.data() + last, split - last);
+        last = split;
+      }
+      streamParser.feed(value.data() + last, value.size() - last);
+      count = streamParser.finish();
+    } catch (Exception const& ex) {
+      streamFailed = true;
+      streamCode = ex.errorCode();
+    }
+
+    ASSERT_EQ(failed, streamFailed) << value;
+    if (failed) {
+      ASSERT_EQ(code, streamCode) << value;
+    } else {
+      Buffer<uint8_t> const& a = parser.builder().bufferRef();
+      Buffer<uint8_t> const& b = streamParser.builder().bufferRef();
+      ASSERT_EQ(a.size(), b.size()) << value;
+      ASSERT_EQ(0, memcmp(a.data(), b.data(), a.size())) << value;
+      ASSERT_TRUE(count > 0);
+    }
+  };
+
+  check({});
+  for (std::size_t i = 0; i <= value.size(); ++i) {
+    check({i});
+  }
+  std::vector<std::size_t> bytes;
+  for (std::size_t i = 1; i < value.size(); ++i) {
+    bytes.push_back(i);
+  }
+  check(bytes);
+}
+
+TEST(StreamParserTest, CreateWithoutOptions) {
+  ASSERT_VELOCYPACK_EXCEPTION(new StreamParser(nullptr), Exception::InternalError);
+}
+
+TEST(StreamParserTest, Scalars) {
+  for (auto const& value : { "null", "true", "false", "0", "-0", "1", "-1",
+                             "12345678901234567890", "123456789012345678901",
+                             "-9223372036854775808", "1.5", "-1.5e10",
+                             "1E-3", "0.000001", "1e308", "\"\"", "\"abc\"",
+                             " \t\r\n 17 \t\r\n ", "4.678900", "4.678900 ",
+                             "\xef\xbb\xbf" "42" }) {
+    checkStream(value);
+  }
+}
+
+TEST(StreamParserTest, Compound) {
+  for (auto const& value : { "[]", "{}", "[[]]", "[{}]", "[1,2,3]",
+                             " [ 1 , \"2\" , 3 ] ", "[[1,[2,[3]]],{}]",
+                             "{\"a\":1,\"b\":[true,false,null],\"c\":{\"d\":\"e\"}}",
+                             "{ \"a\" : { \"b\" : { \"c\" : [ ] } } }",
+                             "{\"a\\\"b\":\"c\\\\\",\"d\":\"{[,:]}\"}",
+                             "[\"\\\\\\\\\\\"\",\"\\\\\"]" }) {
+    checkStream(value);
+  }
+}
+
+TEST(StreamParserTest, Escapes) {
+  for (auto const& value : { "\"\\b\\f\\n\\r\\t\\/\\\\\\\"\"",
+                             "\"\\u0041\\u00e4\\u20AC\"",
+                             "\"\\ud83d\\ude00\"", "\"x\\ud83d\\ude00y\"",
+                             "\"\\udc00\"", "[\"a\\u0000b\"]" }) {
+    checkStream(value);
+  }
+}
+
+TEST(StreamParserTest, LongStrings) {
+  // string lengths around the short/long string boundary, with
+  // escape sequences right at the boundary
+  for (std::size_t length = 100; length < 160; ++length) {
+    std::string plain(length, 'x');
+    checkStream("\"" + plain + "\"");
+    checkStream("[\"" + plain + "\\n\"]");
+    checkStream("{\"" + plain + "\\u20ac\":\"" + plain + "\"}");
+  }
+}
+
+TEST(StreamParserTest, LongNumbers) {
+  // mantissas with more digits than fit into 64 bits
+  for (auto const& value : {
+           "18446744073709551615", "18446744073709551616",
+           "-9223372036854775809", "1844674407370955161500",
+           "0.30000000000000000000000000001",
+           "9007199254740993.0000000000000000001",
+           "2.4703282292062327208828439643411068618e-324",
+           "-123456789012345678901234567890e-10", "1e-99999999999",
+           "[1.00000000000000011102230246251565404236316680908203126]" }) {
+    checkStream(value);
+  }
+}
+
+TEST(StreamParserTest, Errors) {
+  for (auto const& value : { "", " ", "z", "[", "]", "{", "}", "[1", "[1,",
+                             "[1,]", "[,]", "[1 2]", "{\"a\"", "{\"a\":",
+                             "{\"a\":1", "{\"a\":1,", "{\"a\":1,}", "{1:2}",
+                             "{\"a\" 1}", "\"abc", "\"\\", "\"\\x\"",
+                             "\"\\u12\"", "\"\\u12", "\"\\u12g4\"", "tru",
+                             "trUe", "nul", "fals", "truex", "1 2", "[1]]",
+                             "-", "1.", "1e", "1.5e+", "--1", "[1-2]",
+                             "\"a\x01\"", "\xef\xbb", "\xef\xbb\xbe",
+                             "1e999", "[1e999]" }) {
+    checkStream(value);
+  }
+}
+
+TEST(StreamParserTest, Multi) {
+  for (auto const& value : { "1 2 3", "[1] {\"a\":2}\n\"b\" null",
+                             "{\"a\":1}\n{\"b\":2}\n", "12 34", "1 [", "",
+                             "true false", "1 2 x", "5-09", "01", "-0-0",
+                             "1.5e3e4", "1.5.5" }) {
+    checkStream(value, true);
+  }
+}
+
+TEST(StreamParserTest, Utf8Check) {
+  Options options;
+  options.validateUtf8Strings = true;
+  for (auto const& value : { "\"\xc3\xa4\"", "\"\xe2\x82\xac\"",
+                             "\"\xf0\x9f\x98\x80\"", "\"\xc3\"", "\"\xc3",
+                             "\"\x80\"", "\"\xe2\x28\xa1\"",
+                             "[\"0123456789abcdef\xe2\x82\xac" "0123456789abcdef\"]" }) {
+    checkStream(value, false, &options);
+  }
+}
+
+TEST(StreamParserTest, KeepTopLevelOpen) {
+  Options options;
+  options.keepTopLevelOpen = true;
+  for (auto const& value : { "{}", "{\"a\":{}}", "{\"a\":[{\"b\":1}]}" }) {
+    checkStream(value, false, &options);
+  }
+}
+
+TEST(StreamParserTest, AttributeTranslator) {
+  std::unique_ptr<AttributeTranslator> translator(new AttributeTranslator);
+
+  translator->add("foo", 1);
+  translator->add("bar", 2);
+  translator->seal();
+
+  Options options;
+  options.attributeTranslator = translator.get();
+
+  checkStream("{\"foo\":1,\"bar\":{\"foo\":\"bar\"},\"baz\":3}", false,
+              &options);
+}
+
+TEST(StreamParserTest, ErrorPos) {
+  StreamParser parser;
+  parser.feed("[1,2,");
+  try {
+    parser.feed("3,x]");
+    ASSERT_TRUE(false);
+  } catch (Exception const& ex) {
+    ASSERT_EQ(Exception::ParseError, ex.errorCode());
+    ASSERT_STREQ("Expecting digit", ex.what());
+  }
+  ASSERT_EQ(7U, parser.errorPos());
+
+  parser.reset();
+  parser.feed("{\"a\":");
+  parser.feed(" 1");
+  ASSERT_VELOCYPACK_EXCEPTION(parser.finish(), Exception::ParseError);
+  ASSERT_EQ(6U, parser.errorPos());
+
+  parser.reset();
+  parser.feed("[1.");
+  ASSERT_VELOCYPACK_EXCEPTION(parser.feed("e5]"), Exception::ParseError);
+  ASSERT_EQ(3U, parser.errorPos());
+
+  parser.reset();
+  parser.feed("[-");
+  ASSERT_VELOCYPACK_EXCEPTION(parser.finish(), Exception::ParseError);
+  ASSERT_EQ(1U, parser.errorPos());
+
+  parser.reset();
+  parser.feed("[12");
+  ASSERT_VELOCYPACK_EXCEPTION(parser.feed("e999]"), Exception::NumberOutOfRange);
+  ASSERT_EQ(6U, parser.errorPos());
+}
+
+TEST(StreamParserTest, NumbersAcrossChunks) {
+  StreamParser parser;
+  parser.feed("[12");
+  parser.feed("34");
+  parser.feed(".5");
+  parser.feed("e");
+  parser.feed("-2,-");
+  parser.feed("7]");
+  ASSERT_EQ(1U, parser.finish());
+
+  Slice s(parser.builder().slice());
+  ASSERT_TRUE(s.isArray());
+  ASSERT_EQ(2U, s.length());
+  ASSERT_DOUBLE_EQ(12.345, s.at(0).getDouble());
+  ASSERT_EQ(-7, s.at(1).getInt());
+}
+
+TEST(StreamParserTest, TopLevelNumberNeedsFinish) {
+  StreamParser parser;
+  parser.feed("123");
+  // the number might continue in the next chunk
+  ASSERT_TRUE(parser.builder().isEmpty());
+  ASSERT_EQ(1U, parser.finish());
+  ASSERT_EQ(123U, parser.builder().slice().getUInt());
+}
+
+TEST(StreamParserTest, AppendToOpenArray) {
+  Options options;
+  options.clearBuilderBeforeParse = false;
+
+  Builder builder;
+  builder.openArray();
+  builder.add(Value(1));
+
+  StreamParser parser(builder, &options, true);
+  parser.feed("{\"a\":");
+  parser.feed("2} [3");
+  parser.feed("] \"fo");
+  parser.feed("o\"");
+  ASSERT_EQ(3U, parser.finish());
+
+  builder.add(Value(4));
+  builder.close();
+
+  Slice s(builder.slice());
+  ASSERT_EQ(5U, s.length());
+  ASSERT_EQ(1U, s.at(0).getUInt());
+  ASSERT_EQ(2U, s.at(1).get("a").getUInt());
+  ASSERT_EQ(3U, s.at(2).at(0).getUInt());
+  ASSERT_EQ("foo", s.at(3).copyString());
+  ASSERT_EQ(4U, s.at(4).getUInt());
+}
+
+TEST(StreamParserTest, Reuse) {
+  StreamParser parser;
+  parser.feed("[1,2");
+  parser.feed("]");
+  ASSERT_EQ(1U, parser.finish());
+  ASSERT_EQ(2U, parser.builder().slice().length());
+
+  parser.reset();
+  parser.feed("\"abc\"");
+  ASSERT_EQ(1U, parser.finish());
+  ASSERT_EQ("abc", parser.builder().slice().copyString());
+}
+
+TEST(StreamParserTest, Steal) {
+  StreamParser parser;
+  parser.feed("{\"a\":\"b\"}");
+  parser.finish();
+
+  std::shared_ptr<Builder> builder = parser.steal();
+  ASSERT_EQ("b", builder->slice().get("a").copyString());
+  ASSERT_VELOCYPACK_EXCEPTION(parser.feed("1"), Exception::InternalError);
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
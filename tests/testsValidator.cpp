@@ -34,7 +34,7 @@ TEST(ValidatorTest, NoOptions) {
 }
 
 TEST(ValidatorTest, ReservedValue1) {
-  std::string const value("\x15", 1);
+  std::string const value("\xed", 1);
 
   Validator validator;
   ASSERT_VELOCYPACK_EXCEPTION(validator.validate(value.c_str(), value.size()), Exception::ValidatorInvalidType);
@@ -2380,6 +2380,255 @@ TEST(ValidatorTest, ObjectFourByteManyEntries) {
   ASSERT_TRUE(validator.validate(b.slice().start(), b.slice().byteSize()));
 }
 
+TEST(ValidatorTest, HashIndexedObject) {
+  Options options;
+  options.buildHashIndexedObjectsThreshold = 1;
+
+  for (std::size_t n : {2, 10, 1000}) {
+    Builder b(&options);
+    b.openObject();
+    for (std::size_t i = 0; i < n; ++i) {
+      b.add("test" + std::to_string(i), Value(i));
+    }
+    b.close();
+
+    ASSERT_EQ(0x15, b.slice().head());
+
+    Validator validator;
+    ASSERT_TRUE(validator.validate(b.slice().start(), b.slice().byteSize()));
+  }
+}
+
+TEST(ValidatorTest, HashIndexedObjectTooShort) {
+  std::string const value("\x15\x0a\x00\x00\x00\x01\x00\x00\x00", 9);
+
+  Validator validator;
+  ASSERT_VELOCYPACK_EXCEPTION(validator.validate(value.c_str(), value.size()), Exception::ValidatorInvalidLength);
+}
+
+TEST(ValidatorTest, HashIndexedObjectCorrupted) {
+  Options options;
+  options.buildHashIndexedObjectsThreshold = 1;
+
+  Builder b(&options);
+  b.openObject();
+  for (std::size_t i = 0; i < 10; ++i) {
+    b.add("test" + std::to_string(i), Value(i));
+  }
+  b.close();
+
+  std::string const original(b.slice().startAs<char>(), b.slice().byteSize());
+  // 10 members need 16 hash table slots
+  std::size_t const hashTable = original.size() - 4 * 10 - 4 * 16;
+  Validator validator;
+
+  auto check = [&](auto&& modify) {
+    std::string value = original;
+    modify(value);
+    ASSERT_VELOCYPACK_EXCEPTION(validator.validate(value.c_str(), value.size()), Exception::ValidatorInvalidLength);
+  };
+
+  // wrong number of members
+  check([](std::string& value) { value[5] = 11; });
+  // index table pointing into a member
+  check([](std::string& value) { value[value.size() - 4] += 1; });
+  // index table pointing to the same member twice
+  check([](std::string& value) { value[value.size() - 4] = value[value.size() - 8]; });
+
+  // find an occupied slot, and the slot after it
+  std::size_t slot = 0;
+  while (original[hashTable + 4 * slot] == 0) {
+    ++slot;
+  }
+  std::size_t const next = (slot + 1) % 16;
+
+  // removed entry
+  check([&](std::string& value) {
+    std::memset(&value[hashTable + 4 * slot], 0, 4);
+  });
+  // entry pointing outside of the index table
+  check([&](std::string& value) { value[hashTable + 4 * slot] = 11; });
+  // wrong fingerprint
+  check([&](std::string& value) { value[hashTable + 4 * slot + 3] ^= 0x01; });
+  // duplicate entry
+  check([&](std::string& value) {
+    std::memcpy(&value[hashTable + 4 * next], &value[hashTable + 4 * slot], 4);
+  });
+  // entry moved away from its home slot, so it cannot be found anymore
+  if (original[hashTable + 4 * next] == 0 &&
+      original[hashTable + 4 * ((slot + 2) % 16)] == 0) {
+    check([&](std::string& value) {
+      std::memcpy(&value[hashTable + 4 * ((slot + 2) % 16)], &value[hashTable + 4 * slot], 4);
+      std::memset(&value[hashTable + 4 * slot], 0, 4);
+    });
+  }
+}
+
+TEST(ValidatorTest, NestingTooDeep) {
+  auto nested = [](std::size_t depth) {
+    Builder b;
+    for (std::size_t i = 0; i < depth; ++i) {
+      if (i % 2 == 0) {
+        b.openArray();
+      } else {
+        b.openObject();
+        if (i + 1 < depth) {
+          b.add(Value("a"));
+        }
+      }
+    }
+    for (std::size_t i = 0; i < depth; ++i) {
+      b.close();
+    }
+    return std::string(b.slice().startAs<char>(), b.slice().byteSize());
+  };
+
+  Options options;
+  ASSERT_EQ(1000U, options.maxValidationDepth);
+  std::string value = nested(1000);
+  ASSERT_TRUE(Validator(&options).validate(value.c_str(), value.size()));
+  value = nested(1001);
+  ASSERT_VELOCYPACK_EXCEPTION(Validator(&options).validate(value.c_str(), value.size()), Exception::ValidatorNestingTooDeep);
+
+  options.maxValidationDepth = 3;
+  Validator validator(&options);
+
+  value = nested(4);
+  ASSERT_VELOCYPACK_EXCEPTION(validator.validate(value.c_str(), value.size()), Exception::ValidatorNestingTooDeep);
+  // the validator can still be used after a failure
+  value = nested(3);
+  ASSERT_TRUE(validator.validate(value.c_str(), value.size()));
+
+  value = nested(5000);
+  options.maxValidationDepth = 1000;
+  ASSERT_VELOCYPACK_EXCEPTION(validator.validate(value.c_str(), value.size()), Exception::ValidatorNestingTooDeep);
+  options.maxValidationDepth = 0;
+  ASSERT_TRUE(validator.validate(value.c_str(), value.size()));
+}
+
+static std::string buildBigCompound(Options const& options, bool object,
+                                    bool sameSize = false) {
+  // more than Validator::minParallelSize bytes, with nested values
+  Builder b(&options);
+  if (object) {
+    b.openObject();
+  } else {
+    b.openArray();
+  }
+  for (std::size_t i = 0; i < 20000; ++i) {
+    std::string value = (i == 12345) ? "corrupt-me00" : "value-" + std::to_string(100000 + i);
+    if (object) {
+      b.add(Value("key" + std::to_string(100000 + i)));
+    }
+    b.openObject();
+    b.add("name", Value(value + std::string(40, 'x')));
+    b.add("values", Value(ValueType::Array));
+    b.add(Value(sameSize ? i + 1000 : i));
+    b.add(Value(true));
+    b.close();
+    b.close();
+  }
+  b.close();
+  std::string result(b.slice().startAs<char>(), b.slice().byteSize());
+  EXPECT_LE(Validator::minParallelSize, result.size());
+  return result;
+}
+
+static void corruptMember(std::string& value) {
+  std::size_t pos = value.find("corrupt-me00");
+  ASSERT_NE(std::string::npos, pos);
+  ASSERT_EQ(0x40 + 52, static_cast<uint8_t>(value[pos - 1]));
+  // reserved type
+  value[pos - 1] = '\x16';
+}
+
+TEST(ValidatorTest, ParallelArrays) {
+  for (bool unindexed : {false, true}) {
+    // Arrays with members of the same size have no index table
+    std::string value = buildBigCompound(Options::Defaults, false, unindexed);
+    ASSERT_EQ(unindexed ? 0x04 : 0x08, static_cast<uint8_t>(value[0]));
+
+    Validator validator(&Options::Defaults, 4);
+    ASSERT_TRUE(validator.validate(value.c_str(), value.size()));
+
+    std::string corrupted = value;
+    corruptMember(corrupted);
+    ASSERT_VELOCYPACK_EXCEPTION(validator.validate(corrupted.c_str(), corrupted.size()), Exception::ValidatorInvalidType);
+
+    if (!unindexed) {
+      // swap two index table entries
+      corrupted = value;
+      std::size_t const indexTable = corrupted.size() - 4 * 20000;
+      std::swap_ranges(corrupted.begin() + indexTable, corrupted.begin() + indexTable + 4,
+                       corrupted.begin() + indexTable + 400);
+      ASSERT_VELOCYPACK_EXCEPTION(validator.validate(corrupted.c_str(), corrupted.size()), Exception::ValidatorInvalidLength);
+    }
+  }
+}
+
+TEST(ValidatorTest, ParallelObjects) {
+  for (bool hashed : {false, true}) {
+    Options options;
+    options.buildHashIndexedObjectsThreshold = hashed ? 1 : 0;
+    std::string value = buildBigCompound(options, true);
+    ASSERT_EQ(hashed ? 0x15 : 0x0d, static_cast<uint8_t>(value[0]));
+
+    Validator validator(&Options::Defaults, 4);
+    ASSERT_TRUE(validator.validate(value.c_str(), value.size()));
+
+    std::string corrupted = value;
+    corruptMember(corrupted);
+    ASSERT_VELOCYPACK_EXCEPTION(validator.validate(corrupted.c_str(), corrupted.size()), Exception::ValidatorInvalidType);
+
+    // let two index table entries point to the same member
+    corrupted = value;
+    std::size_t const indexTable = corrupted.size() - 4 * 20000;
+    std::copy(corrupted.begin() + indexTable, corrupted.begin() + indexTable + 4,
+              corrupted.begin() + indexTable + 400);
+    ASSERT_VELOCYPACK_EXCEPTION(validator.validate(corrupted.c_str(), corrupted.size()), Exception::ValidatorInvalidLength);
+  }
+}
+
+TEST(ValidatorTest, ParallelNestingTooDeep) {
+  Options options;
+  options.maxValidationDepth = 3;
+  std::string value = buildBigCompound(Options::Defaults, false);
+
+  Validator validator(&options, 4);
+  ASSERT_TRUE(validator.validate(value.c_str(), value.size()));
+  options.maxValidationDepth = 2;
+  ASSERT_VELOCYPACK_EXCEPTION(validator.validate(value.c_str(), value.size()), Exception::ValidatorNestingTooDeep);
+}
+
+TEST(ValidatorTest, ValidateMany) {
+  std::string value;
+  for (std::size_t i = 0; i < 100; ++i) {
+    Builder b;
+    b.openObject();
+    b.add("value", Value(std::string(i * 100, 'x')));
+    b.close();
+    value.append(b.slice().startAs<char>(), b.slice().byteSize());
+    b.clear();
+    b.add(Value(i));
+    value.append(b.slice().startAs<char>(), b.slice().byteSize());
+  }
+  std::string const big = buildBigCompound(Options::Defaults, false);
+  value.append(big);
+
+  for (std::size_t concurrency : {1, 4}) {
+    Validator validator(&Options::Defaults, concurrency);
+    ASSERT_EQ(0U, validator.validateMany(value.c_str(), 0));
+    ASSERT_EQ(201U, validator.validateMany(value.c_str(), value.size()));
+
+    // truncated last value
+    ASSERT_VELOCYPACK_EXCEPTION(validator.validateMany(value.c_str(), value.size() - 1), Exception::ValidatorInvalidLength);
+
+    std::string corrupted = value;
+    corruptMember(corrupted);
+    ASSERT_VELOCYPACK_EXCEPTION(validator.validateMany(corrupted.c_str(), corrupted.size()), Exception::ValidatorInvalidType);
+  }
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
 
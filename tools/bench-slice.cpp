@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Library to build up VPack documents.
+///
+/// DISCLAIMER
+///
+/// Copyright 2020 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Jan Steemann
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "velocypack/vpack.h"
+
+using namespace arangodb::velocypack;
+
+static void usage(char* argv[]) {
+  std::cout << "Usage: " << argv[0]
+            << " FILENAME.json RUNTIME_IN_SECONDS TYPE [compact]" << std::endl;
+  std::cout << "This program converts the file into VPack once and then runs"
+            << std::endl;
+  std::cout << "the Slice operation TYPE over all of its values repeatedly."
+            << std::endl;
+  std::cout << "TYPE must be one of 'byte-size', 'length' or 'iterate'."
+            << std::endl;
+  std::cout << "If 'compact' is given, Arrays and Objects are built without"
+            << std::endl;
+  std::cout << "index tables." << std::endl;
+}
+
+static std::string tryReadFile(std::string const& filename) {
+  std::string s;
+  std::ifstream ifs(filename.c_str(), std::ifstream::in);
+
+  if (!ifs.is_open()) {
+    throw "cannot open input file";
+  }
+
+  char buffer[4096];
+  while (ifs.good()) {
+    ifs.read(&buffer[0], sizeof(buffer));
+    s.append(buffer, ifs.gcount());
+  }
+  ifs.close();
+
+  return s;
+}
+
+static std::string readFile(std::string filename) {
+#ifdef _WIN32
+  std::string const separator("\\");
+#else
+  std::string const separator("/");
+#endif
+  try {
+    return tryReadFile(filename);
+  } catch (...) {
+  }
+
+  filename = "tests" + separator + "jsonSample" + separator + filename;
+  for (size_t i = 0; i < 3; ++i) {
+    try {
+      return tryReadFile(filename);
+    } catch (...) {
+      filename = ".." + separator + filename;
+    }
+  }
+  std::cerr << "Cannot open input file '" << filename << "'" << std::endl;
+  ::exit(EXIT_FAILURE);
+}
+
+// collects the start of all values contained in slice, including
+// Object keys, in document order
+static void collect(Slice slice, std::vector<uint8_t const*>& values,
+                    std::vector<uint8_t const*>& compounds) {
+  values.push_back(slice.start());
+  if (slice.isArray()) {
+    compounds.push_back(slice.start());
+    for (auto it : ArrayIterator(slice)) {
+      collect(it, values, compounds);
+    }
+  } else if (slice.isObject()) {
+    compounds.push_back(slice.start());
+    for (auto it : ObjectIterator(slice)) {
+      values.push_back(it.key.start());
+      collect(it.value, values, compounds);
+    }
+  }
+}
+
+// visits all values contained in slice using the iterators
+static uint64_t iterate(Slice slice) {
+  uint64_t count = 1;
+  if (slice.isArray()) {
+    for (auto it : ArrayIterator(slice)) {
+      count += iterate(it);
+    }
+  } else if (slice.isObject()) {
+    for (auto it : ObjectIterator(slice)) {
+      count += iterate(it.value);
+    }
+  }
+  return count;
+}
+
+enum class BenchType { ByteSize, Length, Iterate };
+
+static void run(Slice slice, int runTime, BenchType type) {
+  std::vector<uint8_t const*> values;
+  std::vector<uint8_t const*> compounds;
+  collect(slice, values, compounds);
+
+  uint64_t total = 0;
+  uint64_t checksum = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  decltype(start) now;
+
+  do {
+    switch (type) {
+      case BenchType::ByteSize: {
+        for (auto const* p : values) {
+          checksum += Slice(p).byteSize();
+        }
+        total += values.size();
+        break;
+      }
+      case BenchType::Length: {
+        for (auto const* p : compounds) {
+          checksum += Slice(p).length();
+        }
+        total += compounds.size();
+        break;
+      }
+      case BenchType::Iterate: {
+        total += iterate(slice);
+        break;
+      }
+    }
+    now = std::chrono::high_resolution_clock::now();
+  } while (std::chrono::duration_cast<std::chrono::duration<int>>(now - start)
+               .count() < runTime);
+
+  std::chrono::duration<double> totalTime =
+      std::chrono::duration_cast<std::chrono::duration<double>>(now - start);
+
+  std::cout << "Visited " << total << " values in " << totalTime.count()
+            << " s. This is " << (totalTime.count() * 1.0e9) / total
+            << " ns per value (checksum " << checksum << ")." << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc != 4 && argc != 5) {
+    usage(argv);
+    return EXIT_FAILURE;
+  }
+
+  BenchType type;
+  if (::strcmp(argv[3], "byte-size") == 0) {
+    type = BenchType::ByteSize;
+  } else if (::strcmp(argv[3], "length") == 0) {
+    type = BenchType::Length;
+  } else if (::strcmp(argv[3], "iterate") == 0) {
+    type = BenchType::Iterate;
+  } else {
+    usage(argv);
+    return EXIT_FAILURE;
+  }
+
+  Options options;
+  if (argc == 5) {
+    if (::strcmp(argv[4], "compact") != 0) {
+      usage(argv);
+      return EXIT_FAILURE;
+    }
+    options.buildUnindexedArrays = true;
+    options.buildUnindexedObjects = true;
+  }
+
+  int runTime = std::stoi(argv[2]);
+
+  try {
+    std::string s = readFile(argv[1]);
+    std::shared_ptr<Builder> b = Parser::fromJson(s, &options);
+    run(b->slice(), runTime, type);
+  } catch (Exception const& ex) {
+    std::cerr << "An exception occurred while running bench: " << ex.what()
+              << std::endl;
+    return EXIT_FAILURE;
+  } catch (std::exception const& ex) {
+    std::cerr << "An exception occurred while running bench: " << ex.what()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -29,6 +29,9 @@
 #include <vector>
 #include <fstream>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
 #include <thread>
 
 #include "velocypack/vpack.h"
@@ -39,6 +42,16 @@
 
 using namespace arangodb::velocypack;
 
+// forward for double formatting functions declared elsewhere
+namespace arangodb {
+namespace velocypack {
+int fpconv_dtoa(double fp, char dest[24]);
+std::size_t doubleToString(double v, char* dest, int significantDigits);
+void enableNativeStringFunctions();
+void enableBuiltinStringFunctions();
+}
+}
+
 static void usage(char* argv[]) {
   std::cout << "Usage: " << argv[0]
             << " FILENAME.json RUNTIME_IN_SECONDS COPIES TYPE" << std::endl;
@@ -51,7 +64,41 @@ static void usage(char* argv[]) {
   std::cout << "out of cache. The target areas are also in a different memory"
             << std::endl;
   std::cout << "area for each copy." << std::endl;
-  std::cout << "TYPE must be either 'vpack' or 'rapidjson'." << std::endl;
+  std::cout << "TYPE must be either 'vpack', 'vpack-indexed' or 'rapidjson'."
+            << std::endl;
+  std::cout << std::endl;
+  std::cout << "Usage: " << argv[0]
+            << " FILENAME.json|random RUNTIME_IN_SECONDS DIGITS DTOA" << std::endl;
+  std::cout << "This program collects all doubles from the file (or 1M doubles"
+            << std::endl;
+  std::cout << "with random bit patterns) and converts them to strings."
+            << std::endl;
+  std::cout << "DTOA must be either 'fpconv' or 'dtoa'. DIGITS is the number of"
+            << std::endl;
+  std::cout << "significant digits for 'dtoa', 0 means shortest round-trip."
+            << std::endl;
+  std::cout << std::endl;
+  std::cout << "Usage: " << argv[0]
+            << " FILENAME.json RUNTIME_IN_SECONDS THREADS VALIDATE" << std::endl;
+  std::cout << "This program converts the file to VPack, repeats it until it"
+            << std::endl;
+  std::cout << "has 256 MB and validates the result on THREADS threads."
+            << std::endl;
+  std::cout << "VALIDATE must be either 'validate', which validates a single"
+            << std::endl;
+  std::cout << "Array of the copies, or 'validate-many', which validates the"
+            << std::endl;
+  std::cout << "concatenated copies with validateMany()." << std::endl;
+  std::cout << std::endl;
+  std::cout << "Usage: " << argv[0]
+            << " FILENAME.json RUNTIME_IN_SECONDS 0 ESCAPE" << std::endl;
+  std::cout << "This program collects all strings and attribute names from the"
+            << std::endl;
+  std::cout << "file and dumps them to JSON, which escapes them." << std::endl;
+  std::cout << "ESCAPE must be either 'escape', which uses the string functions"
+            << std::endl;
+  std::cout << "for the CPU, or 'escape-builtin', which uses the portable ones."
+            << std::endl;
 }
 
 static std::string tryReadFile(std::string const& filename) {
@@ -92,8 +139,9 @@ static std::string readFile(std::string filename) {
 }
 
 static void run(std::string& data, int runTime, size_t copies, bool useVPack,
-                bool fullOutput) {
+                bool useStructuralIndex, bool fullOutput) {
   Options options;
+  options.useStructuralIndex = useStructuralIndex;
 
   std::vector<std::string> inputs;
   std::vector<Parser*> outputs;
@@ -139,7 +187,9 @@ static void run(std::string& data, int runTime, size_t copies, bool useVPack,
     if (fullOutput) {
       std::cout << "Total runtime: " << totalTime.count() << " s" << std::endl;
       std::cout << "Have parsed " << total << " times with "
-                << (useVPack ? "vpack" : "rapidjson") << " using " << copies
+                << (useVPack ? (useStructuralIndex ? "vpack-indexed" : "vpack")
+                             : "rapidjson")
+                << " using " << copies
                 << " copies of JSON data, each of size " << inputs[0].size()
                 << "." << std::endl;
       std::cout << "Parsed " << inputs[0].size() * total << " bytes in total."
@@ -169,6 +219,180 @@ static void run(std::string& data, int runTime, size_t copies, bool useVPack,
   }
 }
 
+// collects all doubles contained in slice
+static void collectDoubles(Slice slice, std::vector<double>& values) {
+  if (slice.isDouble()) {
+    values.push_back(slice.getDouble());
+  } else if (slice.isArray()) {
+    for (auto it : ArrayIterator(slice)) {
+      collectDoubles(it, values);
+    }
+  } else if (slice.isObject()) {
+    for (auto it : ObjectIterator(slice)) {
+      collectDoubles(it.value, values);
+    }
+  }
+}
+
+static std::vector<double> readDoubles(std::string const& filename) {
+  std::vector<double> values;
+  if (filename == "random") {
+    // uniformly distributed bit patterns, which mostly produce 17 digits
+    std::mt19937_64 rng(42);
+    while (values.size() < 1000000) {
+      uint64_t bits = rng();
+      double v;
+      memcpy(&v, &bits, sizeof(v));
+      if (std::isfinite(v)) {
+        values.push_back(v);
+      }
+    }
+    return values;
+  }
+
+  std::string data = readFile(filename);
+  std::shared_ptr<Builder> b = Parser::fromJson(data);
+  collectDoubles(b->slice(), values);
+  if (values.empty()) {
+    std::cerr << "No doubles found in input file '" << filename << "'"
+              << std::endl;
+    ::exit(EXIT_FAILURE);
+  }
+  return values;
+}
+
+static void runDtoa(std::vector<double> const& values, int runTime,
+                    bool useFpconv, int digits) {
+  char buffer[32];
+  uint64_t total = 0;
+  uint64_t length = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  decltype(start) now;
+
+  do {
+    if (useFpconv) {
+      for (double v : values) {
+        length += fpconv_dtoa(v, &buffer[0]);
+      }
+    } else {
+      for (double v : values) {
+        length += doubleToString(v, &buffer[0], digits);
+      }
+    }
+    total += values.size();
+    now = std::chrono::high_resolution_clock::now();
+  } while (std::chrono::duration_cast<std::chrono::duration<int>>(now - start)
+               .count() < runTime);
+
+  std::chrono::duration<double> totalTime =
+      std::chrono::duration_cast<std::chrono::duration<double>>(now - start);
+
+  std::cout << "Converted " << total << " doubles in " << totalTime.count()
+            << " s. This is " << (totalTime.count() * 1.0e9) / total
+            << " ns per double, " << static_cast<double>(length) / total
+            << " characters on average." << std::endl;
+}
+
+static void runValidate(std::string const& data, int runTime,
+                        std::size_t threads, bool many) {
+  std::shared_ptr<Builder> parsed = Parser::fromJson(data);
+  Slice value = parsed->slice();
+  std::size_t const targetSize = 256 * 1024 * 1024;
+
+  Builder array;
+  std::string concatenated;
+  if (many) {
+    while (concatenated.size() < targetSize) {
+      concatenated.append(value.startAs<char>(), value.byteSize());
+    }
+  } else {
+    array.openArray();
+    while (array.bufferRef().size() < targetSize) {
+      array.add(value);
+    }
+    array.close();
+  }
+  uint8_t const* start =
+      many ? reinterpret_cast<uint8_t const*>(concatenated.data()) : array.start();
+  std::size_t const size = many ? concatenated.size() : array.size();
+
+  Validator validator(&Options::Defaults, threads);
+  uint64_t total = 0;
+  auto begin = std::chrono::high_resolution_clock::now();
+  decltype(begin) now;
+
+  do {
+    if (many) {
+      validator.validateMany(start, size);
+    } else {
+      validator.validate(start, size);
+    }
+    total += size;
+    now = std::chrono::high_resolution_clock::now();
+  } while (std::chrono::duration_cast<std::chrono::duration<int>>(now - begin)
+               .count() < runTime);
+
+  std::chrono::duration<double> totalTime =
+      std::chrono::duration_cast<std::chrono::duration<double>>(now - begin);
+
+  std::cout << "Validated " << total << " bytes on " << threads
+            << " thread(s) in " << totalTime.count() << " s. This is "
+            << total / totalTime.count() / (1024.0 * 1024.0) << " MB/s."
+            << std::endl;
+}
+
+// collects all strings and attribute names contained in slice
+static void collectStrings(Slice slice, Builder& strings) {
+  if (slice.isString()) {
+    strings.add(slice);
+  } else if (slice.isArray()) {
+    for (auto it : ArrayIterator(slice)) {
+      collectStrings(it, strings);
+    }
+  } else if (slice.isObject()) {
+    for (auto it : ObjectIterator(slice)) {
+      collectStrings(it.key, strings);
+      collectStrings(it.value, strings);
+    }
+  }
+}
+
+static void runEscape(std::string const& data, int runTime, bool native) {
+  std::shared_ptr<Builder> parsed = Parser::fromJson(data);
+  Builder strings;
+  strings.openArray();
+  collectStrings(parsed->slice(), strings);
+  strings.close();
+
+  if (native) {
+    enableNativeStringFunctions();
+  } else {
+    enableBuiltinStringFunctions();
+  }
+
+  std::string out;
+  uint64_t total = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  decltype(start) now;
+
+  do {
+    out.clear();
+    StringSink sink(&out);
+    BasicDumper<StringSink>::dump(strings.slice(), &sink);
+    total += out.size();
+    now = std::chrono::high_resolution_clock::now();
+  } while (std::chrono::duration_cast<std::chrono::duration<int>>(now - start)
+               .count() < runTime);
+
+  std::chrono::duration<double> totalTime =
+      std::chrono::duration_cast<std::chrono::duration<double>>(now - start);
+
+  std::cout << "Dumped " << strings.slice().length() << " strings to "
+            << total << " bytes of JSON in " << totalTime.count()
+            << " s. This is " << total / totalTime.count() / (1024.0 * 1024.0)
+            << " MB/s." << std::endl;
+}
+
 static void runDefaultBench() {
   auto runComparison = [](std::string const& filename) {
     std::string data = std::move(readFile(filename));
@@ -180,17 +404,44 @@ static void runDefaultBench() {
     }
     std::cout << std::endl;
 
-    std::cout << "vpack:        ";
-    run(data, 10, 1, true, false);
+    std::cout << "vpack:         ";
+    run(data, 10, 1, true, false, false);
 
-    std::cout << "rapidjson:    ";
-    run(data, 10, 1, false, false);
+    std::cout << "vpack-indexed: ";
+    run(data, 10, 1, true, true, false);
+
+    std::cout << "rapidjson:     ";
+    run(data, 10, 1, false, false, false);
   };
 
   runComparison("small.json");
   runComparison("sample.json");
   runComparison("sampleNoWhite.json");
   runComparison("commits.json");
+
+  auto runDtoaComparison = [](std::string const& filename) {
+    std::vector<double> values = readDoubles(filename);
+
+    std::cout << std::endl;
+    std::cout << "# dtoa " << filename << " ";
+    for (size_t i = 0; i < 25 - filename.size(); ++i) {
+      std::cout << "#";
+    }
+    std::cout << std::endl;
+
+    std::cout << "fpconv:        ";
+    runDtoa(values, 5, true, 0);
+
+    std::cout << "dtoa:          ";
+    runDtoa(values, 5, false, 0);
+
+    std::cout << "dtoa 6 digits: ";
+    runDtoa(values, 5, false, 6);
+  };
+
+  runDtoaComparison("random");
+  runDtoaComparison("doubles.json");
+  runDtoaComparison("sample.json");
 }
 
 int main(int argc, char* argv[]) {
@@ -204,9 +455,37 @@ int main(int argc, char* argv[]) {
     return EXIT_FAILURE;
   }
 
+  if (::strcmp(argv[4], "fpconv") == 0 || ::strcmp(argv[4], "dtoa") == 0) {
+    int digits = std::stoi(argv[3]);
+    int runTime = std::stoi(argv[2]);
+    runDtoa(readDoubles(argv[1]), runTime, ::strcmp(argv[4], "fpconv") == 0,
+            digits);
+    return EXIT_SUCCESS;
+  }
+
+  if (::strcmp(argv[4], "validate") == 0 ||
+      ::strcmp(argv[4], "validate-many") == 0) {
+    std::size_t threads = std::stoul(argv[3]);
+    int runTime = std::stoi(argv[2]);
+    runValidate(readFile(argv[1]), runTime, threads,
+                ::strcmp(argv[4], "validate-many") == 0);
+    return EXIT_SUCCESS;
+  }
+
+  if (::strcmp(argv[4], "escape") == 0 ||
+      ::strcmp(argv[4], "escape-builtin") == 0) {
+    int runTime = std::stoi(argv[2]);
+    runEscape(readFile(argv[1]), runTime, ::strcmp(argv[4], "escape") == 0);
+    return EXIT_SUCCESS;
+  }
+
   bool useVPack;
+  bool useStructuralIndex = false;
   if (::strcmp(argv[4], "vpack") == 0) {
     useVPack = true;
+  } else if (::strcmp(argv[4], "vpack-indexed") == 0) {
+    useVPack = true;
+    useStructuralIndex = true;
   } else if (::strcmp(argv[4], "rapidjson") == 0) {
     useVPack = false;
   } else {
@@ -220,7 +499,7 @@ int main(int argc, char* argv[]) {
   // read input file
   std::string s = std::move(readFile(argv[1]));
 
-  run(s, runTime, copies, useVPack, true);
+  run(s, runTime, copies, useVPack, useStructuralIndex, true);
 
   return EXIT_SUCCESS;
 }
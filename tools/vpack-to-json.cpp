@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <fstream>
 
@@ -40,7 +41,7 @@ static void usage(char* argv[]) {
 #else
   std::cout << "Usage: " << argv[0] << " [OPTIONS] INFILE OUTFILE" << std::endl;
 #endif
-  std::cout << "This program reads the VPack INFILE into a string and saves its"
+  std::cout << "This program maps or reads the VPack INFILE and saves its"
             << std::endl;
   std::cout << "JSON representation in file OUTFILE. Will work only for input"
             << std::endl;
@@ -176,35 +177,36 @@ int main(int argc, char* argv[]) {
   }
 #endif
 
-  std::string s;
-  std::ifstream ifs(infile, std::ifstream::in);
-
-  if (!ifs.is_open()) {
+  // regular files are mapped into memory, anything else is read
+  std::unique_ptr<MappedFile> file;
+  try {
+    file = std::make_unique<MappedFile>(infile);
+  } catch (Exception const&) {
     std::cerr << "Cannot read infile '" << infile << "'" << std::endl;
     return EXIT_FAILURE;
   }
 
-  {
-    char buffer[32768];
-    s.reserve(sizeof(buffer));
+  std::string s;
+  uint8_t const* data = file->data();
+  std::size_t size = file->size();
 
-    while (ifs.good()) {
-      ifs.read(&buffer[0], sizeof(buffer));
-      s.append(buffer, checkOverflow(ifs.gcount()));
-    }
+  if (hex) {
+    s = convertFromHex(std::string(reinterpret_cast<char const*>(data), size));
+    data = reinterpret_cast<uint8_t const*>(s.data());
+    size = s.size();
   }
-  ifs.close();
 
-  if (hex) {
-    s = convertFromHex(s);
+  if (size == 0) {
+    std::cerr << "Infile '" << infile << "' is empty" << std::endl;
+    return EXIT_FAILURE;
   }
   
   if (validate) {
     Validator validator;
-    validator.validate(reinterpret_cast<uint8_t const*>(s.data()), s.size(), false);
+    validator.validate(data, size, false);
   }
 
-  Slice const slice(reinterpret_cast<uint8_t const*>(s.data()));
+  Slice const slice(data);
 
   Options options;
   options.prettyPrint = pretty;
@@ -248,7 +250,7 @@ int main(int argc, char* argv[]) {
   if (!toStdOut) {
     std::cout << "Successfully converted JSON infile '" << infile << "'"
               << std::endl;
-    std::cout << "VPack Infile size: " << s.size() << std::endl;
+    std::cout << "VPack Infile size: " << size << std::endl;
     std::cout << "JSON Outfile size: " << buffer.size() << std::endl;
   }
   
@@ -25,8 +25,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <iostream>
+#include <memory>
 #include <string>
-#include <fstream>
 
 #include "velocypack/vpack.h"
 #include "velocypack/vpack.h"
@@ -36,7 +36,7 @@ using namespace arangodb::velocypack;
 
 static void usage(char* argv[]) {
   std::cout << "Usage: " << argv[0] << " [OPTIONS] INFILE" << std::endl;
-  std::cout << "This program reads the VPack INFILE into a string and "
+  std::cout << "This program maps or reads the VPack INFILE and "
             << std::endl;
   std::cout << "validates it. Will work only for input files up to 2 GB size." 
             << std::endl;
@@ -127,32 +127,31 @@ int main(int argc, char* argv[]) {
   }
 #endif
 
-  std::string s;
-  std::ifstream ifs(infile, std::ifstream::in);
-
-  if (!ifs.is_open()) {
+  // regular files are mapped into memory, anything else is read
+  std::unique_ptr<MappedFile> file;
+  try {
+    file = std::make_unique<MappedFile>(infile);
+  } catch (Exception const&) {
     std::cerr << "Cannot read infile '" << infile << "'" << std::endl;
     return EXIT_FAILURE;
   }
 
-  {
-    char buffer[32768];
-    s.reserve(sizeof(buffer));
-
-    while (ifs.good()) {
-      ifs.read(&buffer[0], sizeof(buffer));
-      s.append(buffer, checkOverflow(ifs.gcount()));
-    }
-  }
-  ifs.close();
+  std::string s;
+  uint8_t const* data = file->data();
+  std::size_t size = file->size();
 
   if (hex) {
-    s = convertFromHex(s);
+    s = convertFromHex(std::string(reinterpret_cast<char const*>(data), size));
+    data = reinterpret_cast<uint8_t const*>(s.data());
+    size = s.size();
   }
 
   try {
-    Validator validator;
-    validator.validate(reinterpret_cast<uint8_t const*>(s.data()), s.size(), false);
+    // values of any depth are valid VelocyPack
+    Options options;
+    options.maxValidationDepth = 0;
+    Validator validator(&options);
+    validator.validate(data, size, false);
     std::cout << "The velocypack in infile '" << infile << "' is valid" << std::endl;
   } catch (Exception const& ex) {
     std::cerr << "An exception occurred while processing infile '" << infile